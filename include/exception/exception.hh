@@ -304,6 +304,30 @@ public:
         return ::std::move(self.ok_);
     }
 
+    template<bool ndebug = false>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+    [[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+    [[msvc::forceinline]]
+#endif
+    [[nodiscard]]
+    constexpr auto&& value(this expected<Ok, Fail>& self) noexcept {
+        ::exception::assert_true<ndebug>(self.has_value());
+        return self.ok_;
+    }
+
+    template<bool ndebug = false>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+    [[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+    [[msvc::forceinline]]
+#endif
+    [[nodiscard]]
+    constexpr auto&& value(this expected<Ok, Fail>&& self) noexcept {
+        ::exception::assert_true<ndebug>(self.has_value());
+        return ::std::move(self.ok_);
+    }
+
     /**
      * @brief get the error value from an expected
      */
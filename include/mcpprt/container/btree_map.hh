@@ -0,0 +1,768 @@
+#pragma once
+
+/**
+ * @file btree_map.hh
+ * @brief ordered map as a B+-tree whose nodes span a few cache lines
+ * @details values live in the leaves only and the leaves are linked, so a range scan walks contiguous arrays
+ *          instead of chasing one pointer per element. Keys and values of a leaf are separate arrays, searching
+ *          a node touches its keys only.
+ */
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <exception/exception.hh>
+#include "../instrument/counters.hh"
+#include "../memory/pool.hh"
+#include "search.hh"
+#include "uninitialized.hh"
+
+namespace mcpprt::container {
+
+namespace details {
+
+/**
+ * @note nodes hold no parent pointer, the few nodes on the path to a leaf are remembered while descending
+ */
+template<typename Key, typename T, ::std::size_t Capacity>
+struct alignas(64) btree_leaf {
+    ::std::uint32_t size_{};
+    ::mcpprt::container::details::btree_leaf<Key, T, Capacity>* prev_{};
+    ::mcpprt::container::details::btree_leaf<Key, T, Capacity>* next_{};
+
+    union {
+        Key keys_[Capacity];
+    };
+
+    union {
+        T values_[Capacity];
+    };
+
+    btree_leaf() noexcept {
+    }
+
+    /**
+     * @note the elements are destroyed by the map
+     */
+    ~btree_leaf() noexcept {
+    }
+};
+
+template<typename Key, ::std::size_t Capacity>
+struct alignas(64) btree_internal {
+    ::std::uint32_t size_{};
+
+    union {
+        Key keys_[Capacity];
+    };
+
+    /**
+     * @brief `size_ + 1` children, leaves on the last internal level and internal nodes above
+     */
+    void* children_[Capacity + 1];
+
+    btree_internal() noexcept {
+    }
+
+    ~btree_internal() noexcept {
+    }
+};
+
+template<typename Key, typename T, ::std::size_t NodeBytes>
+struct btree_layout {
+    static constexpr ::std::size_t leaf_header = sizeof(::std::uint32_t) + 2 * sizeof(void*);
+    static constexpr ::std::size_t internal_header = sizeof(::std::uint32_t) + sizeof(void*);
+
+    static constexpr ::std::size_t leaf_capacity =
+        ::std::max<::std::size_t>(4, (NodeBytes - leaf_header) / (sizeof(Key) + sizeof(T)));
+    static constexpr ::std::size_t internal_capacity =
+        ::std::max<::std::size_t>(4, (NodeBytes - internal_header) / (sizeof(Key) + sizeof(void*)));
+};
+
+} // namespace details
+
+/**
+ * @brief ordered map with unique keys, https://en.wikipedia.org/wiki/B%2B_tree
+ * @tparam NodeBytes: size of a node, a multiple of the 64 byte cache line, 256 fits four lines
+ * @note keys are copied into the internal nodes as separators and must be copy constructible,
+ *       every operation that changes the tree invalidates all iterators
+ */
+template<typename Key, typename T, typename Compare = ::std::less<Key>,
+         typename Allocator = ::mcpprt::memory::pool_allocator<::std::pair<Key const, T>>,
+         ::std::size_t NodeBytes = 256>
+class btree_map {
+    static_assert(NodeBytes >= 64 && NodeBytes % 64 == 0, "NodeBytes must be a multiple of the cache line size");
+    static_assert(::std::is_copy_constructible_v<Key>, "separators are copies of keys");
+    static_assert(::std::is_nothrow_move_constructible_v<Key> && ::std::is_nothrow_move_constructible_v<T>,
+                  "elements are moved between nodes without a way to report failure");
+
+    using layout = ::mcpprt::container::details::btree_layout<Key, T, NodeBytes>;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = ::std::pair<Key, T>;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+    using key_compare = Compare;
+    using allocator_type = Allocator;
+
+    static constexpr size_type leaf_capacity = layout::leaf_capacity;
+    static constexpr size_type internal_capacity = layout::internal_capacity;
+
+private:
+    using leaf_type = ::mcpprt::container::details::btree_leaf<Key, T, leaf_capacity>;
+    using internal_type = ::mcpprt::container::details::btree_internal<Key, internal_capacity>;
+    using leaf_allocator = typename ::std::allocator_traits<Allocator>::template rebind_alloc<leaf_type>;
+    using internal_allocator = typename ::std::allocator_traits<Allocator>::template rebind_alloc<internal_type>;
+
+    static constexpr size_type min_leaf = leaf_capacity / 2;
+    static constexpr size_type min_internal = (internal_capacity - 1) / 2;
+    /**
+     * @brief every internal node but the root has at least two children
+     */
+    static constexpr size_type max_height = 64;
+
+    template<bool Const>
+    class basic_iterator {
+        friend class btree_map;
+        friend class basic_iterator<!Const>;
+
+        leaf_type* leaf_{};
+        size_type index_{};
+
+        constexpr basic_iterator(leaf_type* leaf, size_type index) noexcept
+            : leaf_{leaf}, index_{index} {
+        }
+
+    public:
+        using iterator_category = ::std::bidirectional_iterator_tag;
+        using value_type = ::std::pair<Key, T>;
+        using difference_type = ::std::ptrdiff_t;
+        using reference = ::std::pair<Key const&, ::std::conditional_t<Const, T const&, T&>>;
+
+        constexpr basic_iterator() noexcept = default;
+
+        template<bool OtherConst>
+            requires (Const && !OtherConst)
+        constexpr basic_iterator(basic_iterator<OtherConst> const& other) noexcept
+            : leaf_{other.leaf_}, index_{other.index_} {
+        }
+
+        [[nodiscard]]
+        constexpr auto operator*(this basic_iterator const& self) noexcept -> reference {
+            return reference{self.leaf_->keys_[self.index_], self.leaf_->values_[self.index_]};
+        }
+
+        [[nodiscard]]
+        constexpr auto key(this basic_iterator const& self) noexcept -> Key const& {
+            return self.leaf_->keys_[self.index_];
+        }
+
+        [[nodiscard]]
+        constexpr auto value(this basic_iterator const& self) noexcept -> ::std::conditional_t<Const, T const&, T&> {
+            return self.leaf_->values_[self.index_];
+        }
+
+        constexpr auto&& operator++(this basic_iterator& self) noexcept {
+            if (++self.index_ == self.leaf_->size_ && self.leaf_->next_ != nullptr) {
+                self.leaf_ = self.leaf_->next_;
+                self.index_ = 0;
+            }
+            return self;
+        }
+
+        constexpr auto operator++(this basic_iterator& self, int) noexcept -> basic_iterator {
+            auto result = self;
+            ++self;
+            return result;
+        }
+
+        constexpr auto&& operator--(this basic_iterator& self) noexcept {
+            if (self.index_ == 0) {
+                self.leaf_ = self.leaf_->prev_;
+                self.index_ = self.leaf_->size_;
+            }
+            --self.index_;
+            return self;
+        }
+
+        constexpr auto operator--(this basic_iterator& self, int) noexcept -> basic_iterator {
+            auto result = self;
+            --self;
+            return result;
+        }
+
+        [[nodiscard]]
+        constexpr bool operator==(this basic_iterator const& self, basic_iterator const& other) noexcept {
+            return self.leaf_ == other.leaf_ && self.index_ == other.index_;
+        }
+    };
+
+public:
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+private:
+    void* root_{};
+    leaf_type* head_{};
+    leaf_type* tail_{};
+    size_type size_{};
+    /**
+     * @brief number of internal levels, 0 when the root is a leaf
+     */
+    size_type height_{};
+    [[no_unique_address]] Compare comp_{};
+    [[no_unique_address]] Allocator alloc_{};
+    [[no_unique_address]] ::mcpprt::instrument::site site_{};
+
+public:
+    explicit btree_map(::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : site_{::mcpprt::instrument::make_site("btree_map", where)} {
+    }
+
+    explicit btree_map(Compare const& comp, Allocator const& alloc = Allocator{},
+                       ::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : comp_{comp}, alloc_{alloc}, site_{::mcpprt::instrument::make_site("btree_map", where)} {
+    }
+
+    btree_map(::mcpprt::container::btree_map<Key, T, Compare, Allocator, NodeBytes> const&) = delete;
+
+    btree_map(::mcpprt::container::btree_map<Key, T, Compare, Allocator, NodeBytes>&& other) noexcept
+        : root_{::std::exchange(other.root_, nullptr)}, head_{::std::exchange(other.head_, nullptr)},
+          tail_{::std::exchange(other.tail_, nullptr)}, size_{::std::exchange(other.size_, 0)},
+          height_{::std::exchange(other.height_, 0)}, comp_{other.comp_}, alloc_{other.alloc_},
+          site_{other.site_} {
+    }
+
+    btree_map& operator=(::mcpprt::container::btree_map<Key, T, Compare, Allocator, NodeBytes> const&) = delete;
+
+    auto&& operator=(this btree_map& self, btree_map&& other) noexcept {
+        if (&self != &other) {
+            self.clear();
+            self.root_ = ::std::exchange(other.root_, nullptr);
+            self.head_ = ::std::exchange(other.head_, nullptr);
+            self.tail_ = ::std::exchange(other.tail_, nullptr);
+            self.size_ = ::std::exchange(other.size_, 0);
+            self.height_ = ::std::exchange(other.height_, 0);
+            self.comp_ = other.comp_;
+            self.alloc_ = other.alloc_;
+        }
+        return self;
+    }
+
+    ~btree_map() noexcept {
+        this->clear();
+    }
+
+    [[nodiscard]]
+    constexpr auto size(this btree_map const& self) noexcept -> size_type {
+        return self.size_;
+    }
+
+    [[nodiscard]]
+    constexpr bool empty(this btree_map const& self) noexcept {
+        return self.size_ == 0;
+    }
+
+    [[nodiscard]]
+    constexpr auto begin(this btree_map& self) noexcept -> iterator {
+        return iterator{self.head_, 0};
+    }
+
+    [[nodiscard]]
+    constexpr auto begin(this btree_map const& self) noexcept -> const_iterator {
+        return const_iterator{self.head_, 0};
+    }
+
+    /**
+     * @note one past the last element of the last leaf, so that `--end()` works without a sentinel node
+     */
+    [[nodiscard]]
+    constexpr auto end(this btree_map& self) noexcept -> iterator {
+        return iterator{self.tail_, self.tail_ == nullptr ? 0 : self.tail_->size_};
+    }
+
+    [[nodiscard]]
+    constexpr auto end(this btree_map const& self) noexcept -> const_iterator {
+        return const_iterator{self.tail_, self.tail_ == nullptr ? 0 : self.tail_->size_};
+    }
+
+    [[nodiscard]]
+    auto find(this btree_map& self, Key const& key) noexcept -> iterator {
+        auto [leaf, pos] = self.template find_leaf<false>(key);
+        if (leaf == nullptr || pos == leaf->size_ || self.comp_(key, leaf->keys_[pos])) {
+            return self.end();
+        }
+        return iterator{leaf, pos};
+    }
+
+    [[nodiscard]]
+    auto find(this btree_map const& self, Key const& key) noexcept -> const_iterator {
+        return const_cast<btree_map&>(self).find(key);
+    }
+
+    [[nodiscard]]
+    bool contains(this btree_map const& self, Key const& key) noexcept {
+        return self.find(key) != self.end();
+    }
+
+    /**
+     * @brief the value mapped to `key`, if any
+     */
+    [[nodiscard]]
+    auto get(this btree_map& self, Key const& key) noexcept -> ::exception::optional<T*> {
+        auto it = self.find(key);
+        if (it == self.end()) {
+            return ::exception::nullopt_t{};
+        }
+        return &it.value();
+    }
+
+    [[nodiscard]]
+    auto get(this btree_map const& self, Key const& key) noexcept -> ::exception::optional<T const*> {
+        auto it = self.find(key);
+        if (it == self.end()) {
+            return ::exception::nullopt_t{};
+        }
+        return &it.value();
+    }
+
+    /**
+     * @brief the value mapped to `key`, which must be present
+     */
+    template<bool ndebug = false>
+    [[nodiscard]]
+    auto&& at(this auto&& self, Key const& key) noexcept {
+        auto it = self.find(key);
+        ::exception::assert_true<ndebug>(it != self.end());
+        return ::std::forward_like<decltype(self)>(it.value());
+    }
+
+    /**
+     * @brief the first element whose key is not less than `key`
+     */
+    [[nodiscard]]
+    auto lower_bound(this btree_map& self, Key const& key) noexcept -> iterator {
+        auto [leaf, pos] = self.template find_leaf<false>(key);
+        return self.normalize(leaf, pos);
+    }
+
+    [[nodiscard]]
+    auto lower_bound(this btree_map const& self, Key const& key) noexcept -> const_iterator {
+        return const_cast<btree_map&>(self).lower_bound(key);
+    }
+
+    /**
+     * @brief the first element whose key is greater than `key`
+     */
+    [[nodiscard]]
+    auto upper_bound(this btree_map& self, Key const& key) noexcept -> iterator {
+        auto [leaf, pos] = self.template find_leaf<true>(key);
+        return self.normalize(leaf, pos);
+    }
+
+    [[nodiscard]]
+    auto upper_bound(this btree_map const& self, Key const& key) noexcept -> const_iterator {
+        return const_cast<btree_map&>(self).upper_bound(key);
+    }
+
+    /**
+     * @brief construct the value from `args` unless `key` is already present
+     * @return the element with `key` and whether it was inserted
+     * @note `key` and `args` must not refer to elements of the map, splitting a node moves them
+     */
+    template<typename K, typename... Args>
+        requires (::std::same_as<::std::remove_cvref_t<K>, Key> && ::std::constructible_from<T, Args && ...>)
+    auto try_emplace(this btree_map& self, K&& key, Args&&... args) noexcept -> ::std::pair<iterator, bool> {
+        if (self.root_ == nullptr) {
+            auto* leaf = self.make_leaf();
+            self.root_ = leaf;
+            self.head_ = leaf;
+            self.tail_ = leaf;
+        }
+        if (self.is_full(self.root_, self.height_ == 0)) {
+            auto* root = self.make_internal();
+            root->children_[0] = self.root_;
+            self.root_ = root;
+            ++self.height_;
+            self.split_child(root, 0, self.height_ == 1);
+        }
+
+        // split full nodes on the way down, so that a split never has to walk back up
+        void* node = self.root_;
+        for (auto level = self.height_; level > 0; --level) {
+            auto* inner = static_cast<internal_type*>(node);
+            auto index = ::mcpprt::container::details::node_upper_rank(inner->keys_, inner->size_, key, self.comp_);
+            bool const child_is_leaf = level == 1;
+            if (self.is_full(inner->children_[index], child_is_leaf)) {
+                self.split_child(inner, index, child_is_leaf);
+                index += !self.comp_(key, inner->keys_[index]);
+            }
+            node = inner->children_[index];
+        }
+
+        auto* leaf = static_cast<leaf_type*>(node);
+        auto pos = ::mcpprt::container::details::node_lower_rank(leaf->keys_, leaf->size_, key, self.comp_);
+        if (pos < leaf->size_ && !self.comp_(key, leaf->keys_[pos])) {
+            return {iterator{leaf, pos}, false};
+        }
+        ::mcpprt::container::details::shift_open(leaf->keys_, leaf->size_, pos);
+        ::std::construct_at(leaf->keys_ + pos, ::std::forward<K>(key));
+        ::mcpprt::container::details::shift_open(leaf->values_, leaf->size_, pos);
+        ::std::construct_at(leaf->values_ + pos, ::std::forward<Args>(args)...);
+        ++leaf->size_;
+        ++self.size_;
+        return {iterator{leaf, pos}, true};
+    }
+
+    auto insert(this btree_map& self, Key const& key, T const& value) noexcept -> ::std::pair<iterator, bool> {
+        return self.try_emplace(key, value);
+    }
+
+    auto insert(this btree_map& self, Key&& key, T&& value) noexcept -> ::std::pair<iterator, bool> {
+        return self.try_emplace(::std::move(key), ::std::move(value));
+    }
+
+    template<typename K, typename V>
+        requires (::std::same_as<::std::remove_cvref_t<K>, Key> && ::std::assignable_from<T&, V &&> &&
+                  ::std::constructible_from<T, V &&>)
+    auto insert_or_assign(this btree_map& self, K&& key, V&& value) noexcept -> ::std::pair<iterator, bool> {
+        auto result = self.try_emplace(::std::forward<K>(key), ::std::forward<V>(value));
+        if (!result.second) {
+            result.first.value() = ::std::forward<V>(value);
+        }
+        return result;
+    }
+
+    /**
+     * @return the number of elements removed, 0 or 1
+     */
+    auto erase(this btree_map& self, Key const& key) noexcept -> size_type {
+        if (self.root_ == nullptr) {
+            return 0;
+        }
+
+        step path[max_height];
+        void* node = self.root_;
+        for (size_type level{}; level < self.height_; ++level) {
+            auto* inner = static_cast<internal_type*>(node);
+            auto index = ::mcpprt::container::details::node_upper_rank(inner->keys_, inner->size_, key, self.comp_);
+            path[level] = {inner, index};
+            node = inner->children_[index];
+        }
+
+        auto* leaf = static_cast<leaf_type*>(node);
+        auto pos = ::mcpprt::container::details::node_lower_rank(leaf->keys_, leaf->size_, key, self.comp_);
+        if (pos == leaf->size_ || self.comp_(key, leaf->keys_[pos])) {
+            return 0;
+        }
+        // `key` may refer to the element being removed, it is not used past this point
+        ::mcpprt::container::details::shift_close(leaf->keys_, leaf->size_, pos);
+        ::mcpprt::container::details::shift_close(leaf->values_, leaf->size_, pos);
+        --leaf->size_;
+        --self.size_;
+        self.rebalance_leaf(leaf, path);
+        return 1;
+    }
+
+    void clear(this btree_map& self) noexcept {
+        if (self.root_ != nullptr) {
+            self.destroy(self.root_, self.height_);
+        }
+        self.root_ = nullptr;
+        self.head_ = nullptr;
+        self.tail_ = nullptr;
+        self.size_ = 0;
+        self.height_ = 0;
+    }
+
+private:
+    struct step {
+        internal_type* node_;
+        size_type index_;
+    };
+
+    [[nodiscard]]
+    constexpr auto normalize(this btree_map& self, leaf_type* leaf, size_type pos) noexcept -> iterator {
+        if (leaf != nullptr && pos == leaf->size_ && leaf->next_ != nullptr) {
+            return iterator{leaf->next_, 0};
+        }
+        if (leaf == nullptr) {
+            return self.end();
+        }
+        return iterator{leaf, pos};
+    }
+
+    /**
+     * @brief the leaf that holds `key` and the rank of `key` in it
+     * @tparam Upper: rank of the first greater key instead of the first key not less
+     */
+    template<bool Upper>
+    [[nodiscard]]
+    auto find_leaf(this btree_map const& self, Key const& key) noexcept -> ::std::pair<leaf_type*, size_type> {
+        if (self.root_ == nullptr) {
+            return {nullptr, 0};
+        }
+        void* node = self.root_;
+        for (auto level = self.height_; level > 0; --level) {
+            auto* inner = static_cast<internal_type*>(node);
+            node = inner->children_[::mcpprt::container::details::node_upper_rank(inner->keys_, inner->size_, key,
+                                                                                  self.comp_)];
+        }
+        auto* leaf = static_cast<leaf_type*>(node);
+        if constexpr (Upper) {
+            return {leaf, ::mcpprt::container::details::node_upper_rank(leaf->keys_, leaf->size_, key, self.comp_)};
+        } else {
+            return {leaf, ::mcpprt::container::details::node_lower_rank(leaf->keys_, leaf->size_, key, self.comp_)};
+        }
+    }
+
+    [[nodiscard]]
+    static constexpr bool is_full(void* node, bool leaf) noexcept {
+        if (leaf) {
+            return static_cast<leaf_type*>(node)->size_ == leaf_capacity;
+        }
+        return static_cast<internal_type*>(node)->size_ == internal_capacity;
+    }
+
+    [[nodiscard]]
+    auto make_leaf(this btree_map& self) noexcept -> leaf_type* {
+        leaf_allocator alloc{self.alloc_};
+        auto* leaf = ::std::allocator_traits<leaf_allocator>::allocate(alloc, 1);
+        ::mcpprt::instrument::on_allocate(self.site_, sizeof(leaf_type));
+        return ::std::construct_at(leaf);
+    }
+
+    [[nodiscard]]
+    auto make_internal(this btree_map& self) noexcept -> internal_type* {
+        internal_allocator alloc{self.alloc_};
+        auto* inner = ::std::allocator_traits<internal_allocator>::allocate(alloc, 1);
+        ::mcpprt::instrument::on_allocate(self.site_, sizeof(internal_type));
+        return ::std::construct_at(inner);
+    }
+
+    void free_leaf(this btree_map& self, leaf_type* leaf) noexcept {
+        ::std::destroy_at(leaf);
+        leaf_allocator alloc{self.alloc_};
+        ::std::allocator_traits<leaf_allocator>::deallocate(alloc, leaf, 1);
+        ::mcpprt::instrument::on_deallocate(self.site_, sizeof(leaf_type));
+    }
+
+    void free_internal(this btree_map& self, internal_type* inner) noexcept {
+        ::std::destroy_at(inner);
+        internal_allocator alloc{self.alloc_};
+        ::std::allocator_traits<internal_allocator>::deallocate(alloc, inner, 1);
+        ::mcpprt::instrument::on_deallocate(self.site_, sizeof(internal_type));
+    }
+
+    void destroy(this btree_map& self, void* node, size_type level) noexcept {
+        if (level == 0) {
+            auto* leaf = static_cast<leaf_type*>(node);
+            ::std::destroy(leaf->keys_, leaf->keys_ + leaf->size_);
+            ::std::destroy(leaf->values_, leaf->values_ + leaf->size_);
+            self.free_leaf(leaf);
+            return;
+        }
+        auto* inner = static_cast<internal_type*>(node);
+        for (size_type i{}; i <= inner->size_; ++i) {
+            self.destroy(inner->children_[i], level - 1);
+        }
+        ::std::destroy(inner->keys_, inner->keys_ + inner->size_);
+        self.free_internal(inner);
+    }
+
+    /**
+     * @brief split the full child `index` of `parent`, which is not full, into two halves
+     */
+    void split_child(this btree_map& self, internal_type* parent, size_type index, bool child_is_leaf) noexcept {
+        using ::mcpprt::container::details::move_out;
+        using ::mcpprt::container::details::shift_open;
+
+        if (child_is_leaf) {
+            auto* left = static_cast<leaf_type*>(parent->children_[index]);
+            auto* right = self.make_leaf();
+            constexpr auto moved = leaf_capacity - min_leaf;
+            move_out(left->keys_ + min_leaf, moved, right->keys_);
+            move_out(left->values_ + min_leaf, moved, right->values_);
+            left->size_ = min_leaf;
+            right->size_ = moved;
+            ::mcpprt::instrument::on_relocate(self.site_, moved * (sizeof(Key) + sizeof(T)));
+
+            right->prev_ = left;
+            right->next_ = left->next_;
+            if (left->next_ != nullptr) {
+                left->next_->prev_ = right;
+            } else {
+                self.tail_ = right;
+            }
+            left->next_ = right;
+
+            shift_open(parent->keys_, parent->size_, index);
+            ::std::construct_at(parent->keys_ + index, right->keys_[0]);
+            shift_open(parent->children_, parent->size_ + 1, index + 1);
+            parent->children_[index + 1] = right;
+            ++parent->size_;
+            return;
+        }
+
+        auto* left = static_cast<internal_type*>(parent->children_[index]);
+        auto* right = self.make_internal();
+        constexpr auto mid = internal_capacity / 2;
+        constexpr auto moved = internal_capacity - mid - 1;
+        move_out(left->keys_ + mid + 1, moved, right->keys_);
+        ::std::copy(left->children_ + mid + 1, left->children_ + internal_capacity + 1, right->children_);
+        right->size_ = moved;
+        ::mcpprt::instrument::on_relocate(self.site_, moved * (sizeof(Key) + sizeof(void*)));
+
+        // the middle key moves up instead of being copied, internal separators are not elements
+        shift_open(parent->keys_, parent->size_, index);
+        ::std::construct_at(parent->keys_ + index, ::std::move(left->keys_[mid]));
+        ::std::destroy_at(left->keys_ + mid);
+        left->size_ = mid;
+        shift_open(parent->children_, parent->size_ + 1, index + 1);
+        parent->children_[index + 1] = right;
+        ++parent->size_;
+    }
+
+    /**
+     * @brief remove the separator `index` of `parent` and the child to its right
+     */
+    static void remove_separator(internal_type* parent, size_type index) noexcept {
+        ::mcpprt::container::details::shift_close(parent->keys_, parent->size_, index);
+        ::mcpprt::container::details::shift_close(parent->children_, parent->size_ + 1, index + 1);
+        --parent->size_;
+    }
+
+    void rebalance_leaf(this btree_map& self, leaf_type* leaf, step const* path) noexcept {
+        using ::mcpprt::container::details::move_out;
+        using ::mcpprt::container::details::shift_close;
+        using ::mcpprt::container::details::shift_open;
+
+        if (self.height_ == 0) {
+            if (leaf->size_ == 0) {
+                self.free_leaf(leaf);
+                self.root_ = nullptr;
+                self.head_ = nullptr;
+                self.tail_ = nullptr;
+            }
+            return;
+        }
+        if (leaf->size_ >= min_leaf) {
+            return;
+        }
+
+        auto [parent, index] = path[self.height_ - 1];
+        auto* left = index > 0 ? static_cast<leaf_type*>(parent->children_[index - 1]) : nullptr;
+        auto* right = index < parent->size_ ? static_cast<leaf_type*>(parent->children_[index + 1]) : nullptr;
+
+        if (left != nullptr && left->size_ > min_leaf) {
+            auto last = left->size_ - 1;
+            shift_open(leaf->keys_, leaf->size_, 0);
+            ::std::construct_at(leaf->keys_, ::std::move(left->keys_[last]));
+            shift_open(leaf->values_, leaf->size_, 0);
+            ::std::construct_at(leaf->values_, ::std::move(left->values_[last]));
+            ::std::destroy_at(left->keys_ + last);
+            ::std::destroy_at(left->values_ + last);
+            --left->size_;
+            ++leaf->size_;
+            parent->keys_[index - 1] = leaf->keys_[0];
+            return;
+        }
+        if (right != nullptr && right->size_ > min_leaf) {
+            ::std::construct_at(leaf->keys_ + leaf->size_, ::std::move(right->keys_[0]));
+            ::std::construct_at(leaf->values_ + leaf->size_, ::std::move(right->values_[0]));
+            shift_close(right->keys_, right->size_, 0);
+            shift_close(right->values_, right->size_, 0);
+            --right->size_;
+            ++leaf->size_;
+            parent->keys_[index] = right->keys_[0];
+            return;
+        }
+
+        // neither sibling can spare an element, merge with one of them
+        auto merge_index = left != nullptr ? index - 1 : index;
+        auto* into = left != nullptr ? left : leaf;
+        auto* from = left != nullptr ? leaf : right;
+        move_out(from->keys_, from->size_, into->keys_ + into->size_);
+        move_out(from->values_, from->size_, into->values_ + into->size_);
+        ::mcpprt::instrument::on_relocate(self.site_, from->size_ * (sizeof(Key) + sizeof(T)));
+        into->size_ += from->size_;
+        into->next_ = from->next_;
+        if (from->next_ != nullptr) {
+            from->next_->prev_ = into;
+        } else {
+            self.tail_ = into;
+        }
+        self.free_leaf(from);
+        remove_separator(parent, merge_index);
+        self.rebalance_internal(path, self.height_ - 1);
+    }
+
+    void rebalance_internal(this btree_map& self, step const* path, size_type level) noexcept {
+        using ::mcpprt::container::details::move_out;
+        using ::mcpprt::container::details::shift_close;
+        using ::mcpprt::container::details::shift_open;
+
+        for (;; --level) {
+            auto* node = path[level].node_;
+            if (level == 0) {
+                if (node->size_ == 0) {
+                    self.root_ = node->children_[0];
+                    self.free_internal(node);
+                    --self.height_;
+                }
+                return;
+            }
+            if (node->size_ >= min_internal) {
+                return;
+            }
+
+            auto [parent, index] = path[level - 1];
+            auto* left = index > 0 ? static_cast<internal_type*>(parent->children_[index - 1]) : nullptr;
+            auto* right = index < parent->size_ ? static_cast<internal_type*>(parent->children_[index + 1]) : nullptr;
+
+            if (left != nullptr && left->size_ > min_internal) {
+                // rotate through the parent separator
+                shift_open(node->keys_, node->size_, 0);
+                ::std::construct_at(node->keys_, ::std::move(parent->keys_[index - 1]));
+                shift_open(node->children_, node->size_ + 1, 0);
+                node->children_[0] = left->children_[left->size_];
+                parent->keys_[index - 1] = ::std::move(left->keys_[left->size_ - 1]);
+                ::std::destroy_at(left->keys_ + left->size_ - 1);
+                --left->size_;
+                ++node->size_;
+                return;
+            }
+            if (right != nullptr && right->size_ > min_internal) {
+                ::std::construct_at(node->keys_ + node->size_, ::std::move(parent->keys_[index]));
+                node->children_[node->size_ + 1] = right->children_[0];
+                parent->keys_[index] = ::std::move(right->keys_[0]);
+                shift_close(right->keys_, right->size_, 0);
+                shift_close(right->children_, right->size_ + 1, 0);
+                --right->size_;
+                ++node->size_;
+                return;
+            }
+
+            auto merge_index = left != nullptr ? index - 1 : index;
+            auto* into = left != nullptr ? left : node;
+            auto* from = left != nullptr ? node : right;
+            ::std::construct_at(into->keys_ + into->size_, ::std::move(parent->keys_[merge_index]));
+            move_out(from->keys_, from->size_, into->keys_ + into->size_ + 1);
+            ::std::copy(from->children_, from->children_ + from->size_ + 1, into->children_ + into->size_ + 1);
+            ::mcpprt::instrument::on_relocate(self.site_, from->size_ * (sizeof(Key) + sizeof(void*)));
+            into->size_ += from->size_ + 1;
+            self.free_internal(from);
+            remove_separator(parent, merge_index);
+        }
+    }
+};
+
+} // namespace mcpprt::container
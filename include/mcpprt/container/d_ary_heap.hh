@@ -0,0 +1,795 @@
+#pragma once
+
+/**
+ * @file d_ary_heap.hh
+ * @brief priority queues over heaps whose nodes have `Arity` children
+ * @details the children of a node are adjacent, with the default arity they fill one cache line, so sifting down
+ *          touches one line per level of a tree log_Arity(n) deep instead of log_2(n). As with
+ *          `std::priority_queue`, the top is the greatest element for `Compare`, `std::greater` puts the least on top.
+ */
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <exception/exception.hh>
+#include "../instrument/counters.hh"
+#include "array.hh"
+#include "uninitialized.hh"
+
+namespace mcpprt::container {
+
+namespace details {
+
+inline constexpr ::std::size_t heap_cache_line = 64;
+
+/**
+ * @brief element of an indexed heap, the key travels with its priority so comparisons stay in the heap array
+ */
+template<typename T>
+struct heap_entry {
+    ::std::size_t key_;
+    T priority_;
+};
+
+struct heap_unobserved {
+    template<typename U>
+    constexpr void operator()(U const&, ::std::size_t) const noexcept {
+    }
+};
+
+/**
+ * @brief move `data[pos]` towards the root past every parent it should be above
+ * @param moved: called with every element that lands at a new position and that position
+ */
+template<::std::size_t Arity, typename T, typename Compare, typename Moved>
+constexpr void heap_sift_up(T* data, ::std::size_t pos, Compare& comp, Moved& moved) noexcept {
+    T value = ::std::move(data[pos]);
+    while (pos != 0) {
+        auto parent = (pos - 1) / Arity;
+        if (!comp(data[parent], value)) {
+            break;
+        }
+        data[pos] = ::std::move(data[parent]);
+        moved(data[pos], pos);
+        pos = parent;
+    }
+    data[pos] = ::std::move(value);
+    moved(data[pos], pos);
+}
+
+/**
+ * @brief move `data[pos]` towards the leaves past every child it should be below
+ */
+template<::std::size_t Arity, typename T, typename Compare, typename Moved>
+constexpr void heap_sift_down(T* data, ::std::size_t size, ::std::size_t pos, Compare& comp, Moved& moved) noexcept {
+    T value = ::std::move(data[pos]);
+    while (true) {
+        auto first = pos * Arity + 1;
+        if (first >= size) {
+            break;
+        }
+        auto best = first;
+        if (size - first >= Arity) {
+            // all the children are there, a constant trip count the compiler unrolls
+            for (auto child = first + 1; child != first + Arity; ++child) {
+                if (comp(data[best], data[child])) {
+                    best = child;
+                }
+            }
+        } else {
+            for (auto child = first + 1; child != size; ++child) {
+                if (comp(data[best], data[child])) {
+                    best = child;
+                }
+            }
+        }
+        if (!comp(value, data[best])) {
+            break;
+        }
+        data[pos] = ::std::move(data[best]);
+        moved(data[pos], pos);
+        pos = best;
+    }
+    data[pos] = ::std::move(value);
+    moved(data[pos], pos);
+}
+
+/**
+ * @brief Floyd's bottom-up construction, O(n)
+ */
+template<::std::size_t Arity, typename T, typename Compare, typename Moved>
+constexpr void heap_make(T* data, ::std::size_t size, Compare& comp, Moved& moved) noexcept {
+    for (::std::size_t i{}; i < size; ++i) {
+        moved(data[i], i);
+    }
+    if (size < 2) {
+        return;
+    }
+    for (auto pos = (size - 2) / Arity + 1; pos-- != 0;) {
+        ::mcpprt::container::details::heap_sift_down<Arity>(data, size, pos, comp, moved);
+    }
+}
+
+/**
+ * @brief restore the heap after `data[pos]` was replaced by a value that may belong above or below
+ */
+template<::std::size_t Arity, typename T, typename Compare, typename Moved>
+constexpr void heap_fix(T* data, ::std::size_t size, ::std::size_t pos, Compare& comp, Moved& moved) noexcept {
+    if (pos != 0 && comp(data[(pos - 1) / Arity], data[pos])) {
+        ::mcpprt::container::details::heap_sift_up<Arity>(data, pos, comp, moved);
+    } else {
+        ::mcpprt::container::details::heap_sift_down<Arity>(data, size, pos, comp, moved);
+    }
+}
+
+} // namespace details
+
+/**
+ * @brief as many children as fit in a cache line, at least 2
+ */
+template<typename T>
+inline constexpr ::std::size_t default_arity =
+    ::std::max(::std::size_t{2}, ::mcpprt::container::details::heap_cache_line / sizeof(T));
+
+/**
+ * @brief priority queue over an allocated array, `std::priority_queue` with a shallower tree
+ * @note iterating visits the elements in heap order, not sorted
+ */
+template<typename T, ::std::size_t Arity = ::mcpprt::container::default_arity<T>, typename Compare = ::std::less<T>,
+         typename Allocator = ::std::allocator<T>>
+class d_ary_heap {
+    static_assert(Arity >= 2, "Arity must be at least 2");
+
+public:
+    using value_type = T;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+    using value_compare = Compare;
+    using allocator_type = Allocator;
+    using const_iterator = T const*;
+
+    static constexpr size_type arity = Arity;
+
+private:
+    T* data_{};
+    size_type size_{};
+    size_type capacity_{};
+    [[no_unique_address]] Compare comp_{};
+    [[no_unique_address]] Allocator alloc_{};
+    [[no_unique_address]] ::mcpprt::instrument::site site_{};
+
+public:
+    constexpr explicit d_ary_heap(
+        ::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : site_{::mcpprt::instrument::make_site("d_ary_heap", where)} {
+    }
+
+    constexpr explicit d_ary_heap(
+        Compare const& comp, Allocator const& alloc = Allocator{},
+        ::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : comp_{comp}, alloc_{alloc}, site_{::mcpprt::instrument::make_site("d_ary_heap", where)} {
+    }
+
+    constexpr d_ary_heap(::std::initializer_list<T> init,
+                         ::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : site_{::mcpprt::instrument::make_site("d_ary_heap", where)} {
+        this->assign(init.begin(), init.end());
+    }
+
+    template<::std::input_iterator It, ::std::sentinel_for<It> S>
+    constexpr d_ary_heap(It first, S last,
+                         ::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : site_{::mcpprt::instrument::make_site("d_ary_heap", where)} {
+        this->assign(::std::move(first), last);
+    }
+
+    constexpr d_ary_heap(::mcpprt::container::d_ary_heap<T, Arity, Compare, Allocator> const& other) noexcept
+        : comp_{other.comp_}, alloc_{other.alloc_}, site_{other.site_} {
+        this->reserve(other.size_);
+        ::mcpprt::container::details::copy_out(other.data_, other.size_, this->data_);
+        this->size_ = other.size_;
+    }
+
+    constexpr d_ary_heap(::mcpprt::container::d_ary_heap<T, Arity, Compare, Allocator>&& other) noexcept
+        : data_{::std::exchange(other.data_, nullptr)}, size_{::std::exchange(other.size_, 0)},
+          capacity_{::std::exchange(other.capacity_, 0)}, comp_{other.comp_}, alloc_{other.alloc_},
+          site_{other.site_} {
+    }
+
+    constexpr auto&& operator=(this d_ary_heap& self, d_ary_heap const& other) noexcept {
+        if (&self != &other) {
+            self.clear();
+            self.reserve(other.size_);
+            ::mcpprt::container::details::copy_out(other.data_, other.size_, self.data_);
+            self.size_ = other.size_;
+            self.comp_ = other.comp_;
+        }
+        return self;
+    }
+
+    constexpr auto&& operator=(this d_ary_heap& self, d_ary_heap&& other) noexcept {
+        if (&self != &other) {
+            self.release();
+            self.data_ = ::std::exchange(other.data_, nullptr);
+            self.size_ = ::std::exchange(other.size_, 0);
+            self.capacity_ = ::std::exchange(other.capacity_, 0);
+            self.comp_ = other.comp_;
+            self.alloc_ = other.alloc_;
+        }
+        return self;
+    }
+
+    constexpr ~d_ary_heap() noexcept {
+        this->release();
+    }
+
+    [[nodiscard]]
+    constexpr auto size(this d_ary_heap const& self) noexcept -> size_type {
+        return self.size_;
+    }
+
+    [[nodiscard]]
+    constexpr bool empty(this d_ary_heap const& self) noexcept {
+        return self.size_ == 0;
+    }
+
+    [[nodiscard]]
+    constexpr auto capacity(this d_ary_heap const& self) noexcept -> size_type {
+        return self.capacity_;
+    }
+
+    [[nodiscard]]
+    constexpr auto begin(this d_ary_heap const& self) noexcept -> const_iterator {
+        return self.data_;
+    }
+
+    [[nodiscard]]
+    constexpr auto end(this d_ary_heap const& self) noexcept -> const_iterator {
+        return self.data_ + self.size_;
+    }
+
+    template<bool ndebug = false>
+    [[nodiscard]]
+    constexpr auto top(this d_ary_heap const& self) noexcept -> T const& {
+        ::exception::assert_true<ndebug>(self.size_ != 0);
+        return self.data_[0];
+    }
+
+    constexpr void reserve(this d_ary_heap& self, size_type capacity) noexcept {
+        if (capacity > self.capacity_) {
+            self.reallocate(capacity);
+        }
+    }
+
+    template<typename... Args>
+        requires (::std::constructible_from<T, Args && ...>)
+    constexpr void emplace(this d_ary_heap& self, Args&&... args) noexcept {
+        if (self.size_ == self.capacity_) {
+            self.reallocate(self.capacity_ == 0 ? 8 : self.capacity_ * 2);
+        }
+        ::std::construct_at(self.data_ + self.size_, ::std::forward<Args>(args)...);
+        ::mcpprt::container::details::heap_unobserved moved{};
+        ::mcpprt::container::details::heap_sift_up<Arity>(self.data_, self.size_++, self.comp_, moved);
+    }
+
+    constexpr void push(this d_ary_heap& self, T const& value) noexcept {
+        self.emplace(value);
+    }
+
+    constexpr void push(this d_ary_heap& self, T&& value) noexcept {
+        self.emplace(::std::move(value));
+    }
+
+    template<bool ndebug = false>
+    constexpr void pop(this d_ary_heap& self) noexcept {
+        ::exception::assert_true<ndebug>(self.size_ != 0);
+        auto last = --self.size_;
+        if (last != 0) {
+            self.data_[0] = ::std::move(self.data_[last]);
+        }
+        ::std::destroy_at(self.data_ + last);
+        if (last > 1) {
+            ::mcpprt::container::details::heap_unobserved moved{};
+            ::mcpprt::container::details::heap_sift_down<Arity>(self.data_, last, 0, self.comp_, moved);
+        }
+    }
+
+    /**
+     * @brief pop and push in one sift, for keeping the best k of a stream
+     */
+    template<bool ndebug = false, typename U>
+        requires (::std::assignable_from<T&, U &&>)
+    constexpr void replace_top(this d_ary_heap& self, U&& value) noexcept {
+        ::exception::assert_true<ndebug>(self.size_ != 0);
+        self.data_[0] = ::std::forward<U>(value);
+        ::mcpprt::container::details::heap_unobserved moved{};
+        ::mcpprt::container::details::heap_sift_down<Arity>(self.data_, self.size_, 0, self.comp_, moved);
+    }
+
+    /**
+     * @brief replace the elements by those of a range and build the heap in O(n)
+     */
+    template<::std::input_iterator It, ::std::sentinel_for<It> S>
+    constexpr void assign(this d_ary_heap& self, It first, S last) noexcept {
+        self.clear();
+        if constexpr (::std::sized_sentinel_for<S, It>) {
+            self.reserve(static_cast<size_type>(last - first));
+        }
+        for (; first != last; ++first) {
+            if (self.size_ == self.capacity_) {
+                self.reallocate(self.capacity_ == 0 ? 8 : self.capacity_ * 2);
+            }
+            ::std::construct_at(self.data_ + self.size_++, *first);
+        }
+        ::mcpprt::container::details::heap_unobserved moved{};
+        ::mcpprt::container::details::heap_make<Arity>(self.data_, self.size_, self.comp_, moved);
+    }
+
+    /**
+     * @note keeps the capacity
+     */
+    constexpr void clear(this d_ary_heap& self) noexcept {
+        ::std::destroy(self.data_, self.data_ + self.size_);
+        self.size_ = 0;
+    }
+
+private:
+    constexpr void reallocate(this d_ary_heap& self, size_type capacity) noexcept {
+        auto* data = ::std::allocator_traits<Allocator>::allocate(self.alloc_, capacity);
+        ::mcpprt::instrument::on_allocate(self.site_, capacity * sizeof(T));
+        ::mcpprt::container::details::move_out(self.data_, self.size_, data);
+        ::mcpprt::instrument::on_relocate(self.site_, self.size_ * sizeof(T));
+
+        auto size = self.size_;
+        self.size_ = 0;
+        self.release();
+        ::mcpprt::instrument::on_reallocate(self.site_);
+        ::mcpprt::instrument::on_grow(self.site_, capacity);
+        self.data_ = data;
+        self.size_ = size;
+        self.capacity_ = capacity;
+    }
+
+    /**
+     * @brief destroy the elements and free the storage
+     */
+    constexpr void release(this d_ary_heap& self) noexcept {
+        self.clear();
+        if (self.data_ != nullptr) {
+            ::std::allocator_traits<Allocator>::deallocate(self.alloc_, self.data_, self.capacity_);
+            ::mcpprt::instrument::on_deallocate(self.site_, self.capacity_ * sizeof(T));
+        }
+        self.data_ = nullptr;
+        self.capacity_ = 0;
+    }
+};
+
+/**
+ * @brief priority queue of the keys 0 to `key_count` - 1, each with a priority that can change in O(log n)
+ * @details a position table maps every key to where its entry is in the heap. With `std::greater`, `push_or_raise`
+ *          is the decrease-key of Dijkstra's and Prim's algorithms.
+ * @note both arrays are allocated once, at construction
+ */
+template<typename T,
+         ::std::size_t Arity = ::mcpprt::container::default_arity<::mcpprt::container::details::heap_entry<T>>,
+         typename Compare = ::std::less<T>, typename Allocator = ::std::allocator<T>>
+class indexed_d_ary_heap {
+    static_assert(Arity >= 2, "Arity must be at least 2");
+
+    using entry = ::mcpprt::container::details::heap_entry<T>;
+    using entry_allocator = typename ::std::allocator_traits<Allocator>::template rebind_alloc<entry>;
+    using position_allocator = typename ::std::allocator_traits<Allocator>::template rebind_alloc<::std::size_t>;
+
+public:
+    using value_type = T;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+    using value_compare = Compare;
+    using allocator_type = Allocator;
+
+    static constexpr size_type arity = Arity;
+    static constexpr size_type npos = ::std::numeric_limits<size_type>::max();
+
+private:
+    entry* entries_{};
+    // the position of every key in `entries_`, `npos` when it is not in the heap
+    size_type* positions_{};
+    size_type size_{};
+    size_type key_count_{};
+    [[no_unique_address]] Compare comp_{};
+    [[no_unique_address]] Allocator alloc_{};
+    [[no_unique_address]] ::mcpprt::instrument::site site_{};
+
+public:
+    constexpr explicit indexed_d_ary_heap(
+        size_type key_count, ::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : site_{::mcpprt::instrument::make_site("indexed_d_ary_heap", where)} {
+        this->allocate(key_count);
+    }
+
+    constexpr indexed_d_ary_heap(
+        size_type key_count, Compare const& comp, Allocator const& alloc = Allocator{},
+        ::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : comp_{comp}, alloc_{alloc}, site_{::mcpprt::instrument::make_site("indexed_d_ary_heap", where)} {
+        this->allocate(key_count);
+    }
+
+    constexpr indexed_d_ary_heap(
+        ::mcpprt::container::indexed_d_ary_heap<T, Arity, Compare, Allocator> const& other) noexcept
+        : comp_{other.comp_}, alloc_{other.alloc_}, site_{other.site_} {
+        this->allocate(other.key_count_);
+        ::mcpprt::container::details::copy_out(other.entries_, other.size_, this->entries_);
+        ::std::copy(other.positions_, other.positions_ + other.key_count_, this->positions_);
+        this->size_ = other.size_;
+    }
+
+    constexpr indexed_d_ary_heap(::mcpprt::container::indexed_d_ary_heap<T, Arity, Compare, Allocator>&& other) noexcept
+        : entries_{::std::exchange(other.entries_, nullptr)}, positions_{::std::exchange(other.positions_, nullptr)},
+          size_{::std::exchange(other.size_, 0)}, key_count_{::std::exchange(other.key_count_, 0)},
+          comp_{other.comp_}, alloc_{other.alloc_}, site_{other.site_} {
+    }
+
+    constexpr auto&& operator=(this indexed_d_ary_heap& self, indexed_d_ary_heap const& other) noexcept {
+        if (&self != &other) {
+            self.release();
+            self.comp_ = other.comp_;
+            self.allocate(other.key_count_);
+            ::mcpprt::container::details::copy_out(other.entries_, other.size_, self.entries_);
+            ::std::copy(other.positions_, other.positions_ + other.key_count_, self.positions_);
+            self.size_ = other.size_;
+        }
+        return self;
+    }
+
+    constexpr auto&& operator=(this indexed_d_ary_heap& self, indexed_d_ary_heap&& other) noexcept {
+        if (&self != &other) {
+            self.release();
+            self.entries_ = ::std::exchange(other.entries_, nullptr);
+            self.positions_ = ::std::exchange(other.positions_, nullptr);
+            self.size_ = ::std::exchange(other.size_, 0);
+            self.key_count_ = ::std::exchange(other.key_count_, 0);
+            self.comp_ = other.comp_;
+            self.alloc_ = other.alloc_;
+        }
+        return self;
+    }
+
+    constexpr ~indexed_d_ary_heap() noexcept {
+        this->release();
+    }
+
+    [[nodiscard]]
+    constexpr auto size(this indexed_d_ary_heap const& self) noexcept -> size_type {
+        return self.size_;
+    }
+
+    [[nodiscard]]
+    constexpr bool empty(this indexed_d_ary_heap const& self) noexcept {
+        return self.size_ == 0;
+    }
+
+    /**
+     * @brief one more than the greatest key
+     */
+    [[nodiscard]]
+    constexpr auto key_count(this indexed_d_ary_heap const& self) noexcept -> size_type {
+        return self.key_count_;
+    }
+
+    [[nodiscard]]
+    constexpr bool contains(this indexed_d_ary_heap const& self, size_type key) noexcept {
+        return key < self.key_count_ && self.positions_[key] != npos;
+    }
+
+    template<bool ndebug = false>
+    [[nodiscard]]
+    constexpr auto priority(this indexed_d_ary_heap const& self, size_type key) noexcept -> T const& {
+        ::exception::assert_true<ndebug>(self.contains(key));
+        return self.entries_[self.positions_[key]].priority_;
+    }
+
+    template<bool ndebug = false>
+    [[nodiscard]]
+    constexpr auto top_key(this indexed_d_ary_heap const& self) noexcept -> size_type {
+        ::exception::assert_true<ndebug>(self.size_ != 0);
+        return self.entries_[0].key_;
+    }
+
+    template<bool ndebug = false>
+    [[nodiscard]]
+    constexpr auto top_priority(this indexed_d_ary_heap const& self) noexcept -> T const& {
+        ::exception::assert_true<ndebug>(self.size_ != 0);
+        return self.entries_[0].priority_;
+    }
+
+    /**
+     * @note `key` must not be in the heap
+     */
+    template<bool ndebug = false, typename U>
+        requires (::std::constructible_from<T, U &&>)
+    constexpr void push(this indexed_d_ary_heap& self, size_type key, U&& priority) noexcept {
+        ::exception::assert_true<ndebug>(key < self.key_count_ && self.positions_[key] == npos);
+        ::std::construct_at(self.entries_ + self.size_, entry{key, T(::std::forward<U>(priority))});
+        auto moved = self.observer();
+        auto compare = self.comparer();
+        ::mcpprt::container::details::heap_sift_up<Arity>(self.entries_, self.size_++, compare, moved);
+    }
+
+    /**
+     * @brief give `key`, which must be in the heap, a new priority higher or lower than before
+     */
+    template<bool ndebug = false, typename U>
+        requires (::std::assignable_from<T&, U &&>)
+    constexpr void update(this indexed_d_ary_heap& self, size_type key, U&& priority) noexcept {
+        ::exception::assert_true<ndebug>(self.contains(key));
+        auto pos = self.positions_[key];
+        self.entries_[pos].priority_ = ::std::forward<U>(priority);
+        auto moved = self.observer();
+        auto compare = self.comparer();
+        ::mcpprt::container::details::heap_fix<Arity>(self.entries_, self.size_, pos, compare, moved);
+    }
+
+    /**
+     * @brief push `key`, or move it up if `priority` is above its current one
+     * @return whether the heap changed
+     */
+    template<typename U>
+        requires (::std::constructible_from<T, U &&> && ::std::assignable_from<T&, U &&>)
+    constexpr bool push_or_raise(this indexed_d_ary_heap& self, size_type key, U&& priority) noexcept {
+        ::exception::assert_true(key < self.key_count_);
+        auto pos = self.positions_[key];
+        if (pos == npos) {
+            self.template push<true>(key, ::std::forward<U>(priority));
+            return true;
+        }
+        if (!self.comp_(self.entries_[pos].priority_, priority)) {
+            return false;
+        }
+        self.entries_[pos].priority_ = ::std::forward<U>(priority);
+        auto moved = self.observer();
+        auto compare = self.comparer();
+        ::mcpprt::container::details::heap_sift_up<Arity>(self.entries_, pos, compare, moved);
+        return true;
+    }
+
+    template<bool ndebug = false>
+    constexpr void pop(this indexed_d_ary_heap& self) noexcept {
+        ::exception::assert_true<ndebug>(self.size_ != 0);
+        self.remove_at(0);
+    }
+
+    /**
+     * @return whether `key` was in the heap
+     */
+    constexpr bool erase(this indexed_d_ary_heap& self, size_type key) noexcept {
+        if (!self.contains(key)) {
+            return false;
+        }
+        self.remove_at(self.positions_[key]);
+        return true;
+    }
+
+    constexpr void clear(this indexed_d_ary_heap& self) noexcept {
+        for (size_type i{}; i < self.size_; ++i) {
+            self.positions_[self.entries_[i].key_] = npos;
+        }
+        ::std::destroy(self.entries_, self.entries_ + self.size_);
+        self.size_ = 0;
+    }
+
+private:
+    [[nodiscard]]
+    constexpr auto observer(this indexed_d_ary_heap& self) noexcept {
+        return [positions = self.positions_](entry const& moved, size_type pos) noexcept {
+            positions[moved.key_] = pos;
+        };
+    }
+
+    [[nodiscard]]
+    constexpr auto comparer(this indexed_d_ary_heap& self) noexcept {
+        return [&comp = self.comp_](entry const& left, entry const& right) noexcept {
+            return comp(left.priority_, right.priority_);
+        };
+    }
+
+    constexpr void remove_at(this indexed_d_ary_heap& self, size_type pos) noexcept {
+        self.positions_[self.entries_[pos].key_] = npos;
+        auto last = --self.size_;
+        if (pos != last) {
+            self.entries_[pos] = ::std::move(self.entries_[last]);
+        }
+        ::std::destroy_at(self.entries_ + last);
+        if (pos != last) {
+            auto moved = self.observer();
+            auto compare = self.comparer();
+            ::mcpprt::container::details::heap_fix<Arity>(self.entries_, last, pos, compare, moved);
+        }
+    }
+
+    constexpr void allocate(this indexed_d_ary_heap& self, size_type key_count) noexcept {
+        self.key_count_ = key_count;
+        if (key_count == 0) {
+            return;
+        }
+        entry_allocator entry_alloc{self.alloc_};
+        position_allocator position_alloc{self.alloc_};
+        self.entries_ = ::std::allocator_traits<entry_allocator>::allocate(entry_alloc, key_count);
+        self.positions_ = ::std::allocator_traits<position_allocator>::allocate(position_alloc, key_count);
+        ::mcpprt::instrument::on_allocate(self.site_, key_count * (sizeof(entry) + sizeof(size_type)));
+        ::mcpprt::instrument::on_grow(self.site_, key_count);
+        for (size_type i{}; i < key_count; ++i) {
+            ::std::construct_at(self.positions_ + i, npos);
+        }
+    }
+
+    /**
+     * @brief destroy the entries and free the storage
+     */
+    constexpr void release(this indexed_d_ary_heap& self) noexcept {
+        if (self.entries_ != nullptr) {
+            ::std::destroy(self.entries_, self.entries_ + self.size_);
+            entry_allocator entry_alloc{self.alloc_};
+            position_allocator position_alloc{self.alloc_};
+            ::std::allocator_traits<entry_allocator>::deallocate(entry_alloc, self.entries_, self.key_count_);
+            ::std::allocator_traits<position_allocator>::deallocate(position_alloc, self.positions_, self.key_count_);
+            ::mcpprt::instrument::on_deallocate(self.site_, self.key_count_ * (sizeof(entry) + sizeof(size_type)));
+        }
+        self.entries_ = nullptr;
+        self.positions_ = nullptr;
+        self.size_ = 0;
+        self.key_count_ = 0;
+    }
+};
+
+/**
+ * @brief priority queue holding at most `N` elements in place, never allocates
+ * @note every one of the `N` elements is constructed up front, popped elements are reset by assigning `T{}`
+ */
+template<typename T, ::std::size_t N, ::std::size_t Arity = ::mcpprt::container::default_arity<T>,
+         typename Compare = ::std::less<T>>
+    requires (::std::default_initializable<T> && ::std::movable<T>)
+class static_d_ary_heap {
+    static_assert(Arity >= 2, "Arity must be at least 2");
+
+public:
+    using value_type = T;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+    using value_compare = Compare;
+    using const_iterator = T const*;
+
+    static constexpr size_type arity = Arity;
+
+private:
+    ::mcpprt::container::array<T, N> values_{};
+    size_type size_{};
+    [[no_unique_address]] Compare comp_{};
+
+public:
+    constexpr static_d_ary_heap() noexcept = default;
+
+    constexpr explicit static_d_ary_heap(Compare const& comp) noexcept : comp_{comp} {
+    }
+
+    /**
+     * @note at most `N` elements
+     */
+    constexpr static_d_ary_heap(::std::initializer_list<T> init) noexcept {
+        this->assign(init.begin(), init.end());
+    }
+
+    [[nodiscard]]
+    constexpr auto size(this static_d_ary_heap const& self) noexcept -> size_type {
+        return self.size_;
+    }
+
+    [[nodiscard]]
+    constexpr bool empty(this static_d_ary_heap const& self) noexcept {
+        return self.size_ == 0;
+    }
+
+    [[nodiscard]]
+    constexpr bool full(this static_d_ary_heap const& self) noexcept {
+        return self.size_ == N;
+    }
+
+    [[nodiscard]]
+    static constexpr auto capacity() noexcept -> size_type {
+        return N;
+    }
+
+    [[nodiscard]]
+    constexpr auto begin(this static_d_ary_heap const& self) noexcept -> const_iterator {
+        return self.values_.value_;
+    }
+
+    [[nodiscard]]
+    constexpr auto end(this static_d_ary_heap const& self) noexcept -> const_iterator {
+        return self.values_.value_ + self.size_;
+    }
+
+    template<bool ndebug = false>
+    [[nodiscard]]
+    constexpr auto top(this static_d_ary_heap const& self) noexcept -> T const& {
+        ::exception::assert_true<ndebug>(self.size_ != 0);
+        return self.values_.value_[0];
+    }
+
+    /**
+     * @return false when the heap is full
+     */
+    template<typename... Args>
+        requires (::std::constructible_from<T, Args && ...>)
+    constexpr bool emplace(this static_d_ary_heap& self, Args&&... args) noexcept {
+        if (self.size_ == N) {
+            return false;
+        }
+        self.values_.value_[self.size_] = T(::std::forward<Args>(args)...);
+        ::mcpprt::container::details::heap_unobserved moved{};
+        ::mcpprt::container::details::heap_sift_up<Arity>(self.values_.value_, self.size_++, self.comp_, moved);
+        return true;
+    }
+
+    constexpr bool push(this static_d_ary_heap& self, T const& value) noexcept {
+        return self.emplace(value);
+    }
+
+    constexpr bool push(this static_d_ary_heap& self, T&& value) noexcept {
+        return self.emplace(::std::move(value));
+    }
+
+    template<bool ndebug = false>
+    constexpr void pop(this static_d_ary_heap& self) noexcept {
+        ::exception::assert_true<ndebug>(self.size_ != 0);
+        auto last = --self.size_;
+        if (last != 0) {
+            self.values_.value_[0] = ::std::move(self.values_.value_[last]);
+        }
+        self.values_.value_[last] = T{};
+        if (last > 1) {
+            ::mcpprt::container::details::heap_unobserved moved{};
+            ::mcpprt::container::details::heap_sift_down<Arity>(self.values_.value_, last, 0, self.comp_, moved);
+        }
+    }
+
+    /**
+     * @brief pop and push in one sift, for keeping the best k of a stream
+     */
+    template<bool ndebug = false, typename U>
+        requires (::std::assignable_from<T&, U &&>)
+    constexpr void replace_top(this static_d_ary_heap& self, U&& value) noexcept {
+        ::exception::assert_true<ndebug>(self.size_ != 0);
+        self.values_.value_[0] = ::std::forward<U>(value);
+        ::mcpprt::container::details::heap_unobserved moved{};
+        ::mcpprt::container::details::heap_sift_down<Arity>(self.values_.value_, self.size_, 0, self.comp_, moved);
+    }
+
+    /**
+     * @brief replace the elements by those of a range of at most `N` elements and build the heap in O(n)
+     */
+    template<::std::input_iterator It, ::std::sentinel_for<It> S>
+    constexpr void assign(this static_d_ary_heap& self, It first, S last) noexcept {
+        self.clear();
+        for (; first != last; ++first) {
+            ::exception::assert_true(self.size_ != N);
+            self.values_.value_[self.size_++] = *first;
+        }
+        ::mcpprt::container::details::heap_unobserved moved{};
+        ::mcpprt::container::details::heap_make<Arity>(self.values_.value_, self.size_, self.comp_, moved);
+    }
+
+    constexpr void clear(this static_d_ary_heap& self) noexcept {
+        for (size_type i{}; i < self.size_; ++i) {
+            self.values_.value_[i] = T{};
+        }
+        self.size_ = 0;
+    }
+};
+
+} // namespace mcpprt::container
@@ -0,0 +1,499 @@
+#pragma once
+
+/**
+ * @file deque.hh
+ * @brief double-ended queue over fixed-size blocks that never moves its elements
+ * @details elements live in cache-aligned blocks of a power-of-two number of elements, a map of block pointers
+ *          puts them in order. Growing at either end only ever reallocates the map, blocks emptied by pops are
+ *          kept in a spare pool and handed out again before the allocator is asked for more.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <exception/exception.hh>
+#include "../instrument/counters.hh"
+
+namespace mcpprt::container {
+
+namespace details {
+
+template<typename T, ::std::size_t Capacity>
+struct alignas(64) alignas(T) deque_block {
+    union {
+        T values_[Capacity];
+        /**
+         * @brief the next block of the spare pool, only while the block holds no element
+         */
+        ::mcpprt::container::details::deque_block<T, Capacity>* next_;
+    };
+
+    deque_block() noexcept {
+    }
+
+    /**
+     * @note the elements are destroyed by the deque
+     */
+    ~deque_block() noexcept {
+    }
+};
+
+} // namespace details
+
+/**
+ * @brief https://en.cppreference.com/w/cpp/container/deque.html
+ * @tparam BlockBytes: size of a block, rounded so that a block holds a power of two, and at least 8, elements
+ * @note pushing and popping at either end keeps references to the other elements valid. Iterators are
+ *       invalidated by any push that needs a new block, which may move the blocks within the map or reallocate
+ *       it, and by any push onto a deque that was emptied, which starts over in the middle of the map, so like
+ *       with std::deque, iterators must not be kept across pushes
+ * @note spare blocks stay with the deque until `shrink_to_fit`, the memory of a queue is its high-water mark
+ */
+template<typename T, typename Allocator = ::std::allocator<T>, ::std::size_t BlockBytes = 4096>
+class deque {
+public:
+    static constexpr ::std::size_t block_capacity =
+        ::std::bit_floor(::std::max<::std::size_t>(8, BlockBytes / sizeof(T)));
+
+private:
+    static constexpr ::std::size_t block_shift = static_cast<::std::size_t>(::std::countr_zero(block_capacity));
+    static constexpr ::std::size_t block_mask = block_capacity - 1;
+
+    using block_type = ::mcpprt::container::details::deque_block<T, block_capacity>;
+    using block_allocator = typename ::std::allocator_traits<Allocator>::template rebind_alloc<block_type>;
+    using map_allocator = typename ::std::allocator_traits<Allocator>::template rebind_alloc<block_type*>;
+
+    template<bool Const>
+    class basic_iterator {
+        friend class deque;
+        friend class basic_iterator<!Const>;
+
+        block_type* const* map_{};
+        // position counted from the first element of the block `map_[0]`
+        ::std::size_t pos_{};
+
+        constexpr basic_iterator(block_type* const* map, ::std::size_t pos) noexcept : map_{map}, pos_{pos} {
+        }
+
+    public:
+        using iterator_category = ::std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = ::std::ptrdiff_t;
+        using pointer = ::std::conditional_t<Const, T const*, T*>;
+        using reference = ::std::conditional_t<Const, T const&, T&>;
+
+        constexpr basic_iterator() noexcept = default;
+
+        template<bool OtherConst>
+            requires (Const && !OtherConst)
+        constexpr basic_iterator(basic_iterator<OtherConst> const& other) noexcept
+            : map_{other.map_}, pos_{other.pos_} {
+        }
+
+        [[nodiscard]]
+        constexpr auto operator*(this basic_iterator const& self) noexcept -> reference {
+            return self.map_[self.pos_ >> block_shift]->values_[self.pos_ & block_mask];
+        }
+
+        [[nodiscard]]
+        constexpr auto operator->(this basic_iterator const& self) noexcept -> pointer {
+            return ::std::addressof(*self);
+        }
+
+        [[nodiscard]]
+        constexpr auto operator[](this basic_iterator const& self, difference_type n) noexcept -> reference {
+            auto pos = self.pos_ + static_cast<::std::size_t>(n);
+            return self.map_[pos >> block_shift]->values_[pos & block_mask];
+        }
+
+        constexpr auto&& operator+=(this basic_iterator& self, difference_type n) noexcept {
+            self.pos_ += static_cast<::std::size_t>(n);
+            return self;
+        }
+
+        constexpr auto&& operator-=(this basic_iterator& self, difference_type n) noexcept {
+            self.pos_ -= static_cast<::std::size_t>(n);
+            return self;
+        }
+
+        constexpr auto&& operator++(this basic_iterator& self) noexcept {
+            ++self.pos_;
+            return self;
+        }
+
+        constexpr auto operator++(this basic_iterator& self, int) noexcept -> basic_iterator {
+            auto result = self;
+            ++self.pos_;
+            return result;
+        }
+
+        constexpr auto&& operator--(this basic_iterator& self) noexcept {
+            --self.pos_;
+            return self;
+        }
+
+        constexpr auto operator--(this basic_iterator& self, int) noexcept -> basic_iterator {
+            auto result = self;
+            --self.pos_;
+            return result;
+        }
+
+        [[nodiscard]]
+        constexpr auto operator+(this basic_iterator const& self, difference_type n) noexcept -> basic_iterator {
+            auto result = self;
+            return result += n;
+        }
+
+        [[nodiscard]]
+        friend constexpr auto operator+(difference_type n, basic_iterator const& self) noexcept -> basic_iterator {
+            return self + n;
+        }
+
+        [[nodiscard]]
+        constexpr auto operator-(this basic_iterator const& self, difference_type n) noexcept -> basic_iterator {
+            auto result = self;
+            return result -= n;
+        }
+
+        [[nodiscard]]
+        constexpr auto operator-(this basic_iterator const& self, basic_iterator const& other) noexcept
+            -> difference_type {
+            return static_cast<difference_type>(self.pos_ - other.pos_);
+        }
+
+        [[nodiscard]]
+        constexpr bool operator==(this basic_iterator const& self, basic_iterator const& other) noexcept {
+            return self.pos_ == other.pos_;
+        }
+
+        [[nodiscard]]
+        constexpr auto operator<=>(this basic_iterator const& self, basic_iterator const& other) noexcept {
+            return self.pos_ <=> other.pos_;
+        }
+    };
+
+public:
+    using value_type = T;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = value_type const&;
+    using allocator_type = Allocator;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+private:
+    // entries outside the blocks holding elements are nullptr
+    block_type** map_{};
+    size_type map_capacity_{};
+    // position of the front element counted from the first element of the block `map_[0]`
+    size_type first_{};
+    size_type size_{};
+    block_type* spare_{};
+    [[no_unique_address]] Allocator alloc_{};
+    [[no_unique_address]] ::mcpprt::instrument::site site_{};
+
+public:
+    explicit deque(::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : site_{::mcpprt::instrument::make_site("deque", where)} {
+    }
+
+    explicit deque(Allocator const& alloc,
+                   ::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : alloc_{alloc}, site_{::mcpprt::instrument::make_site("deque", where)} {
+    }
+
+    deque(::mcpprt::container::deque<T, Allocator, BlockBytes> const& other) noexcept
+        : alloc_{other.alloc_}, site_{other.site_} {
+        for (auto const& value : other) {
+            this->emplace_back(value);
+        }
+    }
+
+    deque(::mcpprt::container::deque<T, Allocator, BlockBytes>&& other) noexcept
+        : map_{::std::exchange(other.map_, nullptr)}, map_capacity_{::std::exchange(other.map_capacity_, 0)},
+          first_{::std::exchange(other.first_, 0)}, size_{::std::exchange(other.size_, 0)},
+          spare_{::std::exchange(other.spare_, nullptr)}, alloc_{other.alloc_}, site_{other.site_} {
+    }
+
+    auto&& operator=(this deque& self, deque const& other) noexcept {
+        if (&self != &other) {
+            self.clear();
+            for (auto const& value : other) {
+                self.emplace_back(value);
+            }
+        }
+        return self;
+    }
+
+    auto&& operator=(this deque& self, deque&& other) noexcept {
+        if (&self != &other) {
+            self.release();
+            self.map_ = ::std::exchange(other.map_, nullptr);
+            self.map_capacity_ = ::std::exchange(other.map_capacity_, 0);
+            self.first_ = ::std::exchange(other.first_, 0);
+            self.size_ = ::std::exchange(other.size_, 0);
+            self.spare_ = ::std::exchange(other.spare_, nullptr);
+            self.alloc_ = other.alloc_;
+        }
+        return self;
+    }
+
+    ~deque() noexcept {
+        this->release();
+    }
+
+    [[nodiscard]]
+    auto size(this deque const& self) noexcept -> size_type {
+        return self.size_;
+    }
+
+    [[nodiscard]]
+    bool empty(this deque const& self) noexcept {
+        return self.size_ == 0;
+    }
+
+    [[nodiscard]]
+    auto begin(this deque& self) noexcept -> iterator {
+        return iterator{self.map_, self.first_};
+    }
+
+    [[nodiscard]]
+    auto begin(this deque const& self) noexcept -> const_iterator {
+        return const_iterator{self.map_, self.first_};
+    }
+
+    [[nodiscard]]
+    auto end(this deque& self) noexcept -> iterator {
+        return iterator{self.map_, self.first_ + self.size_};
+    }
+
+    [[nodiscard]]
+    auto end(this deque const& self) noexcept -> const_iterator {
+        return const_iterator{self.map_, self.first_ + self.size_};
+    }
+
+    template<bool ndebug = false>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+    [[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+    [[msvc::forceinline]]
+#endif
+    [[nodiscard]]
+    auto&& operator[](this auto&& self, size_type index) noexcept {
+        ::exception::assert_true<ndebug>(index < self.size_);
+        return ::std::forward_like<decltype(self)>(self.element(self.first_ + index));
+    }
+
+    [[nodiscard]]
+    auto&& at(this auto&& self, size_type index) noexcept {
+        ::exception::assert_true(index < self.size_);
+        return ::std::forward_like<decltype(self)>(self.element(self.first_ + index));
+    }
+
+    template<bool ndebug = false>
+    [[nodiscard]]
+    auto&& front(this auto&& self) noexcept {
+        ::exception::assert_true<ndebug>(self.size_ != 0);
+        return ::std::forward_like<decltype(self)>(self.element(self.first_));
+    }
+
+    template<bool ndebug = false>
+    [[nodiscard]]
+    auto&& back(this auto&& self) noexcept {
+        ::exception::assert_true<ndebug>(self.size_ != 0);
+        return ::std::forward_like<decltype(self)>(self.element(self.first_ + self.size_ - 1));
+    }
+
+    template<typename... Args>
+        requires (::std::constructible_from<T, Args && ...>)
+    auto emplace_back(this deque& self, Args&&... args) noexcept -> T& {
+        auto pos = self.first_ + self.size_;
+        if ((pos >> block_shift) == self.map_capacity_) [[unlikely]] {
+            self.make_room(false);
+            pos = self.first_ + self.size_;
+        }
+        auto*& block = self.map_[pos >> block_shift];
+        if (block == nullptr) {
+            block = self.acquire_block();
+        }
+        auto* value = ::std::construct_at(block->values_ + (pos & block_mask), ::std::forward<Args>(args)...);
+        ++self.size_;
+        return *value;
+    }
+
+    template<typename... Args>
+        requires (::std::constructible_from<T, Args && ...>)
+    auto emplace_front(this deque& self, Args&&... args) noexcept -> T& {
+        if (self.first_ == 0) [[unlikely]] {
+            self.make_room(true);
+        }
+        auto pos = self.first_ - 1;
+        auto*& block = self.map_[pos >> block_shift];
+        if (block == nullptr) {
+            block = self.acquire_block();
+        }
+        auto* value = ::std::construct_at(block->values_ + (pos & block_mask), ::std::forward<Args>(args)...);
+        self.first_ = pos;
+        ++self.size_;
+        return *value;
+    }
+
+    void push_back(this deque& self, T const& value) noexcept {
+        self.emplace_back(value);
+    }
+
+    void push_back(this deque& self, T&& value) noexcept {
+        self.emplace_back(::std::move(value));
+    }
+
+    void push_front(this deque& self, T const& value) noexcept {
+        self.emplace_front(value);
+    }
+
+    void push_front(this deque& self, T&& value) noexcept {
+        self.emplace_front(::std::move(value));
+    }
+
+    template<bool ndebug = false>
+    void pop_back(this deque& self) noexcept {
+        ::exception::assert_true<ndebug>(self.size_ != 0);
+        auto pos = self.first_ + --self.size_;
+        ::std::destroy_at(::std::addressof(self.element(pos)));
+        if ((pos & block_mask) == 0 || self.size_ == 0) {
+            self.release_block(pos >> block_shift);
+            self.recenter_if_empty();
+        }
+    }
+
+    template<bool ndebug = false>
+    void pop_front(this deque& self) noexcept {
+        ::exception::assert_true<ndebug>(self.size_ != 0);
+        auto pos = self.first_++;
+        ::std::destroy_at(::std::addressof(self.element(pos)));
+        --self.size_;
+        if ((self.first_ & block_mask) == 0 || self.size_ == 0) {
+            self.release_block(pos >> block_shift);
+            self.recenter_if_empty();
+        }
+    }
+
+    /**
+     * @note the blocks go to the spare pool
+     */
+    void clear(this deque& self) noexcept {
+        while (self.size_ != 0) {
+            self.template pop_back<true>();
+        }
+    }
+
+    /**
+     * @brief give the spare blocks back to the allocator
+     */
+    void shrink_to_fit(this deque& self) noexcept {
+        block_allocator alloc{self.alloc_};
+        while (self.spare_ != nullptr) {
+            auto* block = ::std::exchange(self.spare_, self.spare_->next_);
+            ::std::destroy_at(block);
+            ::std::allocator_traits<block_allocator>::deallocate(alloc, block, 1);
+            ::mcpprt::instrument::on_deallocate(self.site_, sizeof(block_type));
+        }
+    }
+
+private:
+    [[nodiscard]]
+    auto&& element(this auto&& self, size_type pos) noexcept {
+        return ::std::forward_like<decltype(self)>(self.map_[pos >> block_shift]->values_[pos & block_mask]);
+    }
+
+    [[nodiscard]]
+    auto acquire_block(this deque& self) noexcept -> block_type* {
+        if (self.spare_ != nullptr) {
+            return ::std::exchange(self.spare_, self.spare_->next_);
+        }
+        block_allocator alloc{self.alloc_};
+        auto* block = ::std::allocator_traits<block_allocator>::allocate(alloc, 1);
+        ::mcpprt::instrument::on_allocate(self.site_, sizeof(block_type));
+        return ::std::construct_at(block);
+    }
+
+    void release_block(this deque& self, size_type index) noexcept {
+        auto* block = ::std::exchange(self.map_[index], nullptr);
+        block->next_ = self.spare_;
+        self.spare_ = block;
+    }
+
+    /**
+     * @brief an empty queue starts over in the middle of the map, a queue that is filled and drained from
+     *        opposite ends does not drift into the edge of the map
+     */
+    void recenter_if_empty(this deque& self) noexcept {
+        if (self.size_ == 0) {
+            self.first_ = (self.map_capacity_ / 2) << block_shift;
+        }
+    }
+
+    /**
+     * @brief make sure the map has a free entry before the first block, or after the last one
+     * @details the blocks in use are centered in the map, which is reallocated only when they fill half of it
+     */
+    void make_room(this deque& self, bool at_front) noexcept {
+        auto first_block = self.first_ >> block_shift;
+        auto used = self.size_ == 0 ? 0 : ((self.first_ + self.size_ - 1) >> block_shift) - first_block + 1;
+        auto offset = self.first_ & block_mask;
+
+        if (self.map_capacity_ < 2 * (used + 1)) {
+            auto capacity = ::std::max<size_type>({8, 2 * self.map_capacity_, 2 * (used + 1)});
+            map_allocator alloc{self.alloc_};
+            auto* map = ::std::allocator_traits<map_allocator>::allocate(alloc, capacity);
+            ::mcpprt::instrument::on_allocate(self.site_, capacity * sizeof(block_type*));
+            auto start = (capacity - used - 1) / 2 + at_front;
+            ::std::fill(map, map + capacity, nullptr);
+            ::std::copy(self.map_ + first_block, self.map_ + first_block + used, map + start);
+            if (self.map_ != nullptr) {
+                ::std::allocator_traits<map_allocator>::deallocate(alloc, self.map_, self.map_capacity_);
+                ::mcpprt::instrument::on_deallocate(self.site_, self.map_capacity_ * sizeof(block_type*));
+                ::mcpprt::instrument::on_reallocate(self.site_);
+            }
+            ::mcpprt::instrument::on_grow(self.site_, capacity * block_capacity);
+            self.map_ = map;
+            self.map_capacity_ = capacity;
+            self.first_ = (start << block_shift) | offset;
+            return;
+        }
+
+        auto start = (self.map_capacity_ - used - 1) / 2 + at_front;
+        if (start < first_block) {
+            ::std::copy(self.map_ + first_block, self.map_ + first_block + used, self.map_ + start);
+        } else {
+            ::std::copy_backward(self.map_ + first_block, self.map_ + first_block + used, self.map_ + start + used);
+        }
+        ::std::fill(self.map_, self.map_ + start, nullptr);
+        ::std::fill(self.map_ + start + used, self.map_ + self.map_capacity_, nullptr);
+        self.first_ = (start << block_shift) | offset;
+    }
+
+    /**
+     * @brief destroy the elements and free every block and the map
+     */
+    void release(this deque& self) noexcept {
+        self.clear();
+        self.shrink_to_fit();
+        if (self.map_ != nullptr) {
+            map_allocator alloc{self.alloc_};
+            ::std::allocator_traits<map_allocator>::deallocate(alloc, self.map_, self.map_capacity_);
+            ::mcpprt::instrument::on_deallocate(self.site_, self.map_capacity_ * sizeof(block_type*));
+        }
+        self.map_ = nullptr;
+        self.map_capacity_ = 0;
+        self.first_ = 0;
+    }
+};
+
+} // namespace mcpprt::container
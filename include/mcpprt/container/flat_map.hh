@@ -0,0 +1,512 @@
+#pragma once
+
+/**
+ * @file flat_map.hh
+ * @brief ordered map over two sorted arrays, for data that is read far more often than it is written
+ * @details keys and values are stored apart, https://en.cppreference.com/w/cpp/container/flat_map.html,
+ *          a lookup is a branchless binary search over the key array only
+ */
+
+#include <algorithm>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <exception/exception.hh>
+#include "../instrument/counters.hh"
+#include "search.hh"
+#include "uninitialized.hh"
+
+namespace mcpprt::container {
+
+/**
+ * @brief sorted map with unique keys, inserting or erasing moves every element after the position
+ * @note every operation that changes the map invalidates all iterators
+ */
+template<typename Key, typename T, typename Compare = ::std::less<Key>,
+         typename Allocator = ::std::allocator<::std::pair<Key, T>>>
+class flat_map {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = ::std::pair<Key, T>;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+    using key_compare = Compare;
+    using allocator_type = Allocator;
+
+private:
+    using key_allocator = typename ::std::allocator_traits<Allocator>::template rebind_alloc<Key>;
+    using mapped_allocator = typename ::std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+    template<bool Const>
+    class basic_iterator {
+        friend class flat_map;
+        friend class basic_iterator<!Const>;
+
+        using mapped_pointer = ::std::conditional_t<Const, T const*, T*>;
+
+        Key const* key_{};
+        mapped_pointer value_{};
+
+        constexpr basic_iterator(Key const* key, mapped_pointer value) noexcept
+            : key_{key}, value_{value} {
+        }
+
+    public:
+        using iterator_category = ::std::random_access_iterator_tag;
+        using value_type = ::std::pair<Key, T>;
+        using difference_type = ::std::ptrdiff_t;
+        using reference = ::std::pair<Key const&, ::std::conditional_t<Const, T const&, T&>>;
+
+        constexpr basic_iterator() noexcept = default;
+
+        template<bool OtherConst>
+            requires (Const && !OtherConst)
+        constexpr basic_iterator(basic_iterator<OtherConst> const& other) noexcept
+            : key_{other.key_}, value_{other.value_} {
+        }
+
+        [[nodiscard]]
+        constexpr auto operator*(this basic_iterator const& self) noexcept -> reference {
+            return reference{*self.key_, *self.value_};
+        }
+
+        [[nodiscard]]
+        constexpr auto operator[](this basic_iterator const& self, difference_type n) noexcept -> reference {
+            return reference{self.key_[n], self.value_[n]};
+        }
+
+        [[nodiscard]]
+        constexpr auto key(this basic_iterator const& self) noexcept -> Key const& {
+            return *self.key_;
+        }
+
+        [[nodiscard]]
+        constexpr auto value(this basic_iterator const& self) noexcept -> ::std::conditional_t<Const, T const&, T&> {
+            return *self.value_;
+        }
+
+        constexpr auto&& operator+=(this basic_iterator& self, difference_type n) noexcept {
+            self.key_ += n;
+            self.value_ += n;
+            return self;
+        }
+
+        constexpr auto&& operator-=(this basic_iterator& self, difference_type n) noexcept {
+            self.key_ -= n;
+            self.value_ -= n;
+            return self;
+        }
+
+        constexpr auto&& operator++(this basic_iterator& self) noexcept {
+            return self += 1;
+        }
+
+        constexpr auto operator++(this basic_iterator& self, int) noexcept -> basic_iterator {
+            auto result = self;
+            self += 1;
+            return result;
+        }
+
+        constexpr auto&& operator--(this basic_iterator& self) noexcept {
+            return self -= 1;
+        }
+
+        constexpr auto operator--(this basic_iterator& self, int) noexcept -> basic_iterator {
+            auto result = self;
+            self -= 1;
+            return result;
+        }
+
+        [[nodiscard]]
+        constexpr auto operator+(this basic_iterator const& self, difference_type n) noexcept -> basic_iterator {
+            auto result = self;
+            return result += n;
+        }
+
+        [[nodiscard]]
+        friend constexpr auto operator+(difference_type n, basic_iterator const& self) noexcept -> basic_iterator {
+            return self + n;
+        }
+
+        [[nodiscard]]
+        constexpr auto operator-(this basic_iterator const& self, difference_type n) noexcept -> basic_iterator {
+            auto result = self;
+            return result -= n;
+        }
+
+        [[nodiscard]]
+        constexpr auto operator-(this basic_iterator const& self, basic_iterator const& other) noexcept
+            -> difference_type {
+            return self.key_ - other.key_;
+        }
+
+        [[nodiscard]]
+        constexpr bool operator==(this basic_iterator const& self, basic_iterator const& other) noexcept {
+            return self.key_ == other.key_;
+        }
+
+        [[nodiscard]]
+        constexpr auto operator<=>(this basic_iterator const& self, basic_iterator const& other) noexcept {
+            return self.key_ <=> other.key_;
+        }
+    };
+
+public:
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+private:
+    Key* keys_{};
+    T* values_{};
+    size_type size_{};
+    size_type capacity_{};
+    [[no_unique_address]] Compare comp_{};
+    [[no_unique_address]] Allocator alloc_{};
+    [[no_unique_address]] ::mcpprt::instrument::site site_{};
+
+public:
+    constexpr explicit flat_map(
+        ::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : site_{::mcpprt::instrument::make_site("flat_map", where)} {
+    }
+
+    constexpr explicit flat_map(
+        Compare const& comp, Allocator const& alloc = Allocator{},
+        ::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : comp_{comp}, alloc_{alloc}, site_{::mcpprt::instrument::make_site("flat_map", where)} {
+    }
+
+    /**
+     * @note later duplicates of a key are ignored
+     */
+    constexpr flat_map(::std::initializer_list<value_type> init,
+                       ::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : site_{::mcpprt::instrument::make_site("flat_map", where)} {
+        this->reserve(init.size());
+        for (auto const& [key, value] : init) {
+            this->try_emplace(key, value);
+        }
+    }
+
+    constexpr flat_map(::mcpprt::container::flat_map<Key, T, Compare, Allocator> const& other) noexcept
+        : comp_{other.comp_}, alloc_{other.alloc_}, site_{other.site_} {
+        this->reserve(other.size_);
+        ::mcpprt::container::details::copy_out(other.keys_, other.size_, this->keys_);
+        ::mcpprt::container::details::copy_out(other.values_, other.size_, this->values_);
+        this->size_ = other.size_;
+    }
+
+    constexpr flat_map(::mcpprt::container::flat_map<Key, T, Compare, Allocator>&& other) noexcept
+        : keys_{::std::exchange(other.keys_, nullptr)}, values_{::std::exchange(other.values_, nullptr)},
+          size_{::std::exchange(other.size_, 0)}, capacity_{::std::exchange(other.capacity_, 0)},
+          comp_{other.comp_}, alloc_{other.alloc_}, site_{other.site_} {
+    }
+
+    constexpr auto&& operator=(this flat_map& self, flat_map const& other) noexcept {
+        if (&self != &other) {
+            self.clear();
+            self.reserve(other.size_);
+            ::mcpprt::container::details::copy_out(other.keys_, other.size_, self.keys_);
+            ::mcpprt::container::details::copy_out(other.values_, other.size_, self.values_);
+            self.size_ = other.size_;
+            self.comp_ = other.comp_;
+        }
+        return self;
+    }
+
+    constexpr auto&& operator=(this flat_map& self, flat_map&& other) noexcept {
+        if (&self != &other) {
+            self.release();
+            self.keys_ = ::std::exchange(other.keys_, nullptr);
+            self.values_ = ::std::exchange(other.values_, nullptr);
+            self.size_ = ::std::exchange(other.size_, 0);
+            self.capacity_ = ::std::exchange(other.capacity_, 0);
+            self.comp_ = other.comp_;
+            self.alloc_ = other.alloc_;
+        }
+        return self;
+    }
+
+    constexpr ~flat_map() noexcept {
+        this->release();
+    }
+
+    [[nodiscard]]
+    constexpr auto size(this flat_map const& self) noexcept -> size_type {
+        return self.size_;
+    }
+
+    [[nodiscard]]
+    constexpr bool empty(this flat_map const& self) noexcept {
+        return self.size_ == 0;
+    }
+
+    [[nodiscard]]
+    constexpr auto capacity(this flat_map const& self) noexcept -> size_type {
+        return self.capacity_;
+    }
+
+    [[nodiscard]]
+    constexpr auto begin(this flat_map& self) noexcept -> iterator {
+        return iterator{self.keys_, self.values_};
+    }
+
+    [[nodiscard]]
+    constexpr auto begin(this flat_map const& self) noexcept -> const_iterator {
+        return const_iterator{self.keys_, self.values_};
+    }
+
+    [[nodiscard]]
+    constexpr auto end(this flat_map& self) noexcept -> iterator {
+        return iterator{self.keys_ + self.size_, self.values_ + self.size_};
+    }
+
+    [[nodiscard]]
+    constexpr auto end(this flat_map const& self) noexcept -> const_iterator {
+        return const_iterator{self.keys_ + self.size_, self.values_ + self.size_};
+    }
+
+    [[nodiscard]]
+    constexpr auto lower_bound(this auto&& self, Key const& key) noexcept {
+        return self.begin() + static_cast<difference_type>(
+                                  ::mcpprt::container::details::lower_rank(self.keys_, self.size_, key, self.comp_));
+    }
+
+    [[nodiscard]]
+    constexpr auto upper_bound(this auto&& self, Key const& key) noexcept {
+        return self.begin() + static_cast<difference_type>(
+                                  ::mcpprt::container::details::upper_rank(self.keys_, self.size_, key, self.comp_));
+    }
+
+    [[nodiscard]]
+    constexpr auto find(this auto&& self, Key const& key) noexcept {
+        auto it = self.lower_bound(key);
+        if (it == self.end() || self.comp_(key, it.key())) {
+            return self.end();
+        }
+        return it;
+    }
+
+    [[nodiscard]]
+    constexpr bool contains(this flat_map const& self, Key const& key) noexcept {
+        return self.find(key) != self.end();
+    }
+
+    /**
+     * @brief the value mapped to `key`, if any
+     */
+    [[nodiscard]]
+    constexpr auto get(this flat_map& self, Key const& key) noexcept -> ::exception::optional<T*> {
+        auto it = self.find(key);
+        if (it == self.end()) {
+            return ::exception::nullopt_t{};
+        }
+        return &it.value();
+    }
+
+    [[nodiscard]]
+    constexpr auto get(this flat_map const& self, Key const& key) noexcept -> ::exception::optional<T const*> {
+        auto it = self.find(key);
+        if (it == self.end()) {
+            return ::exception::nullopt_t{};
+        }
+        return &it.value();
+    }
+
+    /**
+     * @brief the value mapped to `key`, which must be present
+     */
+    template<bool ndebug = false>
+    [[nodiscard]]
+    constexpr auto&& at(this auto&& self, Key const& key) noexcept {
+        auto it = self.find(key);
+        ::exception::assert_true<ndebug>(it != self.end());
+        return ::std::forward_like<decltype(self)>(it.value());
+    }
+
+    constexpr void reserve(this flat_map& self, size_type capacity) noexcept {
+        if (capacity > self.capacity_) {
+            self.reallocate(capacity);
+        }
+    }
+
+    /**
+     * @brief construct the value from `args` unless `key` is already present
+     * @return the element with `key` and whether it was inserted
+     * @note `key` and `args` must not refer to elements of the map, the storage may move
+     */
+    template<typename K, typename... Args>
+        requires (::std::same_as<::std::remove_cvref_t<K>, Key> && ::std::constructible_from<T, Args && ...>)
+    constexpr auto try_emplace(this flat_map& self, K&& key, Args&&... args) noexcept
+        -> ::std::pair<iterator, bool> {
+        auto pos = ::mcpprt::container::details::lower_rank(self.keys_, self.size_, key, self.comp_);
+        if (pos < self.size_ && !self.comp_(key, self.keys_[pos])) {
+            return {self.begin() + static_cast<difference_type>(pos), false};
+        }
+        if (self.size_ == self.capacity_) {
+            self.reallocate(self.capacity_ == 0 ? 8 : self.capacity_ * 2);
+        }
+        return self.insert_at(pos, ::std::forward<K>(key), ::std::forward<Args>(args)...);
+    }
+
+    constexpr auto insert(this flat_map& self, Key const& key, T const& value) noexcept -> ::std::pair<iterator, bool> {
+        return self.try_emplace(key, value);
+    }
+
+    constexpr auto insert(this flat_map& self, Key&& key, T&& value) noexcept -> ::std::pair<iterator, bool> {
+        return self.try_emplace(::std::move(key), ::std::move(value));
+    }
+
+    template<typename K, typename V>
+        requires (::std::same_as<::std::remove_cvref_t<K>, Key> && ::std::assignable_from<T&, V &&> &&
+                  ::std::constructible_from<T, V &&>)
+    constexpr auto insert_or_assign(this flat_map& self, K&& key, V&& value) noexcept -> ::std::pair<iterator, bool> {
+        auto result = self.try_emplace(::std::forward<K>(key), ::std::forward<V>(value));
+        if (!result.second) {
+            result.first.value() = ::std::forward<V>(value);
+        }
+        return result;
+    }
+
+    /**
+     * @brief merge a range sorted by key with unique keys in one pass, keys already present are kept
+     * @param first: elements with `first` and `second` members, like `std::pair<Key, T>`
+     */
+    template<::std::forward_iterator It, ::std::sentinel_for<It> S>
+    constexpr void insert_sorted(this flat_map& self, It first, S last) noexcept {
+        auto count = static_cast<size_type>(::std::ranges::distance(first, last));
+        if (count == 0) {
+            return;
+        }
+
+        key_allocator key_alloc{self.alloc_};
+        mapped_allocator mapped_alloc{self.alloc_};
+        auto capacity = ::std::max(self.size_ + count, self.capacity_);
+        auto* keys = ::std::allocator_traits<key_allocator>::allocate(key_alloc, capacity);
+        auto* values = ::std::allocator_traits<mapped_allocator>::allocate(mapped_alloc, capacity);
+        ::mcpprt::instrument::on_allocate(self.site_, capacity * (sizeof(Key) + sizeof(T)));
+
+        size_type out{};
+        size_type i{};
+        while (i < self.size_ && first != last) {
+            auto const& element = *first;
+            if (self.comp_(self.keys_[i], element.first)) {
+                ::std::construct_at(keys + out, ::std::move(self.keys_[i]));
+                ::std::construct_at(values + out, ::std::move(self.values_[i]));
+                ++i;
+            } else {
+                if (self.comp_(element.first, self.keys_[i])) {
+                    ::std::construct_at(keys + out, element.first);
+                    ::std::construct_at(values + out, element.second);
+                } else {
+                    ::std::construct_at(keys + out, ::std::move(self.keys_[i]));
+                    ::std::construct_at(values + out, ::std::move(self.values_[i]));
+                    ++i;
+                }
+                ++first;
+            }
+            ++out;
+        }
+        for (; i < self.size_; ++i, ++out) {
+            ::std::construct_at(keys + out, ::std::move(self.keys_[i]));
+            ::std::construct_at(values + out, ::std::move(self.values_[i]));
+        }
+        for (; first != last; ++first, ++out) {
+            auto const& element = *first;
+            ::std::construct_at(keys + out, element.first);
+            ::std::construct_at(values + out, element.second);
+        }
+        ::mcpprt::instrument::on_relocate(self.site_, self.size_ * (sizeof(Key) + sizeof(T)));
+
+        self.release();
+        ::mcpprt::instrument::on_reallocate(self.site_);
+        ::mcpprt::instrument::on_grow(self.site_, capacity);
+        self.keys_ = keys;
+        self.values_ = values;
+        self.size_ = out;
+        self.capacity_ = capacity;
+    }
+
+    /**
+     * @return the number of elements removed, 0 or 1
+     */
+    constexpr auto erase(this flat_map& self, Key const& key) noexcept -> size_type {
+        auto pos = ::mcpprt::container::details::lower_rank(self.keys_, self.size_, key, self.comp_);
+        if (pos == self.size_ || self.comp_(key, self.keys_[pos])) {
+            return 0;
+        }
+        ::mcpprt::container::details::shift_close(self.keys_, self.size_, pos);
+        ::mcpprt::container::details::shift_close(self.values_, self.size_, pos);
+        --self.size_;
+        return 1;
+    }
+
+    /**
+     * @note keeps the capacity
+     */
+    constexpr void clear(this flat_map& self) noexcept {
+        ::std::destroy(self.keys_, self.keys_ + self.size_);
+        ::std::destroy(self.values_, self.values_ + self.size_);
+        self.size_ = 0;
+    }
+
+private:
+    template<typename K, typename... Args>
+    constexpr auto insert_at(this flat_map& self, size_type pos, K&& key, Args&&... args) noexcept
+        -> ::std::pair<iterator, bool> {
+        ::mcpprt::container::details::shift_open(self.keys_, self.size_, pos);
+        ::std::construct_at(self.keys_ + pos, ::std::forward<K>(key));
+        ::mcpprt::container::details::shift_open(self.values_, self.size_, pos);
+        ::std::construct_at(self.values_ + pos, ::std::forward<Args>(args)...);
+        ::mcpprt::instrument::on_relocate(self.site_, (self.size_ - pos) * (sizeof(Key) + sizeof(T)));
+        ++self.size_;
+        return {self.begin() + static_cast<difference_type>(pos), true};
+    }
+
+    constexpr void reallocate(this flat_map& self, size_type capacity) noexcept {
+        key_allocator key_alloc{self.alloc_};
+        mapped_allocator mapped_alloc{self.alloc_};
+        auto* keys = ::std::allocator_traits<key_allocator>::allocate(key_alloc, capacity);
+        auto* values = ::std::allocator_traits<mapped_allocator>::allocate(mapped_alloc, capacity);
+        ::mcpprt::instrument::on_allocate(self.site_, capacity * (sizeof(Key) + sizeof(T)));
+        ::mcpprt::container::details::move_out(self.keys_, self.size_, keys);
+        ::mcpprt::container::details::move_out(self.values_, self.size_, values);
+        ::mcpprt::instrument::on_relocate(self.site_, self.size_ * (sizeof(Key) + sizeof(T)));
+
+        auto size = self.size_;
+        self.size_ = 0;
+        self.release();
+        ::mcpprt::instrument::on_reallocate(self.site_);
+        ::mcpprt::instrument::on_grow(self.site_, capacity);
+        self.keys_ = keys;
+        self.values_ = values;
+        self.size_ = size;
+        self.capacity_ = capacity;
+    }
+
+    /**
+     * @brief destroy the elements and free the storage
+     */
+    constexpr void release(this flat_map& self) noexcept {
+        self.clear();
+        if (self.keys_ != nullptr) {
+            key_allocator key_alloc{self.alloc_};
+            mapped_allocator mapped_alloc{self.alloc_};
+            ::std::allocator_traits<key_allocator>::deallocate(key_alloc, self.keys_, self.capacity_);
+            ::std::allocator_traits<mapped_allocator>::deallocate(mapped_alloc, self.values_, self.capacity_);
+            ::mcpprt::instrument::on_deallocate(self.site_, self.capacity_ * (sizeof(Key) + sizeof(T)));
+        }
+        self.keys_ = nullptr;
+        self.values_ = nullptr;
+        self.capacity_ = 0;
+    }
+};
+
+} // namespace mcpprt::container
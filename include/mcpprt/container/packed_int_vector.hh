@@ -0,0 +1,607 @@
+#pragma once
+
+/**
+ * @file packed_int_vector.hh
+ * @brief append-only vector of unsigned integers compressed in blocks of 128
+ * @details every full block is bit-packed with the fewest bits that hold it, either as offsets from the block
+ *          minimum (frame of reference) or, for non-decreasing blocks whose gaps are smaller, as gaps from the
+ *          previous value (delta). A header per block records the encoding and where its bits start, so an
+ *          element is found without looking at other blocks. Values not yet filling a block are kept as they are.
+ *          Blocks are unpacked by an AVX2 gather kernel when available, by unaligned 64-bit loads otherwise.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <exception/exception.hh>
+#include "../instrument/counters.hh"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+namespace mcpprt::container {
+
+namespace details {
+
+template<typename T>
+struct packed_block {
+    /**
+     * @brief the minimum of the block for frame of reference, its first value for delta
+     */
+    T reference_;
+    /**
+     * @brief the word the bits of the block start at
+     */
+    ::std::size_t offset_;
+    ::std::uint8_t width_;
+    bool delta_;
+};
+
+[[nodiscard]]
+constexpr auto packed_mask(unsigned width) noexcept -> ::std::uint64_t {
+    return width == 64 ? ~::std::uint64_t{} : (::std::uint64_t{1} << width) - 1;
+}
+
+/**
+ * @brief the `width` bits starting at bit `bit`
+ */
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+[[msvc::forceinline]]
+#endif
+[[nodiscard]]
+inline auto packed_extract(::std::uint64_t const* words, ::std::size_t bit, unsigned width) noexcept
+    -> ::std::uint64_t {
+    auto shift = bit & 63;
+    auto value = words[bit >> 6] >> shift;
+    if (shift + width > 64) {
+        value |= words[(bit >> 6) + 1] << (64 - shift);
+    }
+    return value & ::mcpprt::container::details::packed_mask(width);
+}
+
+/**
+ * @note the bits are or-ed in, they must be zero before
+ */
+inline void packed_store(::std::uint64_t* words, ::std::size_t bit, unsigned width, ::std::uint64_t value) noexcept {
+    if (width == 0) {
+        return;
+    }
+    auto shift = bit & 63;
+    words[bit >> 6] |= value << shift;
+    if (shift + width > 64) {
+        words[(bit >> 6) + 1] |= value >> (64 - shift);
+    }
+}
+
+/**
+ * @brief `out[i] = reference + value i` for the first `count` values packed at `words`
+ * @note reads up to 8 bytes past the packed bits, the vector keeps a spare word after the last block
+ */
+template<typename T>
+inline void packed_unpack(::std::uint64_t const* words, unsigned width, ::std::size_t count, T reference,
+                          T* out) noexcept {
+    ::std::size_t i{};
+    auto const mask = ::mcpprt::container::details::packed_mask(width);
+    if (width == 0) {
+        ::std::fill(out, out + count, reference);
+        return;
+    }
+    if constexpr (::std::endian::native == ::std::endian::little) {
+        // a value never spans more than the 8 bytes from the one holding its first bit
+        if (width <= 56) {
+            auto const* bytes = reinterpret_cast<unsigned char const*>(words);
+#if defined(__AVX2__)
+            if constexpr (sizeof(T) >= 4) {
+                auto const lane_mask = _mm256_set1_epi64x(static_cast<long long>(mask));
+                auto const base = _mm256_set1_epi64x(static_cast<long long>(reference));
+                auto const step = _mm256_set1_epi64x(static_cast<long long>(4 * width));
+                auto const low_bits = _mm256_set1_epi64x(7);
+                auto bits = _mm256_setr_epi64x(0, width, 2 * width, 3 * width);
+                for (auto const whole = count & ~::std::size_t{3}; i != whole; i += 4) {
+                    auto value = _mm256_i64gather_epi64(reinterpret_cast<long long const*>(bytes),
+                                                        _mm256_srli_epi64(bits, 3), 1);
+                    value = _mm256_and_si256(_mm256_srlv_epi64(value, _mm256_and_si256(bits, low_bits)), lane_mask);
+                    value = _mm256_add_epi64(value, base);
+                    if constexpr (sizeof(T) == 8) {
+                        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), value);
+                    } else {
+                        // the low halves of the four lanes
+                        auto low = _mm256_permutevar8x32_epi32(value, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_castsi256_si128(low));
+                    }
+                    bits = _mm256_add_epi64(bits, step);
+                }
+            }
+#endif
+            for (; i < count; ++i) {
+                auto bit = i * width;
+                ::std::uint64_t value;
+                ::std::memcpy(&value, bytes + (bit >> 3), sizeof(value));
+                out[i] = static_cast<T>(reference + ((value >> (bit & 7)) & mask));
+            }
+            return;
+        }
+    }
+    for (; i < count; ++i) {
+        out[i] = static_cast<T>(reference + ::mcpprt::container::details::packed_extract(words, i * width, width));
+    }
+}
+
+} // namespace details
+
+/**
+ * @brief read-optimized vector of unsigned integers, for sorted ids and small-range columns
+ * @note elements are values, not objects: there are no references to them and no way to modify them other
+ *       than appending
+ * @note random access reads one block header and unpacks one value, or sums the gaps from the start of a delta
+ *       block, at most `block_size` of them
+ */
+template<::std::unsigned_integral T = ::std::uint64_t, typename Allocator = ::std::allocator<T>>
+class packed_int_vector {
+public:
+    static constexpr ::std::size_t block_size = 128;
+
+private:
+    static constexpr ::std::size_t block_shift = 7;
+    static constexpr ::std::size_t block_mask = block_size - 1;
+
+    using block_type = ::mcpprt::container::details::packed_block<T>;
+    using word_allocator = typename ::std::allocator_traits<Allocator>::template rebind_alloc<::std::uint64_t>;
+    using block_allocator = typename ::std::allocator_traits<Allocator>::template rebind_alloc<block_type>;
+
+public:
+    /**
+     * @brief random-access iterator over the values, each dereference is a random access into the vector
+     * @note `for_each` unpacks a block at a time and is the faster way to scan
+     */
+    class const_iterator {
+        friend class packed_int_vector;
+
+        packed_int_vector const* owner_{};
+        ::std::size_t index_{};
+
+        const_iterator(packed_int_vector const* owner, ::std::size_t index) noexcept : owner_{owner}, index_{index} {
+        }
+
+    public:
+        using iterator_concept = ::std::random_access_iterator_tag;
+        // dereferencing yields a value, as for `iota_view`
+        using iterator_category = ::std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = ::std::ptrdiff_t;
+        using reference = T;
+
+        const_iterator() noexcept = default;
+
+        [[nodiscard]]
+        auto operator*(this const_iterator const& self) noexcept -> T {
+            return (*self.owner_)[self.index_];
+        }
+
+        [[nodiscard]]
+        auto operator[](this const_iterator const& self, difference_type n) noexcept -> T {
+            return (*self.owner_)[self.index_ + static_cast<::std::size_t>(n)];
+        }
+
+        auto&& operator+=(this const_iterator& self, difference_type n) noexcept {
+            self.index_ += static_cast<::std::size_t>(n);
+            return self;
+        }
+
+        auto&& operator-=(this const_iterator& self, difference_type n) noexcept {
+            self.index_ -= static_cast<::std::size_t>(n);
+            return self;
+        }
+
+        auto&& operator++(this const_iterator& self) noexcept {
+            ++self.index_;
+            return self;
+        }
+
+        auto operator++(this const_iterator& self, int) noexcept -> const_iterator {
+            auto result = self;
+            ++self.index_;
+            return result;
+        }
+
+        auto&& operator--(this const_iterator& self) noexcept {
+            --self.index_;
+            return self;
+        }
+
+        auto operator--(this const_iterator& self, int) noexcept -> const_iterator {
+            auto result = self;
+            --self.index_;
+            return result;
+        }
+
+        [[nodiscard]]
+        auto operator+(this const_iterator const& self, difference_type n) noexcept -> const_iterator {
+            auto result = self;
+            return result += n;
+        }
+
+        [[nodiscard]]
+        friend auto operator+(difference_type n, const_iterator const& self) noexcept -> const_iterator {
+            return self + n;
+        }
+
+        [[nodiscard]]
+        auto operator-(this const_iterator const& self, difference_type n) noexcept -> const_iterator {
+            auto result = self;
+            return result -= n;
+        }
+
+        [[nodiscard]]
+        auto operator-(this const_iterator const& self, const_iterator const& other) noexcept -> difference_type {
+            return static_cast<difference_type>(self.index_ - other.index_);
+        }
+
+        [[nodiscard]]
+        bool operator==(this const_iterator const& self, const_iterator const& other) noexcept {
+            return self.index_ == other.index_;
+        }
+
+        [[nodiscard]]
+        auto operator<=>(this const_iterator const& self, const_iterator const& other) noexcept {
+            return self.index_ <=> other.index_;
+        }
+    };
+
+    using value_type = T;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+    using allocator_type = Allocator;
+    using iterator = const_iterator;
+
+private:
+    ::std::uint64_t* words_{};
+    // one word past the bits of the last block is always allocated, for the unaligned loads of the kernels
+    size_type word_count_{};
+    size_type word_capacity_{};
+    block_type* blocks_{};
+    size_type block_count_{};
+    size_type block_capacity_{};
+    // the values after the last full block
+    T tail_[block_size];
+    size_type tail_size_{};
+    [[no_unique_address]] Allocator alloc_{};
+    [[no_unique_address]] ::mcpprt::instrument::site site_{};
+
+public:
+    explicit packed_int_vector(
+        ::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : site_{::mcpprt::instrument::make_site("packed_int_vector", where)} {
+    }
+
+    explicit packed_int_vector(
+        Allocator const& alloc,
+        ::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : alloc_{alloc}, site_{::mcpprt::instrument::make_site("packed_int_vector", where)} {
+    }
+
+    packed_int_vector(packed_int_vector const& other) noexcept
+        : tail_size_{other.tail_size_}, alloc_{other.alloc_}, site_{other.site_} {
+        this->copy_from(other);
+    }
+
+    packed_int_vector(packed_int_vector&& other) noexcept
+        : words_{::std::exchange(other.words_, nullptr)}, word_count_{::std::exchange(other.word_count_, 0)},
+          word_capacity_{::std::exchange(other.word_capacity_, 0)}, blocks_{::std::exchange(other.blocks_, nullptr)},
+          block_count_{::std::exchange(other.block_count_, 0)},
+          block_capacity_{::std::exchange(other.block_capacity_, 0)}, tail_size_{::std::exchange(other.tail_size_, 0)},
+          alloc_{other.alloc_}, site_{other.site_} {
+        ::std::copy(other.tail_, other.tail_ + tail_size_, tail_);
+    }
+
+    auto&& operator=(this packed_int_vector& self, packed_int_vector const& other) noexcept {
+        if (&self != &other) {
+            self.release();
+            self.tail_size_ = other.tail_size_;
+            self.copy_from(other);
+        }
+        return self;
+    }
+
+    auto&& operator=(this packed_int_vector& self, packed_int_vector&& other) noexcept {
+        if (&self != &other) {
+            self.release();
+            self.words_ = ::std::exchange(other.words_, nullptr);
+            self.word_count_ = ::std::exchange(other.word_count_, 0);
+            self.word_capacity_ = ::std::exchange(other.word_capacity_, 0);
+            self.blocks_ = ::std::exchange(other.blocks_, nullptr);
+            self.block_count_ = ::std::exchange(other.block_count_, 0);
+            self.block_capacity_ = ::std::exchange(other.block_capacity_, 0);
+            self.tail_size_ = ::std::exchange(other.tail_size_, 0);
+            ::std::copy(other.tail_, other.tail_ + self.tail_size_, self.tail_);
+            self.alloc_ = other.alloc_;
+        }
+        return self;
+    }
+
+    ~packed_int_vector() noexcept {
+        this->release();
+    }
+
+    [[nodiscard]]
+    auto size(this packed_int_vector const& self) noexcept -> size_type {
+        return (self.block_count_ << block_shift) + self.tail_size_;
+    }
+
+    [[nodiscard]]
+    bool empty(this packed_int_vector const& self) noexcept {
+        return self.size() == 0;
+    }
+
+    /**
+     * @brief number of blocks, the last one is not full when the size is not a multiple of `block_size`
+     */
+    [[nodiscard]]
+    auto block_count(this packed_int_vector const& self) noexcept -> size_type {
+        return self.block_count_ + (self.tail_size_ != 0);
+    }
+
+    /**
+     * @brief bytes taken by the packed bits, the block headers and the values not in a full block yet
+     */
+    [[nodiscard]]
+    auto compressed_bytes(this packed_int_vector const& self) noexcept -> size_type {
+        return self.word_count_ * sizeof(::std::uint64_t) + self.block_count_ * sizeof(block_type) +
+               self.tail_size_ * sizeof(T);
+    }
+
+    [[nodiscard]]
+    auto begin(this packed_int_vector const& self) noexcept -> const_iterator {
+        return const_iterator{&self, 0};
+    }
+
+    [[nodiscard]]
+    auto end(this packed_int_vector const& self) noexcept -> const_iterator {
+        return const_iterator{&self, self.size()};
+    }
+
+    template<bool ndebug = false>
+    [[nodiscard]]
+    auto operator[](this packed_int_vector const& self, size_type index) noexcept -> T {
+        ::exception::assert_true<ndebug>(index < self.size());
+        auto block_index = index >> block_shift;
+        auto offset = index & block_mask;
+        if (block_index == self.block_count_) {
+            return self.tail_[offset];
+        }
+        auto const& block = self.blocks_[block_index];
+        auto const* words = self.words_ + block.offset_;
+        unsigned width = block.width_;
+        if (!block.delta_) {
+            return static_cast<T>(block.reference_ +
+                                  ::mcpprt::container::details::packed_extract(words, offset * width, width));
+        }
+        T value = block.reference_;
+        for (size_type i{1}; i <= offset; ++i) {
+            value += static_cast<T>(::mcpprt::container::details::packed_extract(words, i * width, width));
+        }
+        return value;
+    }
+
+    [[nodiscard]]
+    auto at(this packed_int_vector const& self, size_type index) noexcept -> T {
+        return self.template operator[]<false>(index);
+    }
+
+    template<bool ndebug = false>
+    [[nodiscard]]
+    auto front(this packed_int_vector const& self) noexcept -> T {
+        ::exception::assert_true<ndebug>(!self.empty());
+        return self.template operator[]<true>(0);
+    }
+
+    template<bool ndebug = false>
+    [[nodiscard]]
+    auto back(this packed_int_vector const& self) noexcept -> T {
+        ::exception::assert_true<ndebug>(!self.empty());
+        return self.template operator[]<true>(self.size() - 1);
+    }
+
+    /**
+     * @brief unpack block `index` into `out`, which has room for `block_size` values
+     * @return the number of values of the block
+     */
+    auto decode_block(this packed_int_vector const& self, size_type index, T* out) noexcept -> size_type {
+        ::exception::assert_true(index < self.block_count());
+        if (index == self.block_count_) {
+            ::std::copy(self.tail_, self.tail_ + self.tail_size_, out);
+            return self.tail_size_;
+        }
+        auto const& block = self.blocks_[index];
+        auto const* words = self.words_ + block.offset_;
+        if (!block.delta_) {
+            ::mcpprt::container::details::packed_unpack(words, block.width_, block_size, block.reference_, out);
+            return block_size;
+        }
+        ::mcpprt::container::details::packed_unpack(words, block.width_, block_size, T{}, out);
+        // the first gap is 0, so the sum starts at the first value
+        T value = block.reference_;
+        for (size_type i{}; i < block_size; ++i) {
+            value += out[i];
+            out[i] = value;
+        }
+        return block_size;
+    }
+
+    /**
+     * @brief call `func` with the values in order, one unpacked block at a time
+     */
+    template<typename Func>
+        requires (::std::invocable<Func&, T>)
+    void for_each(this packed_int_vector const& self, Func&& func) noexcept {
+        T buffer[block_size];
+        for (size_type block{}; block < self.block_count(); ++block) {
+            auto count = self.decode_block(block, buffer);
+            for (size_type i{}; i < count; ++i) {
+                func(buffer[i]);
+            }
+        }
+    }
+
+    void push_back(this packed_int_vector& self, T value) noexcept {
+        self.tail_[self.tail_size_++] = value;
+        if (self.tail_size_ == block_size) {
+            self.seal();
+        }
+    }
+
+    void append(this packed_int_vector& self, T const* first, size_type count) noexcept {
+        while (count != 0) {
+            auto n = ::std::min(count, block_size - self.tail_size_);
+            ::std::copy(first, first + n, self.tail_ + self.tail_size_);
+            self.tail_size_ += n;
+            first += n;
+            count -= n;
+            if (self.tail_size_ == block_size) {
+                self.seal();
+            }
+        }
+    }
+
+    /**
+     * @note the memory stays with the vector until `shrink_to_fit`
+     */
+    void clear(this packed_int_vector& self) noexcept {
+        self.word_count_ = 0;
+        self.block_count_ = 0;
+        self.tail_size_ = 0;
+    }
+
+    void shrink_to_fit(this packed_int_vector& self) noexcept {
+        if (self.block_count_ == 0) {
+            self.deallocate();
+            return;
+        }
+        self.reallocate_words(self.word_count_ + 1);
+        self.reallocate_blocks(self.block_count_);
+    }
+
+private:
+    /**
+     * @brief compress the full tail into a new block
+     */
+    void seal(this packed_int_vector& self) noexcept {
+        auto const* values = self.tail_;
+        T low = values[0];
+        T high = values[0];
+        T max_gap{};
+        bool sorted{true};
+        for (size_type i{1}; i < block_size; ++i) {
+            low = ::std::min(low, values[i]);
+            high = ::std::max(high, values[i]);
+            if (values[i] < values[i - 1]) {
+                sorted = false;
+            } else {
+                max_gap = ::std::max(max_gap, static_cast<T>(values[i] - values[i - 1]));
+            }
+        }
+        auto range_width = static_cast<unsigned>(::std::bit_width(static_cast<::std::uint64_t>(high - low)));
+        auto gap_width = static_cast<unsigned>(::std::bit_width(static_cast<::std::uint64_t>(max_gap)));
+        bool delta = sorted && gap_width < range_width;
+        auto width = delta ? gap_width : range_width;
+        auto words = (block_size * width + 63) / 64;
+
+        if (self.word_capacity_ < self.word_count_ + words + 1) {
+            self.reallocate_words(::std::max({self.word_count_ + words + 1, 2 * self.word_capacity_, size_type{64}}));
+        }
+        if (self.block_capacity_ == self.block_count_) {
+            self.reallocate_blocks(::std::max(2 * self.block_capacity_, size_type{8}));
+        }
+
+        auto* out = self.words_ + self.word_count_;
+        ::std::fill(out, out + words + 1, ::std::uint64_t{});
+        for (size_type i{}; i < block_size; ++i) {
+            auto value = delta ? (i == 0 ? T{} : static_cast<T>(values[i] - values[i - 1]))
+                               : static_cast<T>(values[i] - low);
+            ::mcpprt::container::details::packed_store(out, i * width, width, value);
+        }
+        self.blocks_[self.block_count_++] =
+            block_type{delta ? values[0] : low, self.word_count_, static_cast<::std::uint8_t>(width), delta};
+        self.word_count_ += words;
+        self.tail_size_ = 0;
+    }
+
+    void reallocate_words(this packed_int_vector& self, size_type capacity) noexcept {
+        word_allocator alloc{self.alloc_};
+        auto* words = ::std::allocator_traits<word_allocator>::allocate(alloc, capacity);
+        ::mcpprt::instrument::on_allocate(self.site_, capacity * sizeof(::std::uint64_t));
+        if (self.words_ != nullptr) {
+            ::std::copy(self.words_, self.words_ + self.word_count_ + 1, words);
+            ::std::allocator_traits<word_allocator>::deallocate(alloc, self.words_, self.word_capacity_);
+            ::mcpprt::instrument::on_deallocate(self.site_, self.word_capacity_ * sizeof(::std::uint64_t));
+            ::mcpprt::instrument::on_reallocate(self.site_);
+        }
+        ::mcpprt::instrument::on_grow(self.site_, capacity);
+        self.words_ = words;
+        self.word_capacity_ = capacity;
+    }
+
+    void reallocate_blocks(this packed_int_vector& self, size_type capacity) noexcept {
+        block_allocator alloc{self.alloc_};
+        auto* blocks = ::std::allocator_traits<block_allocator>::allocate(alloc, capacity);
+        ::mcpprt::instrument::on_allocate(self.site_, capacity * sizeof(block_type));
+        if (self.blocks_ != nullptr) {
+            ::std::copy(self.blocks_, self.blocks_ + self.block_count_, blocks);
+            ::std::allocator_traits<block_allocator>::deallocate(alloc, self.blocks_, self.block_capacity_);
+            ::mcpprt::instrument::on_deallocate(self.site_, self.block_capacity_ * sizeof(block_type));
+            ::mcpprt::instrument::on_reallocate(self.site_);
+        }
+        self.blocks_ = blocks;
+        self.block_capacity_ = capacity;
+    }
+
+    void copy_from(this packed_int_vector& self, packed_int_vector const& other) noexcept {
+        ::std::copy(other.tail_, other.tail_ + other.tail_size_, self.tail_);
+        if (other.block_count_ == 0) {
+            return;
+        }
+        self.word_count_ = other.word_count_;
+        self.block_count_ = other.block_count_;
+        self.reallocate_words(other.word_count_ + 1);
+        ::std::copy(other.words_, other.words_ + other.word_count_ + 1, self.words_);
+        self.reallocate_blocks(other.block_count_);
+        ::std::copy(other.blocks_, other.blocks_ + other.block_count_, self.blocks_);
+    }
+
+    void deallocate(this packed_int_vector& self) noexcept {
+        if (self.words_ != nullptr) {
+            word_allocator alloc{self.alloc_};
+            ::std::allocator_traits<word_allocator>::deallocate(alloc, self.words_, self.word_capacity_);
+            ::mcpprt::instrument::on_deallocate(self.site_, self.word_capacity_ * sizeof(::std::uint64_t));
+        }
+        if (self.blocks_ != nullptr) {
+            block_allocator alloc{self.alloc_};
+            ::std::allocator_traits<block_allocator>::deallocate(alloc, self.blocks_, self.block_capacity_);
+            ::mcpprt::instrument::on_deallocate(self.site_, self.block_capacity_ * sizeof(block_type));
+        }
+        self.words_ = nullptr;
+        self.word_capacity_ = 0;
+        self.blocks_ = nullptr;
+        self.block_capacity_ = 0;
+        self.word_count_ = 0;
+        self.block_count_ = 0;
+    }
+
+    void release(this packed_int_vector& self) noexcept {
+        self.deallocate();
+        self.tail_size_ = 0;
+    }
+};
+
+} // namespace mcpprt::container
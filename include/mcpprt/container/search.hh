@@ -0,0 +1,166 @@
+#pragma once
+
+/**
+ * @file search.hh
+ * @brief rank queries over small and large sorted key arrays, shared by the ordered containers
+ * @details a node of a B+-tree holds a few cache lines of keys, counting the keys below the probe over the
+ *          whole node has no unpredictable branch and maps to SIMD compares for integer keys, large arrays
+ *          use a binary search whose loop body is a conditional move
+ */
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <immintrin.h>
+#endif
+
+namespace mcpprt::container::details {
+
+/**
+ * @brief keys whose order under `Compare` is the order of their integer value
+ */
+template<typename Key, typename Compare>
+concept is_simd_rankable =
+    ::std::integral<Key> && (sizeof(Key) == 4 || sizeof(Key) == 8) &&
+    (::std::same_as<Compare, ::std::less<Key>> || ::std::same_as<Compare, ::std::less<>>);
+
+#if defined(__SSE2__) || defined(_M_X64)
+
+/**
+ * @brief number of keys in [keys, keys + size) for which `Greater ? key < keys[i] : keys[i] < key`
+ */
+template<bool Greater, typename Key>
+[[nodiscard]]
+inline auto simd_count(Key const* keys, ::std::size_t size, Key key) noexcept -> ::std::size_t {
+    ::std::size_t count{};
+    ::std::size_t i{};
+    if constexpr (sizeof(Key) == 4) {
+        // SSE2 only has signed compares, flipping the sign bit orders unsigned keys the same way
+        constexpr ::std::int32_t bias = ::std::is_signed_v<Key> ? 0 : static_cast<::std::int32_t>(0x80000000u);
+        auto const probe = _mm_set1_epi32(static_cast<::std::int32_t>(key) ^ bias);
+        auto const flip = _mm_set1_epi32(bias);
+        for (; i + 4 <= size; i += 4) {
+            auto v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(keys + i)), flip);
+            auto mask = Greater ? _mm_cmpgt_epi32(v, probe) : _mm_cmpgt_epi32(probe, v);
+            count += static_cast<::std::size_t>(
+                ::std::popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(mask)))));
+        }
+    }
+    #if defined(__AVX2__)
+    else {
+        constexpr ::std::int64_t bias =
+            ::std::is_signed_v<Key> ? 0 : static_cast<::std::int64_t>(0x8000000000000000ull);
+        auto const probe = _mm256_set1_epi64x(static_cast<::std::int64_t>(key) ^ bias);
+        auto const flip = _mm256_set1_epi64x(bias);
+        for (; i + 4 <= size; i += 4) {
+            auto v = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(keys + i)), flip);
+            auto mask = Greater ? _mm256_cmpgt_epi64(v, probe) : _mm256_cmpgt_epi64(probe, v);
+            count += static_cast<::std::size_t>(
+                ::std::popcount(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(mask)))));
+        }
+    }
+    #endif
+    for (; i < size; ++i) {
+        count += Greater ? key < keys[i] : keys[i] < key;
+    }
+    return count;
+}
+
+#endif
+
+/**
+ * @brief the index of the first key not less than `key`, for the few keys of one node
+ */
+template<typename Key, typename Compare>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+[[msvc::forceinline]]
+#endif
+[[nodiscard]]
+constexpr auto node_lower_rank(Key const* keys, ::std::size_t size, Key const& key,
+                               Compare const& comp) noexcept -> ::std::size_t {
+#if defined(__SSE2__) || defined(_M_X64)
+    if constexpr (::mcpprt::container::details::is_simd_rankable<Key, Compare>) {
+        if !consteval {
+            return ::mcpprt::container::details::simd_count<false>(keys, size, key);
+        }
+    }
+#endif
+    ::std::size_t count{};
+    for (::std::size_t i{}; i < size; ++i) {
+        count += static_cast<bool>(comp(keys[i], key));
+    }
+    return count;
+}
+
+/**
+ * @brief the index of the first key greater than `key`, for the few keys of one node
+ */
+template<typename Key, typename Compare>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+[[msvc::forceinline]]
+#endif
+[[nodiscard]]
+constexpr auto node_upper_rank(Key const* keys, ::std::size_t size, Key const& key,
+                               Compare const& comp) noexcept -> ::std::size_t {
+#if defined(__SSE2__) || defined(_M_X64)
+    if constexpr (::mcpprt::container::details::is_simd_rankable<Key, Compare>) {
+        if !consteval {
+            return size - ::mcpprt::container::details::simd_count<true>(keys, size, key);
+        }
+    }
+#endif
+    ::std::size_t count{};
+    for (::std::size_t i{}; i < size; ++i) {
+        count += !static_cast<bool>(comp(key, keys[i]));
+    }
+    return count;
+}
+
+/**
+ * @brief `std::lower_bound` whose loop carries no branch on the comparison
+ */
+template<typename Key, typename Compare>
+[[nodiscard]]
+constexpr auto lower_rank(Key const* keys, ::std::size_t size, Key const& key,
+                          Compare const& comp) noexcept -> ::std::size_t {
+    if (size == 0) {
+        return 0;
+    }
+    auto const* base = keys;
+    while (size > 1) {
+        auto half = size / 2;
+        base = comp(base[half], key) ? base + half : base;
+        size -= half;
+    }
+    return static_cast<::std::size_t>(base - keys) + static_cast<bool>(comp(*base, key));
+}
+
+/**
+ * @brief `std::upper_bound` whose loop carries no branch on the comparison
+ */
+template<typename Key, typename Compare>
+[[nodiscard]]
+constexpr auto upper_rank(Key const* keys, ::std::size_t size, Key const& key,
+                          Compare const& comp) noexcept -> ::std::size_t {
+    if (size == 0) {
+        return 0;
+    }
+    auto const* base = keys;
+    while (size > 1) {
+        auto half = size / 2;
+        base = comp(key, base[half]) ? base : base + half;
+        size -= half;
+    }
+    return static_cast<::std::size_t>(base - keys) + !static_cast<bool>(comp(key, *base));
+}
+
+} // namespace mcpprt::container::details
@@ -0,0 +1,565 @@
+#pragma once
+
+/**
+ * @file slot_map.hh
+ * @brief dense object pool addressed by generational handles
+ * @details values live contiguously in insertion order up to swap-remove, a handle names a slot that records
+ *          where its value currently is. Erasing bumps the generation of the slot, so handles to erased values
+ *          are told apart from handles to whatever reuses the slot later.
+ */
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <exception/exception.hh>
+#include "../instrument/counters.hh"
+#include "array.hh"
+#include "uninitialized.hh"
+
+namespace mcpprt::container {
+
+/**
+ * @brief names one value of a slot map, stays valid until that value is erased
+ * @note a default constructed handle never refers to a value
+ */
+struct slot_handle {
+    ::std::uint32_t index_{::std::numeric_limits<::std::uint32_t>::max()};
+    ::std::uint32_t generation_{};
+
+    [[nodiscard]]
+    constexpr bool operator==(this slot_handle const& self, slot_handle const& other) noexcept {
+        return self.index_ == other.index_ && self.generation_ == other.generation_;
+    }
+};
+
+namespace details {
+
+inline constexpr ::std::uint32_t slot_npos = ::std::numeric_limits<::std::uint32_t>::max();
+
+/**
+ * @brief `index_` is the position of the value while the slot is live, the next free slot otherwise
+ */
+struct slot {
+    ::std::uint32_t index_;
+    ::std::uint32_t generation_;
+};
+
+/**
+ * @brief the position of the value `handle` refers to, `slot_npos` if it was erased
+ */
+[[nodiscard]]
+constexpr auto slot_find(::mcpprt::container::details::slot const* slots, ::std::uint32_t slot_count,
+                         ::mcpprt::container::slot_handle handle) noexcept -> ::std::uint32_t {
+    if (handle.index_ >= slot_count || slots[handle.index_].generation_ != handle.generation_) {
+        return ::mcpprt::container::details::slot_npos;
+    }
+    return slots[handle.index_].index_;
+}
+
+/**
+ * @brief take a free slot, or the next unused one, and point it at position `index`
+ * @note the caller makes sure `slot_count` is below the capacity when no slot is free
+ */
+constexpr auto slot_acquire(::mcpprt::container::details::slot* slots, ::std::uint32_t& slot_count,
+                            ::std::uint32_t& free, ::std::uint32_t index) noexcept -> ::mcpprt::container::slot_handle {
+    ::std::uint32_t slot_index;
+    if (free != ::mcpprt::container::details::slot_npos) {
+        slot_index = free;
+        free = slots[slot_index].index_;
+    } else {
+        slot_index = slot_count++;
+        slots[slot_index].generation_ = 0;
+    }
+    slots[slot_index].index_ = index;
+    return ::mcpprt::container::slot_handle{slot_index, slots[slot_index].generation_};
+}
+
+/**
+ * @brief invalidate every handle to the slot and put it on the free list
+ * @note a slot whose generation would wrap around is retired instead, a stale handle can never match again
+ */
+constexpr void slot_release(::mcpprt::container::details::slot* slots, ::std::uint32_t& free,
+                            ::std::uint32_t slot_index) noexcept {
+    if (++slots[slot_index].generation_ == ::mcpprt::container::details::slot_npos) [[unlikely]] {
+        return;
+    }
+    slots[slot_index].index_ = free;
+    free = slot_index;
+}
+
+} // namespace details
+
+/**
+ * @brief pool of values with O(1) insert, erase and lookup by handle
+ * @details values are stored densely, iterating the map iterates a plain array. Erasing moves the last value
+ *          into the hole, so pointers and iterators into the values are invalidated but handles are not.
+ */
+template<typename T, typename Allocator = ::std::allocator<T>>
+class slot_map {
+public:
+    using value_type = T;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+    using handle_type = ::mcpprt::container::slot_handle;
+    using allocator_type = Allocator;
+    using iterator = T*;
+    using const_iterator = T const*;
+
+private:
+    using slot = ::mcpprt::container::details::slot;
+    using value_allocator = typename ::std::allocator_traits<Allocator>::template rebind_alloc<T>;
+    using index_allocator = typename ::std::allocator_traits<Allocator>::template rebind_alloc<::std::uint32_t>;
+    using slot_allocator = typename ::std::allocator_traits<Allocator>::template rebind_alloc<slot>;
+
+    static constexpr ::std::size_t element_bytes = sizeof(T) + sizeof(::std::uint32_t) + sizeof(slot);
+
+    T* values_{};
+    // the slot of every value, to fix up the slot of the value moved by swap-remove
+    ::std::uint32_t* owners_{};
+    slot* slots_{};
+    ::std::uint32_t size_{};
+    ::std::uint32_t slot_count_{};
+    ::std::uint32_t capacity_{};
+    ::std::uint32_t free_{::mcpprt::container::details::slot_npos};
+    [[no_unique_address]] Allocator alloc_{};
+    [[no_unique_address]] ::mcpprt::instrument::site site_{};
+
+public:
+    constexpr explicit slot_map(
+        ::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : site_{::mcpprt::instrument::make_site("slot_map", where)} {
+    }
+
+    constexpr explicit slot_map(
+        Allocator const& alloc,
+        ::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept
+        : alloc_{alloc}, site_{::mcpprt::instrument::make_site("slot_map", where)} {
+    }
+
+    /**
+     * @note handles of `other` are valid for the copy as well
+     */
+    constexpr slot_map(::mcpprt::container::slot_map<T, Allocator> const& other) noexcept
+        : alloc_{other.alloc_}, site_{other.site_} {
+        this->copy_from(other);
+    }
+
+    constexpr slot_map(::mcpprt::container::slot_map<T, Allocator>&& other) noexcept
+        : values_{::std::exchange(other.values_, nullptr)}, owners_{::std::exchange(other.owners_, nullptr)},
+          slots_{::std::exchange(other.slots_, nullptr)}, size_{::std::exchange(other.size_, 0)},
+          slot_count_{::std::exchange(other.slot_count_, 0)}, capacity_{::std::exchange(other.capacity_, 0)},
+          free_{::std::exchange(other.free_, ::mcpprt::container::details::slot_npos)}, alloc_{other.alloc_},
+          site_{other.site_} {
+    }
+
+    constexpr auto&& operator=(this slot_map& self, slot_map const& other) noexcept {
+        if (&self != &other) {
+            self.release();
+            self.copy_from(other);
+        }
+        return self;
+    }
+
+    constexpr auto&& operator=(this slot_map& self, slot_map&& other) noexcept {
+        if (&self != &other) {
+            self.release();
+            self.values_ = ::std::exchange(other.values_, nullptr);
+            self.owners_ = ::std::exchange(other.owners_, nullptr);
+            self.slots_ = ::std::exchange(other.slots_, nullptr);
+            self.size_ = ::std::exchange(other.size_, 0);
+            self.slot_count_ = ::std::exchange(other.slot_count_, 0);
+            self.capacity_ = ::std::exchange(other.capacity_, 0);
+            self.free_ = ::std::exchange(other.free_, ::mcpprt::container::details::slot_npos);
+            self.alloc_ = other.alloc_;
+        }
+        return self;
+    }
+
+    constexpr ~slot_map() noexcept {
+        this->release();
+    }
+
+    [[nodiscard]]
+    constexpr auto size(this slot_map const& self) noexcept -> size_type {
+        return self.size_;
+    }
+
+    [[nodiscard]]
+    constexpr bool empty(this slot_map const& self) noexcept {
+        return self.size_ == 0;
+    }
+
+    [[nodiscard]]
+    constexpr auto capacity(this slot_map const& self) noexcept -> size_type {
+        return self.capacity_;
+    }
+
+    [[nodiscard]]
+    constexpr auto begin(this slot_map& self) noexcept -> iterator {
+        return self.values_;
+    }
+
+    [[nodiscard]]
+    constexpr auto begin(this slot_map const& self) noexcept -> const_iterator {
+        return self.values_;
+    }
+
+    [[nodiscard]]
+    constexpr auto end(this slot_map& self) noexcept -> iterator {
+        return self.values_ + self.size_;
+    }
+
+    [[nodiscard]]
+    constexpr auto end(this slot_map const& self) noexcept -> const_iterator {
+        return self.values_ + self.size_;
+    }
+
+    /**
+     * @brief the handle of the value at position `index` of the dense storage
+     */
+    template<bool ndebug = false>
+    [[nodiscard]]
+    constexpr auto handle_at(this slot_map const& self, size_type index) noexcept -> handle_type {
+        ::exception::assert_true<ndebug>(index < self.size_);
+        auto owner = self.owners_[index];
+        return handle_type{owner, self.slots_[owner].generation_};
+    }
+
+    [[nodiscard]]
+    constexpr bool contains(this slot_map const& self, handle_type handle) noexcept {
+        return ::mcpprt::container::details::slot_find(self.slots_, self.slot_count_, handle) !=
+               ::mcpprt::container::details::slot_npos;
+    }
+
+    /**
+     * @brief the value `handle` refers to, nothing if it was erased
+     */
+    [[nodiscard]]
+    constexpr auto get(this slot_map& self, handle_type handle) noexcept -> ::exception::optional<T*> {
+        auto index = ::mcpprt::container::details::slot_find(self.slots_, self.slot_count_, handle);
+        if (index == ::mcpprt::container::details::slot_npos) {
+            return ::exception::nullopt_t{};
+        }
+        return self.values_ + index;
+    }
+
+    [[nodiscard]]
+    constexpr auto get(this slot_map const& self, handle_type handle) noexcept -> ::exception::optional<T const*> {
+        auto index = ::mcpprt::container::details::slot_find(self.slots_, self.slot_count_, handle);
+        if (index == ::mcpprt::container::details::slot_npos) {
+            return ::exception::nullopt_t{};
+        }
+        return self.values_ + index;
+    }
+
+    /**
+     * @brief the value `handle` refers to, which must not have been erased
+     */
+    template<bool ndebug = false>
+    [[nodiscard]]
+    constexpr auto&& at(this auto&& self, handle_type handle) noexcept {
+        auto index = ::mcpprt::container::details::slot_find(self.slots_, self.slot_count_, handle);
+        ::exception::assert_true<ndebug>(index != ::mcpprt::container::details::slot_npos);
+        return ::std::forward_like<decltype(self)>(self.values_[index]);
+    }
+
+    constexpr void reserve(this slot_map& self, size_type capacity) noexcept {
+        if (capacity > self.capacity_) {
+            self.reallocate(capacity);
+        }
+    }
+
+    /**
+     * @note `args` must not refer to values of the map, the storage may move
+     */
+    template<typename... Args>
+        requires (::std::constructible_from<T, Args && ...>)
+    constexpr auto emplace(this slot_map& self, Args&&... args) noexcept -> handle_type {
+        if (self.free_ == ::mcpprt::container::details::slot_npos && self.slot_count_ == self.capacity_) {
+            self.reallocate(self.capacity_ == 0 ? 8 : static_cast<size_type>(self.capacity_) * 2);
+        }
+        ::std::construct_at(self.values_ + self.size_, ::std::forward<Args>(args)...);
+        auto handle =
+            ::mcpprt::container::details::slot_acquire(self.slots_, self.slot_count_, self.free_, self.size_);
+        self.owners_[self.size_++] = handle.index_;
+        return handle;
+    }
+
+    constexpr auto insert(this slot_map& self, T const& value) noexcept -> handle_type {
+        return self.emplace(value);
+    }
+
+    constexpr auto insert(this slot_map& self, T&& value) noexcept -> handle_type {
+        return self.emplace(::std::move(value));
+    }
+
+    /**
+     * @brief move the last value into the place of the erased one
+     * @return whether `handle` referred to a value
+     */
+    constexpr bool erase(this slot_map& self, handle_type handle) noexcept {
+        auto index = ::mcpprt::container::details::slot_find(self.slots_, self.slot_count_, handle);
+        if (index == ::mcpprt::container::details::slot_npos) {
+            return false;
+        }
+        auto last = self.size_ - 1;
+        if (index != last) {
+            self.values_[index] = ::std::move(self.values_[last]);
+            self.owners_[index] = self.owners_[last];
+            self.slots_[self.owners_[index]].index_ = index;
+            ::mcpprt::instrument::on_relocate(self.site_, sizeof(T));
+        }
+        ::std::destroy_at(self.values_ + last);
+        self.size_ = last;
+        ::mcpprt::container::details::slot_release(self.slots_, self.free_, handle.index_);
+        return true;
+    }
+
+    /**
+     * @brief erase every value, all handles become stale
+     * @note keeps the capacity
+     */
+    constexpr void clear(this slot_map& self) noexcept {
+        for (::std::uint32_t i{}; i < self.size_; ++i) {
+            ::mcpprt::container::details::slot_release(self.slots_, self.free_, self.owners_[i]);
+        }
+        ::std::destroy(self.values_, self.values_ + self.size_);
+        self.size_ = 0;
+    }
+
+private:
+    constexpr void copy_from(this slot_map& self, slot_map const& other) noexcept {
+        if (other.capacity_ == 0) {
+            return;
+        }
+        self.reallocate(other.capacity_);
+        ::mcpprt::container::details::copy_out(other.values_, other.size_, self.values_);
+        ::std::copy(other.owners_, other.owners_ + other.size_, self.owners_);
+        ::std::copy(other.slots_, other.slots_ + other.slot_count_, self.slots_);
+        self.size_ = other.size_;
+        self.slot_count_ = other.slot_count_;
+        self.free_ = other.free_;
+    }
+
+    constexpr void reallocate(this slot_map& self, size_type capacity) noexcept {
+        // handles and positions are 32-bit, the last index is reserved for `slot_npos`
+        ::exception::assert_true(capacity < ::mcpprt::container::details::slot_npos);
+        value_allocator value_alloc{self.alloc_};
+        index_allocator index_alloc{self.alloc_};
+        slot_allocator slot_alloc{self.alloc_};
+        auto* values = ::std::allocator_traits<value_allocator>::allocate(value_alloc, capacity);
+        auto* owners = ::std::allocator_traits<index_allocator>::allocate(index_alloc, capacity);
+        auto* slots = ::std::allocator_traits<slot_allocator>::allocate(slot_alloc, capacity);
+        ::mcpprt::instrument::on_allocate(self.site_, capacity * element_bytes);
+        for (size_type i{}; i < capacity; ++i) {
+            ::std::construct_at(owners + i);
+            ::std::construct_at(slots + i);
+        }
+        ::mcpprt::container::details::move_out(self.values_, self.size_, values);
+        ::std::copy(self.owners_, self.owners_ + self.size_, owners);
+        ::std::copy(self.slots_, self.slots_ + self.slot_count_, slots);
+        ::mcpprt::instrument::on_relocate(self.site_, self.size_ * sizeof(T));
+
+        auto size = ::std::exchange(self.size_, 0);
+        auto slot_count = self.slot_count_;
+        auto free = self.free_;
+        self.release();
+        ::mcpprt::instrument::on_reallocate(self.site_);
+        ::mcpprt::instrument::on_grow(self.site_, capacity);
+        self.values_ = values;
+        self.owners_ = owners;
+        self.slots_ = slots;
+        self.size_ = size;
+        self.slot_count_ = slot_count;
+        self.capacity_ = static_cast<::std::uint32_t>(capacity);
+        self.free_ = free;
+    }
+
+    /**
+     * @brief destroy the values and free the storage, forgets every slot
+     */
+    constexpr void release(this slot_map& self) noexcept {
+        ::std::destroy(self.values_, self.values_ + self.size_);
+        if (self.values_ != nullptr) {
+            value_allocator value_alloc{self.alloc_};
+            index_allocator index_alloc{self.alloc_};
+            slot_allocator slot_alloc{self.alloc_};
+            ::std::allocator_traits<value_allocator>::deallocate(value_alloc, self.values_, self.capacity_);
+            ::std::allocator_traits<index_allocator>::deallocate(index_alloc, self.owners_, self.capacity_);
+            ::std::allocator_traits<slot_allocator>::deallocate(slot_alloc, self.slots_, self.capacity_);
+            ::mcpprt::instrument::on_deallocate(self.site_, self.capacity_ * element_bytes);
+        }
+        self.values_ = nullptr;
+        self.owners_ = nullptr;
+        self.slots_ = nullptr;
+        self.size_ = 0;
+        self.slot_count_ = 0;
+        self.capacity_ = 0;
+        self.free_ = ::mcpprt::container::details::slot_npos;
+    }
+};
+
+/**
+ * @brief slot map holding at most `N` values in place, never allocates
+ * @note every one of the `N` values is constructed up front, erased values are reset by assigning `T{}`
+ */
+template<typename T, ::std::size_t N>
+    requires (::std::default_initializable<T> && ::std::movable<T>)
+class static_slot_map {
+    static_assert(N < ::mcpprt::container::details::slot_npos, "N must fit the 32-bit handle index");
+
+public:
+    using value_type = T;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+    using handle_type = ::mcpprt::container::slot_handle;
+    using iterator = T*;
+    using const_iterator = T const*;
+
+private:
+    ::mcpprt::container::array<T, N> values_{};
+    ::mcpprt::container::array<::std::uint32_t, N> owners_{};
+    ::mcpprt::container::array<::mcpprt::container::details::slot, N> slots_{};
+    ::std::uint32_t size_{};
+    ::std::uint32_t slot_count_{};
+    ::std::uint32_t free_{::mcpprt::container::details::slot_npos};
+
+public:
+    [[nodiscard]]
+    constexpr auto size(this static_slot_map const& self) noexcept -> size_type {
+        return self.size_;
+    }
+
+    [[nodiscard]]
+    constexpr bool empty(this static_slot_map const& self) noexcept {
+        return self.size_ == 0;
+    }
+
+    [[nodiscard]]
+    constexpr bool full(this static_slot_map const& self) noexcept {
+        return self.size_ == N;
+    }
+
+    [[nodiscard]]
+    static constexpr auto capacity() noexcept -> size_type {
+        return N;
+    }
+
+    [[nodiscard]]
+    constexpr auto begin(this static_slot_map& self) noexcept -> iterator {
+        return self.values_.value_;
+    }
+
+    [[nodiscard]]
+    constexpr auto begin(this static_slot_map const& self) noexcept -> const_iterator {
+        return self.values_.value_;
+    }
+
+    [[nodiscard]]
+    constexpr auto end(this static_slot_map& self) noexcept -> iterator {
+        return self.values_.value_ + self.size_;
+    }
+
+    [[nodiscard]]
+    constexpr auto end(this static_slot_map const& self) noexcept -> const_iterator {
+        return self.values_.value_ + self.size_;
+    }
+
+    template<bool ndebug = false>
+    [[nodiscard]]
+    constexpr auto handle_at(this static_slot_map const& self, size_type index) noexcept -> handle_type {
+        ::exception::assert_true<ndebug>(index < self.size_);
+        auto owner = self.owners_.value_[index];
+        return handle_type{owner, self.slots_.value_[owner].generation_};
+    }
+
+    [[nodiscard]]
+    constexpr bool contains(this static_slot_map const& self, handle_type handle) noexcept {
+        return ::mcpprt::container::details::slot_find(self.slots_.value_, self.slot_count_, handle) !=
+               ::mcpprt::container::details::slot_npos;
+    }
+
+    [[nodiscard]]
+    constexpr auto get(this static_slot_map& self, handle_type handle) noexcept -> ::exception::optional<T*> {
+        auto index = ::mcpprt::container::details::slot_find(self.slots_.value_, self.slot_count_, handle);
+        if (index == ::mcpprt::container::details::slot_npos) {
+            return ::exception::nullopt_t{};
+        }
+        return self.values_.value_ + index;
+    }
+
+    [[nodiscard]]
+    constexpr auto get(this static_slot_map const& self, handle_type handle) noexcept
+        -> ::exception::optional<T const*> {
+        auto index = ::mcpprt::container::details::slot_find(self.slots_.value_, self.slot_count_, handle);
+        if (index == ::mcpprt::container::details::slot_npos) {
+            return ::exception::nullopt_t{};
+        }
+        return self.values_.value_ + index;
+    }
+
+    template<bool ndebug = false>
+    [[nodiscard]]
+    constexpr auto&& at(this auto&& self, handle_type handle) noexcept {
+        auto index = ::mcpprt::container::details::slot_find(self.slots_.value_, self.slot_count_, handle);
+        ::exception::assert_true<ndebug>(index != ::mcpprt::container::details::slot_npos);
+        return ::std::forward_like<decltype(self)>(self.values_.value_[index]);
+    }
+
+    /**
+     * @return nothing when the map is full
+     */
+    template<typename... Args>
+        requires (::std::constructible_from<T, Args && ...>)
+    constexpr auto emplace(this static_slot_map& self, Args&&... args) noexcept -> ::exception::optional<handle_type> {
+        // slots whose generation ran out are retired, so the map can run out of slots before it is full
+        if (self.size_ == N || (self.free_ == ::mcpprt::container::details::slot_npos && self.slot_count_ == N)) {
+            return ::exception::nullopt_t{};
+        }
+        self.values_.value_[self.size_] = T(::std::forward<Args>(args)...);
+        auto handle = ::mcpprt::container::details::slot_acquire(self.slots_.value_, self.slot_count_, self.free_,
+                                                                 self.size_);
+        self.owners_.value_[self.size_++] = handle.index_;
+        return handle;
+    }
+
+    constexpr auto insert(this static_slot_map& self, T const& value) noexcept -> ::exception::optional<handle_type> {
+        return self.emplace(value);
+    }
+
+    constexpr auto insert(this static_slot_map& self, T&& value) noexcept -> ::exception::optional<handle_type> {
+        return self.emplace(::std::move(value));
+    }
+
+    constexpr bool erase(this static_slot_map& self, handle_type handle) noexcept {
+        auto index = ::mcpprt::container::details::slot_find(self.slots_.value_, self.slot_count_, handle);
+        if (index == ::mcpprt::container::details::slot_npos) {
+            return false;
+        }
+        auto last = self.size_ - 1;
+        if (index != last) {
+            self.values_.value_[index] = ::std::move(self.values_.value_[last]);
+            self.owners_.value_[index] = self.owners_.value_[last];
+            self.slots_.value_[self.owners_.value_[index]].index_ = index;
+        }
+        self.values_.value_[last] = T{};
+        self.size_ = last;
+        ::mcpprt::container::details::slot_release(self.slots_.value_, self.free_, handle.index_);
+        return true;
+    }
+
+    constexpr void clear(this static_slot_map& self) noexcept {
+        for (::std::uint32_t i{}; i < self.size_; ++i) {
+            ::mcpprt::container::details::slot_release(self.slots_.value_, self.free_, self.owners_.value_[i]);
+            self.values_.value_[i] = T{};
+        }
+        self.size_ = 0;
+    }
+};
+
+} // namespace mcpprt::container
@@ -0,0 +1,60 @@
+#pragma once
+
+/**
+ * @file uninitialized.hh
+ * @brief moving live elements around in storage whose tail is uninitialized
+ * @note for trivially copyable elements these reduce to memmove
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace mcpprt::container::details {
+
+/**
+ * @brief open an uninitialized slot at `pos` in the `size` live elements of `data`
+ */
+template<typename U>
+constexpr void shift_open(U* data, ::std::size_t size, ::std::size_t pos) noexcept {
+    if (pos == size) {
+        return;
+    }
+    ::std::construct_at(data + size, ::std::move(data[size - 1]));
+    ::std::move_backward(data + pos, data + size - 1, data + size);
+    ::std::destroy_at(data + pos);
+}
+
+/**
+ * @brief remove the element at `pos` from the `size` live elements of `data`
+ */
+template<typename U>
+constexpr void shift_close(U* data, ::std::size_t size, ::std::size_t pos) noexcept {
+    ::std::move(data + pos + 1, data + size, data + pos);
+    ::std::destroy_at(data + size - 1);
+}
+
+/**
+ * @brief move `count` live elements into uninitialized storage and destroy the sources
+ */
+template<typename U>
+constexpr void move_out(U* first, ::std::size_t count, U* dest) noexcept {
+    // std::uninitialized_move is not constexpr before C++26
+    for (::std::size_t i{}; i < count; ++i) {
+        ::std::construct_at(dest + i, ::std::move(first[i]));
+    }
+    ::std::destroy(first, first + count);
+}
+
+/**
+ * @brief copy `count` live elements into uninitialized storage
+ */
+template<typename U>
+constexpr void copy_out(U const* first, ::std::size_t count, U* dest) noexcept {
+    for (::std::size_t i{}; i < count; ++i) {
+        ::std::construct_at(dest + i, first[i]);
+    }
+}
+
+} // namespace mcpprt::container::details
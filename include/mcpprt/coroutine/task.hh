@@ -0,0 +1,288 @@
+#pragma once
+
+/**
+ * @file task.hh
+ * @brief lazy coroutine task whose result is an `::exception::expected`
+ * @details frames are allocated from `::mcpprt::memory::pool_allocate`, awaiting a task resumes it through
+ *          symmetric transfer, so a chain of awaits neither grows the stack nor calls the global allocator
+ */
+
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <concepts>
+#include <type_traits>
+#include <utility>
+#include <exception/exception.hh>
+#include "../memory/pool.hh"
+
+namespace mcpprt::coroutine {
+
+template<typename T>
+    requires (::exception::is_expected<T>)
+class task;
+
+namespace details {
+
+struct promise_base {
+    ::std::coroutine_handle<> continuation_{};
+
+    /**
+     * @note not noexcept, which would require `get_return_object_on_allocation_failure`,
+     *       the pool terminates instead of returning nullptr
+     */
+    [[nodiscard]]
+    static void* operator new(::std::size_t size) {
+        return ::mcpprt::memory::pool_allocate(size);
+    }
+
+    static void operator delete(void* ptr, ::std::size_t size) noexcept {
+        ::mcpprt::memory::pool_deallocate(ptr, size);
+    }
+
+    struct final_awaiter {
+        [[nodiscard]]
+        static constexpr bool await_ready() noexcept {
+            return false;
+        }
+
+        template<typename Promise>
+        [[nodiscard]]
+        static auto await_suspend(::std::coroutine_handle<Promise> handle) noexcept -> ::std::coroutine_handle<> {
+            return handle.promise().continuation();
+        }
+
+        static constexpr void await_resume() noexcept {
+        }
+    };
+
+    [[nodiscard]]
+    static constexpr auto initial_suspend() noexcept -> ::std::suspend_always {
+        return {};
+    }
+
+    [[nodiscard]]
+    static constexpr auto final_suspend() noexcept -> ::mcpprt::coroutine::details::promise_base::final_awaiter {
+        return {};
+    }
+
+    [[noreturn]]
+    static void unhandled_exception() noexcept {
+        ::exception::terminate();
+    }
+
+    /**
+     * @brief the coroutine to transfer to once this one has a result
+     */
+    [[nodiscard]]
+    auto continuation(this ::mcpprt::coroutine::details::promise_base const& self) noexcept
+        -> ::std::coroutine_handle<> {
+        if (self.continuation_) {
+            return self.continuation_;
+        }
+        return ::std::noop_coroutine();
+    }
+};
+
+template<typename T>
+struct promise : ::mcpprt::coroutine::details::promise_base {
+    union {
+        T result_;
+    };
+
+    bool has_result_{};
+
+    promise() noexcept {
+    }
+
+    promise(::mcpprt::coroutine::details::promise<T> const&) = delete;
+
+    ~promise() noexcept {
+        if (this->has_result_) {
+            ::std::destroy_at(&this->result_);
+        }
+    }
+
+    [[nodiscard]]
+    auto get_return_object(this ::mcpprt::coroutine::details::promise<T>& self) noexcept
+        -> ::mcpprt::coroutine::task<T> {
+        return ::mcpprt::coroutine::task<T>{
+            ::std::coroutine_handle<::mcpprt::coroutine::details::promise<T>>::from_promise(self)};
+    }
+
+    template<typename U>
+        requires (::std::constructible_from<T, U &&>)
+    void return_value(this ::mcpprt::coroutine::details::promise<T>& self,
+                      U&& value) noexcept(::std::is_nothrow_constructible_v<T, U &&>) {
+        ::std::construct_at(&self.result_, ::std::forward<U>(value));
+        self.has_result_ = true;
+    }
+
+    /**
+     * @brief finish the coroutine with an error without reaching `co_return`, used by `propagate`
+     */
+    template<typename E>
+    void fail(this ::mcpprt::coroutine::details::promise<T>& self, E&& error) noexcept {
+        ::std::construct_at(&self.result_,
+                            ::exception::unexpected<typename T::error_type>{static_cast<typename T::error_type>(
+                                ::std::forward<E>(error))});
+        self.has_result_ = true;
+    }
+};
+
+} // namespace details
+
+/**
+ * @brief a lazily started coroutine producing `T`, which must be an `::exception::expected`
+ * @note `unhandled_exception` terminates, the error channel is the `expected` itself
+ */
+template<typename T>
+    requires (::exception::is_expected<T>)
+class task {
+public:
+    using promise_type = ::mcpprt::coroutine::details::promise<T>;
+    using value_type = T;
+    using handle_type = ::std::coroutine_handle<promise_type>;
+
+private:
+    handle_type handle_{};
+
+    struct awaiter {
+        handle_type handle_;
+
+        [[nodiscard]]
+        bool await_ready(this awaiter const& self) noexcept {
+            return self.handle_.promise().has_result_;
+        }
+
+        [[nodiscard]]
+        auto await_suspend(this awaiter const& self, ::std::coroutine_handle<> caller) noexcept
+            -> ::std::coroutine_handle<> {
+            self.handle_.promise().continuation_ = caller;
+            return self.handle_;
+        }
+
+        [[nodiscard]]
+        auto await_resume(this awaiter const& self) noexcept -> T {
+            ::exception::assert_true(self.handle_.promise().has_result_);
+            return ::std::move(self.handle_.promise().result_);
+        }
+    };
+
+public:
+    constexpr task() noexcept = default;
+
+    constexpr explicit task(handle_type handle) noexcept
+        : handle_{handle} {
+    }
+
+    task(::mcpprt::coroutine::task<T> const&) = delete;
+
+    constexpr task(::mcpprt::coroutine::task<T>&& other) noexcept
+        : handle_{::std::exchange(other.handle_, {})} {
+    }
+
+    task& operator=(::mcpprt::coroutine::task<T> const&) = delete;
+
+    auto&& operator=(this ::mcpprt::coroutine::task<T>& self, ::mcpprt::coroutine::task<T>&& other) noexcept {
+        if (&self != &other) {
+            if (self.handle_) {
+                self.handle_.destroy();
+            }
+            self.handle_ = ::std::exchange(other.handle_, {});
+        }
+        return self;
+    }
+
+    ~task() noexcept {
+        if (this->handle_) {
+            this->handle_.destroy();
+        }
+    }
+
+    /**
+     * @brief whether the coroutine produced its result, either by `co_return` or by `propagate`
+     */
+    [[nodiscard]]
+    bool done(this ::mcpprt::coroutine::task<T> const& self) noexcept {
+        return self.handle_ && self.handle_.promise().has_result_;
+    }
+
+    /**
+     * @brief start or continue the coroutine, for schedulers driving a top-level task
+     */
+    void resume(this ::mcpprt::coroutine::task<T> const& self) noexcept {
+        ::exception::assert_true(self.handle_ && !self.handle_.promise().has_result_);
+        self.handle_.resume();
+    }
+
+    /**
+     * @brief move the result out of a finished task
+     */
+    [[nodiscard]]
+    auto result(this ::mcpprt::coroutine::task<T>&& self) noexcept -> T {
+        ::exception::assert_true(self.done());
+        return ::std::move(self.handle_.promise().result_);
+    }
+
+    /**
+     * @note awaiting requires an rvalue, a task can only be awaited once
+     */
+    [[nodiscard]]
+    auto operator co_await(this ::mcpprt::coroutine::task<T>&& self) noexcept {
+        ::exception::assert_true(static_cast<bool>(self.handle_));
+        return awaiter{self.handle_};
+    }
+};
+
+namespace details {
+
+template<typename T>
+struct propagate_awaiter {
+    T value_;
+
+    [[nodiscard]]
+    constexpr bool await_ready(this propagate_awaiter const& self) noexcept {
+        return self.value_.has_value();
+    }
+
+    template<typename Promise>
+    [[nodiscard]]
+    auto await_suspend(this propagate_awaiter& self, ::std::coroutine_handle<Promise> handle) noexcept
+        -> ::std::coroutine_handle<> {
+        handle.promise().fail(self.value_.error());
+        // the frame stays suspended here, the owning task destroys it
+        return handle.promise().continuation();
+    }
+
+    [[nodiscard]]
+    constexpr auto await_resume(this propagate_awaiter& self) noexcept -> typename T::value_type {
+        return ::std::move(self.value_).value();
+    }
+};
+
+} // namespace details
+
+/**
+ * @brief unwrap an expected inside a task, or finish the task with its error
+ * @example auto v = co_await ::mcpprt::coroutine::propagate(co_await read());
+ */
+template<typename T>
+    requires (::exception::is_expected<T>)
+[[nodiscard]]
+constexpr auto propagate(T&& value) noexcept {
+    return ::mcpprt::coroutine::details::propagate_awaiter<::std::remove_cvref_t<T>>{::std::forward<T>(value)};
+}
+
+/**
+ * @brief run a task on the calling thread and return its result
+ * @note every await inside must complete inline, there is no event loop to wait on
+ */
+template<typename T>
+[[nodiscard]]
+auto sync_wait(::mcpprt::coroutine::task<T>&& task) noexcept -> T {
+    task.resume();
+    return ::std::move(task).result();
+}
+
+} // namespace mcpprt::coroutine
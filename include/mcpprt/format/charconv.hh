@@ -0,0 +1,569 @@
+#pragma once
+
+/**
+ * @file charconv.hh
+ * @brief `to_chars` / `from_chars` without libc, usable in constant evaluation
+ * @details integers are written two digits at a time from a digit-pair table and parsed eight digits at a time
+ *          with SWAR validation, floating point numbers are written with the shortest digits that round-trip
+ */
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <exception/exception.hh>
+#include "../container/array.hh"
+#include "../container/static_vector.hh"
+#include "ryu.hh"
+
+namespace mcpprt::format {
+
+enum class errc : unsigned char {
+    /**
+     * @brief no digits could be parsed
+     */
+    invalid_argument,
+    /**
+     * @brief the output buffer is too small
+     */
+    value_too_large,
+    /**
+     * @brief the parsed number does not fit in the requested type
+     */
+    result_out_of_range,
+};
+
+/**
+ * @brief how `to_chars` writes floating point numbers, the digits are the shortest round-trip ones in all cases
+ */
+enum class float_format : unsigned char {
+    /**
+     * @brief fixed or scientific, whichever is shorter, fixed on a tie
+     */
+    general,
+    scientific,
+    fixed,
+};
+
+template<typename T>
+struct parsed {
+    T value_;
+    /**
+     * @brief one past the last character consumed
+     */
+    char const* end_;
+};
+
+template<typename T>
+concept is_integer = ::std::integral<T> && !::std::same_as<::std::remove_cv_t<T>, bool>;
+
+template<typename T>
+concept is_float = ::std::same_as<::std::remove_cv_t<T>, float> || ::std::same_as<::std::remove_cv_t<T>, double>;
+
+/**
+ * @brief the longest output of `to_chars` in base 10, or of `float_format::general` / `scientific`
+ */
+template<typename T>
+    requires (::mcpprt::format::is_integer<T> || ::mcpprt::format::is_float<T>)
+inline constexpr ::std::size_t max_chars = [] {
+    if constexpr (::std::same_as<T, double>) {
+        // -2.2250738585072014e-308
+        return ::std::size_t{24};
+    } else if constexpr (::std::same_as<T, float>) {
+        // -1.17549435e-38
+        return ::std::size_t{15};
+    } else {
+        return static_cast<::std::size_t>(::std::numeric_limits<T>::digits10) + 1 + ::std::is_signed_v<T>;
+    }
+}();
+
+namespace details {
+
+inline constexpr auto digit_pairs = [] {
+    ::mcpprt::container::array<char, 200> table{};
+    for (::std::size_t i{}; i < 100; ++i) {
+        table[i * 2] = static_cast<char>('0' + i / 10);
+        table[i * 2 + 1] = static_cast<char>('0' + i % 10);
+    }
+    return table;
+}();
+
+inline constexpr auto pow10_table = [] {
+    ::mcpprt::container::array<::std::uint64_t, 20> table{};
+    ::std::uint64_t value{1};
+    for (auto& i : table) {
+        i = value;
+        value *= 10;
+    }
+    return table;
+}();
+
+/**
+ * @brief number of decimal digits, without a loop: log10 estimated from the bit width and corrected once
+ */
+[[nodiscard]]
+constexpr auto count_digits(::std::uint64_t value) noexcept -> ::std::size_t {
+    value |= 1;
+    auto t = (static_cast<::std::size_t>(::std::bit_width(value)) * 1233) >> 12;
+    return t - (value < ::mcpprt::format::details::pow10_table.template operator[]<true>(t)) + 1;
+}
+
+/**
+ * @brief write the digits of value so that they end right before `last`
+ */
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+[[msvc::forceinline]]
+#endif
+constexpr void write_digits(char* last, ::std::uint64_t value) noexcept {
+    auto const& pairs = ::mcpprt::format::details::digit_pairs;
+    while (value >= 100) {
+        auto index = static_cast<::std::size_t>(value % 100) * 2;
+        value /= 100;
+        *--last = pairs.template operator[]<true>(index + 1);
+        *--last = pairs.template operator[]<true>(index);
+    }
+    if (value >= 10) {
+        auto index = static_cast<::std::size_t>(value) * 2;
+        *--last = pairs.template operator[]<true>(index + 1);
+        *--last = pairs.template operator[]<true>(index);
+    } else {
+        *--last = static_cast<char>('0' + value);
+    }
+}
+
+[[nodiscard]]
+constexpr auto digit_value(char c) noexcept -> unsigned {
+    if (c >= '0' && c <= '9') {
+        return static_cast<unsigned>(c - '0');
+    }
+    if (c >= 'a' && c <= 'z') {
+        return static_cast<unsigned>(c - 'a') + 10;
+    }
+    if (c >= 'A' && c <= 'Z') {
+        return static_cast<unsigned>(c - 'A') + 10;
+    }
+    return 36;
+}
+
+/**
+ * @brief eight characters as one word, the first one in the lowest byte whatever the endianness
+ * @note built from bytes so that it also works in constant evaluation, compilers fold it into one load
+ */
+[[nodiscard]]
+constexpr auto load8(char const* ptr) noexcept -> ::std::uint64_t {
+    ::std::uint64_t word{};
+    for (::std::size_t i{}; i < 8; ++i) {
+        word |= static_cast<::std::uint64_t>(static_cast<unsigned char>(ptr[i])) << (i * 8);
+    }
+    return word;
+}
+
+[[nodiscard]]
+constexpr bool is_eight_digits(::std::uint64_t word) noexcept {
+    return (((word + 0x4646464646464646) | (word - 0x3030303030303030)) & 0x8080808080808080) == 0;
+}
+
+/**
+ * @brief https://lemire.me/blog/2022/01/21/swar-explained-parsing-eight-digits/
+ */
+[[nodiscard]]
+constexpr auto parse_eight_digits(::std::uint64_t word) noexcept -> ::std::uint64_t {
+    constexpr ::std::uint64_t mask = 0x000000FF000000FF;
+    constexpr ::std::uint64_t mul1 = 100 + (1000000ull << 32);
+    constexpr ::std::uint64_t mul2 = 1 + (10000ull << 32);
+    word -= 0x3030303030303030;
+    word = word * 10 + (word >> 8);
+    return (((word & mask) * mul1) + (((word >> 16) & mask) * mul2)) >> 32;
+}
+
+template<typename T>
+[[nodiscard]]
+constexpr auto unsigned_abs(T value) noexcept -> ::std::make_unsigned_t<T> {
+    using U = ::std::make_unsigned_t<T>;
+    if constexpr (::std::is_signed_v<T>) {
+        if (value < 0) {
+            return static_cast<U>(U{} - static_cast<U>(value));
+        }
+    }
+    return static_cast<U>(value);
+}
+
+/**
+ * @brief parse base 10 digits into an uint64_t and advance `first` past them
+ * @note the first 19 digits cannot overflow, so they take the SWAR path without any check
+ */
+[[nodiscard]]
+constexpr auto parse_decimal(char const*& first, char const* last, bool& overflow) noexcept -> ::std::uint64_t {
+    ::std::uint64_t value{};
+    ::std::size_t count{};
+    while (last - first >= 8 && count <= 11) {
+        auto word = ::mcpprt::format::details::load8(first);
+        if (!::mcpprt::format::details::is_eight_digits(word)) {
+            break;
+        }
+        value = value * 100000000 + ::mcpprt::format::details::parse_eight_digits(word);
+        first += 8;
+        count += 8;
+    }
+    for (; first != last && *first >= '0' && *first <= '9'; ++first, ++count) {
+        auto digit = static_cast<unsigned>(*first - '0');
+        if (count >= 19 && value > (::std::numeric_limits<::std::uint64_t>::max() - digit) / 10) {
+            overflow = true;
+        }
+        value = value * 10 + digit;
+    }
+    return value;
+}
+
+template<::mcpprt::format::is_float T>
+struct float_traits;
+
+template<>
+struct float_traits<double> {
+    using bits_type = ::std::uint64_t;
+    static constexpr ::std::int32_t mantissa_bits = 52;
+    static constexpr ::std::int32_t exponent_bits = 11;
+    static constexpr ::std::int32_t bias = 1023;
+};
+
+template<>
+struct float_traits<float> {
+    using bits_type = ::std::uint32_t;
+    static constexpr ::std::int32_t mantissa_bits = 23;
+    static constexpr ::std::int32_t exponent_bits = 8;
+    static constexpr ::std::int32_t bias = 127;
+};
+
+[[nodiscard]]
+constexpr auto copy_chars(char* dest, char const* first, char const* last) noexcept -> char* {
+    for (; first != last; ++first, ++dest) {
+        *dest = *first;
+    }
+    return dest;
+}
+
+[[nodiscard]]
+constexpr auto fill_zeros(char* dest, ::std::size_t count) noexcept -> char* {
+    for (; count != 0; --count, ++dest) {
+        *dest = '0';
+    }
+    return dest;
+}
+
+/**
+ * @brief length of `mantissa * 10^exponent` in scientific notation, without the sign
+ */
+[[nodiscard]]
+constexpr auto scientific_length(::std::uint64_t mantissa, ::std::int32_t exponent) noexcept -> ::std::size_t {
+    auto const length = ::mcpprt::format::details::count_digits(mantissa);
+    auto const sci_exponent = exponent + static_cast<::std::int32_t>(length) - 1;
+    auto const exponent_length = sci_exponent >= 100 || sci_exponent <= -100 ? 3 : 2;
+    return length + (length > 1) + 2 + exponent_length;
+}
+
+/**
+ * @brief the exact digits of the integer `m2 * 2^e2`, written so that they end right before `last`
+ * @return the first digit
+ */
+[[nodiscard]]
+constexpr auto write_integral(char* last, ::std::uint64_t m2, ::std::int32_t e2) noexcept -> char* {
+    if (e2 <= 0 || static_cast<::std::int32_t>(::std::bit_width(m2)) + e2 <= 64) {
+        auto value = e2 <= 0 ? m2 >> -e2 : m2 << e2;
+        ::mcpprt::format::details::write_digits(last, value);
+        return last - ::mcpprt::format::details::count_digits(value);
+    }
+    auto value = ::mcpprt::format::details::bignum::shifted(m2, e2);
+    for (;;) {
+        auto chunk = value.div_small(1000000000);
+        if (value.is_zero()) {
+            ::mcpprt::format::details::write_digits(last, chunk);
+            return last - ::mcpprt::format::details::count_digits(chunk);
+        }
+        last -= 9;
+        (void)::mcpprt::format::details::fill_zeros(last, 9);
+        ::mcpprt::format::details::write_digits(last + 9, chunk);
+    }
+}
+
+/**
+ * @brief lay out `digits * 10^exponent` in the requested format
+ */
+[[nodiscard]]
+constexpr auto write_decimal(char* first, char* last, bool negative, ::std::uint64_t mantissa, ::std::int32_t exponent,
+                             ::mcpprt::format::float_format format) noexcept
+    -> ::exception::expected<char*, ::mcpprt::format::errc> {
+    char digits[20]{};
+    auto const length = static_cast<::std::int32_t>(::mcpprt::format::details::count_digits(mantissa));
+    ::mcpprt::format::details::write_digits(digits + length, mantissa);
+
+    auto const sci_exponent = exponent + length - 1;
+    auto const sci_exponent_abs = static_cast<::std::uint32_t>(sci_exponent < 0 ? -sci_exponent : sci_exponent);
+    auto const sci_length =
+        static_cast<::std::int32_t>(::mcpprt::format::details::scientific_length(mantissa, exponent));
+    // digits before the decimal point
+    auto const point = length + exponent;
+    auto const fixed_length = exponent >= 0 ? point : (point > 0 ? length + 1 : 2 - exponent);
+
+    if (format == ::mcpprt::format::float_format::general) {
+        format = fixed_length <= sci_length ? ::mcpprt::format::float_format::fixed
+                                            : ::mcpprt::format::float_format::scientific;
+    }
+    auto const total = static_cast<::std::size_t>(
+        negative + (format == ::mcpprt::format::float_format::fixed ? fixed_length : sci_length));
+    if (static_cast<::std::size_t>(last - first) < total) {
+        return ::exception::unexpected<::mcpprt::format::errc>{::mcpprt::format::errc::value_too_large};
+    }
+
+    if (negative) {
+        *first++ = '-';
+    }
+    if (format == ::mcpprt::format::float_format::scientific) {
+        *first++ = digits[0];
+        if (length > 1) {
+            *first++ = '.';
+            first = ::mcpprt::format::details::copy_chars(first, digits + 1, digits + length);
+        }
+        *first++ = 'e';
+        *first++ = sci_exponent < 0 ? '-' : '+';
+        auto exponent_length = sci_exponent_abs >= 100 ? 3 : 2;
+        if (sci_exponent_abs < 10) {
+            *first = '0';
+        }
+        ::mcpprt::format::details::write_digits(first + exponent_length, sci_exponent_abs);
+        return first + exponent_length;
+    }
+
+    if (exponent >= 0) {
+        first = ::mcpprt::format::details::copy_chars(first, digits, digits + length);
+        return ::mcpprt::format::details::fill_zeros(first, static_cast<::std::size_t>(exponent));
+    }
+    if (point > 0) {
+        first = ::mcpprt::format::details::copy_chars(first, digits, digits + point);
+        *first++ = '.';
+        return ::mcpprt::format::details::copy_chars(first, digits + point, digits + length);
+    }
+    *first++ = '0';
+    *first++ = '.';
+    first = ::mcpprt::format::details::fill_zeros(first, static_cast<::std::size_t>(-point));
+    return ::mcpprt::format::details::copy_chars(first, digits, digits + length);
+}
+
+} // namespace details
+
+/**
+ * @brief write an integer into [first, last)
+ * @param base: 2 to 36, lowercase letters above 9
+ * @return one past the last character written
+ */
+template<::mcpprt::format::is_integer T>
+[[nodiscard]]
+constexpr auto to_chars(char* first, char* last, T value, int base = 10) noexcept
+    -> ::exception::expected<char*, ::mcpprt::format::errc> {
+    ::exception::assert_true(base >= 2 && base <= 36);
+    bool const negative = ::std::is_signed_v<T> && value < 0;
+    auto abs = ::mcpprt::format::details::unsigned_abs(value);
+
+    if (base == 10) [[likely]] {
+        auto length = ::mcpprt::format::details::count_digits(abs) + negative;
+        if (static_cast<::std::size_t>(last - first) < length) {
+            return ::exception::unexpected<::mcpprt::format::errc>{::mcpprt::format::errc::value_too_large};
+        }
+        *first = '-';
+        ::mcpprt::format::details::write_digits(first + length, abs);
+        return first + length;
+    }
+
+    ::std::size_t length{1};
+    for (auto rest = abs / static_cast<unsigned>(base); rest != 0; rest /= static_cast<unsigned>(base)) {
+        ++length;
+    }
+    length += negative;
+    if (static_cast<::std::size_t>(last - first) < length) {
+        return ::exception::unexpected<::mcpprt::format::errc>{::mcpprt::format::errc::value_too_large};
+    }
+    *first = '-';
+    auto* ptr = first + length;
+    do {
+        auto digit = static_cast<unsigned>(abs % static_cast<unsigned>(base));
+        *--ptr = static_cast<char>(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        abs /= static_cast<unsigned>(base);
+    } while (abs != 0);
+    return first + length;
+}
+
+/**
+ * @brief write a floating point number with the fewest digits that parse back to the same value
+ * @note nan and infinities are written as `nan`, `inf` and `-inf`
+ */
+template<::mcpprt::format::is_float T>
+[[nodiscard]]
+constexpr auto to_chars(char* first, char* last, T value,
+                        ::mcpprt::format::float_format format = ::mcpprt::format::float_format::general) noexcept
+    -> ::exception::expected<char*, ::mcpprt::format::errc> {
+    using traits = ::mcpprt::format::details::float_traits<::std::remove_cv_t<T>>;
+    using bits_type = typename traits::bits_type;
+
+    auto const bits = ::std::bit_cast<bits_type>(value);
+    bool const negative = (bits >> (traits::mantissa_bits + traits::exponent_bits)) != 0;
+    auto const ieee_mantissa = static_cast<::std::uint64_t>(bits & ((bits_type{1} << traits::mantissa_bits) - 1));
+    auto const ieee_exponent = static_cast<::std::uint32_t>((bits >> traits::mantissa_bits) &
+                                                            ((bits_type{1} << traits::exponent_bits) - 1));
+
+    if (ieee_exponent == (1u << traits::exponent_bits) - 1) {
+        char const* text = ieee_mantissa != 0 ? "nan" : (negative ? "-inf" : "inf");
+        ::std::size_t length = ieee_mantissa == 0 && negative ? 4 : 3;
+        if (static_cast<::std::size_t>(last - first) < length) {
+            return ::exception::unexpected<::mcpprt::format::errc>{::mcpprt::format::errc::value_too_large};
+        }
+        return ::mcpprt::format::details::copy_chars(first, text, text + length);
+    }
+    if (ieee_exponent == 0 && ieee_mantissa == 0) {
+        return ::mcpprt::format::details::write_decimal(first, last, negative, 0, 0, format);
+    }
+
+    auto decimal = ::mcpprt::format::details::shortest<traits::mantissa_bits, traits::bias>(ieee_mantissa,
+                                                                                           ieee_exponent);
+    auto const sci_length = ::mcpprt::format::details::scientific_length(decimal.mantissa_, decimal.exponent_);
+    auto const min_fixed_length = ::mcpprt::format::details::count_digits(decimal.mantissa_) +
+                                  static_cast<::std::size_t>(decimal.exponent_) - 1;
+    if (decimal.exponent_ > 0 &&
+        (format == ::mcpprt::format::float_format::fixed ||
+         (format == ::mcpprt::format::float_format::general && min_fixed_length <= sci_length))) {
+        // a value at least 10 whose shortest digits end in zeros is an integer, with a normal exponent,
+        // fixed notation spells out all of its digits like std::to_chars does instead of padding with zeros
+        char digits[310]{};
+        auto* const digits_last = digits + sizeof(digits);
+        auto* const digits_first = ::mcpprt::format::details::write_integral(
+            digits_last, ieee_mantissa | (::std::uint64_t{1} << traits::mantissa_bits),
+            static_cast<::std::int32_t>(ieee_exponent) - traits::bias - traits::mantissa_bits);
+        auto const length = static_cast<::std::size_t>(digits_last - digits_first);
+        if (format == ::mcpprt::format::float_format::fixed || length <= sci_length) {
+            if (static_cast<::std::size_t>(last - first) < length + negative) {
+                return ::exception::unexpected<::mcpprt::format::errc>{::mcpprt::format::errc::value_too_large};
+            }
+            if (negative) {
+                *first++ = '-';
+            }
+            return ::mcpprt::format::details::copy_chars(first, digits_first, digits_last);
+        }
+        format = ::mcpprt::format::float_format::scientific;
+    }
+    return ::mcpprt::format::details::write_decimal(first, last, negative, decimal.mantissa_, decimal.exponent_,
+                                                    format);
+}
+
+/**
+ * @brief write into the front of a fixed-size buffer
+ * @return the number of characters written
+ */
+template<::std::size_t N, typename T, typename... Args>
+    requires (::mcpprt::format::is_integer<T> || ::mcpprt::format::is_float<T>)
+[[nodiscard]]
+constexpr auto to_chars(::mcpprt::container::array<char, N>& buffer, T value, Args... args) noexcept
+    -> ::exception::expected<::std::size_t, ::mcpprt::format::errc> {
+    auto result = ::mcpprt::format::to_chars(buffer.begin(), buffer.end(), value, args...);
+    if (!result.has_value()) {
+        return ::exception::unexpected<::mcpprt::format::errc>{result.error()};
+    }
+    return static_cast<::std::size_t>(result.value() - buffer.begin());
+}
+
+template<::std::size_t N, typename T, typename... Args>
+    requires (::mcpprt::format::is_integer<T> || ::mcpprt::format::is_float<T>)
+[[nodiscard]]
+constexpr auto to_chars(::mcpprt::container::static_vector<char, N>& buffer, T value, Args... args) noexcept
+    -> ::exception::expected<::std::size_t, ::mcpprt::format::errc> {
+    auto result = ::mcpprt::format::to_chars(buffer.begin(), buffer.end(), value, args...);
+    if (!result.has_value()) {
+        return ::exception::unexpected<::mcpprt::format::errc>{result.error()};
+    }
+    return static_cast<::std::size_t>(result.value() - buffer.begin());
+}
+
+/**
+ * @brief format a constant into a null-terminated string of exactly the right size, like a string literal
+ * @example static_assert(::mcpprt::format::to_static_vector<42>() == "42");
+ */
+template<auto Value>
+    requires (::mcpprt::format::is_integer<decltype(Value)> || ::mcpprt::format::is_float<decltype(Value)>)
+[[nodiscard]]
+consteval auto to_static_vector() noexcept {
+    constexpr auto formatted = [] {
+        struct {
+            ::mcpprt::container::array<char, ::mcpprt::format::max_chars<decltype(Value)>> buffer_;
+            ::std::size_t size_;
+        } result{};
+        result.size_ = ::mcpprt::format::to_chars(result.buffer_, Value).value();
+        return result;
+    }();
+    ::mcpprt::container::static_vector<char, formatted.size_ + 1> result{};
+    for (::std::size_t i{}; i < formatted.size_; ++i) {
+        result[i] = formatted.buffer_[i];
+    }
+    result[formatted.size_] = '\0';
+    return result;
+}
+
+/**
+ * @brief parse an integer from the start of [first, last)
+ * @note like `std::from_chars`: no leading `+` or whitespace, `-` only for signed types, no base prefix
+ */
+template<::mcpprt::format::is_integer T>
+[[nodiscard]]
+constexpr auto from_chars(char const* first, char const* last, int base = 10) noexcept
+    -> ::exception::expected<::mcpprt::format::parsed<T>, ::mcpprt::format::errc> {
+    ::exception::assert_true(base >= 2 && base <= 36);
+    using U = ::std::make_unsigned_t<T>;
+
+    auto* ptr = first;
+    bool negative = false;
+    if constexpr (::std::is_signed_v<T>) {
+        if (ptr != last && *ptr == '-') {
+            negative = true;
+            ++ptr;
+        }
+    }
+    auto* const digits_begin = ptr;
+
+    ::std::uint64_t value{};
+    bool overflow = false;
+    if (base == 10) [[likely]] {
+        // leading zeros would otherwise count against the digits that cannot overflow
+        while (ptr != last && *ptr == '0') {
+            ++ptr;
+        }
+        value = ::mcpprt::format::details::parse_decimal(ptr, last, overflow);
+    } else {
+        auto const limit = ::std::numeric_limits<::std::uint64_t>::max();
+        for (; ptr != last; ++ptr) {
+            auto digit = ::mcpprt::format::details::digit_value(*ptr);
+            if (digit >= static_cast<unsigned>(base)) {
+                break;
+            }
+            if (value > (limit - digit) / static_cast<unsigned>(base)) {
+                overflow = true;
+            }
+            value = value * static_cast<unsigned>(base) + digit;
+        }
+    }
+
+    if (ptr == digits_begin) {
+        return ::exception::unexpected<::mcpprt::format::errc>{::mcpprt::format::errc::invalid_argument};
+    }
+
+    auto const max_abs = static_cast<::std::uint64_t>(::std::numeric_limits<T>::max()) + negative;
+    if (overflow || value > max_abs) {
+        return ::exception::unexpected<::mcpprt::format::errc>{::mcpprt::format::errc::result_out_of_range};
+    }
+    auto result = static_cast<U>(value);
+    if (negative) {
+        result = static_cast<U>(U{} - result);
+    }
+    return ::mcpprt::format::parsed<T>{static_cast<T>(result), ptr};
+}
+
+} // namespace mcpprt::format
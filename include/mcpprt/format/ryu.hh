@@ -0,0 +1,371 @@
+#pragma once
+
+/**
+ * @file ryu.hh
+ * @brief shortest round-trip decimal digits of binary floating point numbers
+ * @details https://github.com/ulfjack/ryu, the power of 5 tables are computed at compile time instead of
+ *          being spelled out, the algorithm is the one of d2s.c parameterized on the IEEE format
+ */
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <exception/exception.hh>
+#include "../container/array.hh"
+
+namespace mcpprt::format::details {
+
+struct uint128 {
+    ::std::uint64_t low_;
+    ::std::uint64_t high_;
+};
+
+inline constexpr ::std::int32_t pow5_inv_bitcount = 125;
+inline constexpr ::std::int32_t pow5_bitcount = 125;
+inline constexpr ::std::size_t pow5_inv_table_size = 342;
+inline constexpr ::std::size_t pow5_table_size = 326;
+
+/**
+ * @brief ceil(log2(5^e)) for 0 <= e <= 3528, 1 for e == 0
+ */
+[[nodiscard]]
+constexpr auto pow5bits(::std::int32_t e) noexcept -> ::std::int32_t {
+    return static_cast<::std::int32_t>((static_cast<::std::uint32_t>(e) * 1217359u) >> 19) + 1;
+}
+
+/**
+ * @brief floor(log10(2^e)) for 0 <= e <= 1650
+ */
+[[nodiscard]]
+constexpr auto log10_pow2(::std::int32_t e) noexcept -> ::std::uint32_t {
+    return (static_cast<::std::uint32_t>(e) * 78913u) >> 18;
+}
+
+/**
+ * @brief floor(log10(5^e)) for 0 <= e <= 2620
+ */
+[[nodiscard]]
+constexpr auto log10_pow5(::std::int32_t e) noexcept -> ::std::uint32_t {
+    return (static_cast<::std::uint32_t>(e) * 732923u) >> 20;
+}
+
+[[nodiscard]]
+constexpr auto pow5_factor(::std::uint64_t value) noexcept -> ::std::uint32_t {
+    ::std::uint32_t count{};
+    for (; value % 5 == 0; value /= 5) {
+        ++count;
+    }
+    return count;
+}
+
+[[nodiscard]]
+constexpr bool multiple_of_pow5(::std::uint64_t value, ::std::uint32_t p) noexcept {
+    return ::mcpprt::format::details::pow5_factor(value) >= p;
+}
+
+[[nodiscard]]
+constexpr bool multiple_of_pow2(::std::uint64_t value, ::std::uint32_t p) noexcept {
+    return (value & ((::std::uint64_t{1} << p) - 1)) == 0;
+}
+
+/**
+ * @brief fixed-width little-endian big integer, only what the table generation needs
+ */
+struct bignum {
+    static constexpr ::std::size_t limbs = 36;
+
+    ::std::uint32_t limb_[limbs]{};
+
+    constexpr void mul_small(this ::mcpprt::format::details::bignum& self, ::std::uint32_t factor) noexcept {
+        ::std::uint64_t carry{};
+        for (auto& limb : self.limb_) {
+            auto product = static_cast<::std::uint64_t>(limb) * factor + carry;
+            limb = static_cast<::std::uint32_t>(product);
+            carry = product >> 32;
+        }
+    }
+
+    /**
+     * @return the remainder
+     */
+    constexpr auto div_small(this ::mcpprt::format::details::bignum& self, ::std::uint32_t divisor) noexcept
+        -> ::std::uint32_t {
+        ::std::uint64_t remainder{};
+        for (auto i = limbs; i-- > 0;) {
+            auto current = (remainder << 32) | self.limb_[i];
+            self.limb_[i] = static_cast<::std::uint32_t>(current / divisor);
+            remainder = current % divisor;
+        }
+        return static_cast<::std::uint32_t>(remainder);
+    }
+
+    /**
+     * @brief value * 2^shift, shift must keep the result within `limbs`
+     */
+    [[nodiscard]]
+    static constexpr auto shifted(::std::uint64_t value, ::std::int32_t shift) noexcept
+        -> ::mcpprt::format::details::bignum {
+        ::mcpprt::format::details::bignum result{};
+        auto index = static_cast<::std::size_t>(shift / 32);
+        auto offset = shift % 32;
+        for (; value != 0; value >>= 32, ++index) {
+            auto part = (value & 0xFFFFFFFFu) << offset;
+            result.limb_[index] |= static_cast<::std::uint32_t>(part);
+            if (index + 1 < limbs) {
+                result.limb_[index + 1] |= static_cast<::std::uint32_t>(part >> 32);
+            }
+        }
+        return result;
+    }
+
+    [[nodiscard]]
+    constexpr bool is_zero(this ::mcpprt::format::details::bignum const& self) noexcept {
+        for (auto limb : self.limb_) {
+            if (limb != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]]
+    constexpr auto bit_length(this ::mcpprt::format::details::bignum const& self) noexcept -> ::std::int32_t {
+        for (auto i = limbs; i-- > 0;) {
+            if (self.limb_[i] != 0) {
+                return static_cast<::std::int32_t>(i * 32) +
+                       static_cast<::std::int32_t>(::std::bit_width(self.limb_[i]));
+            }
+        }
+        return 0;
+    }
+
+    [[nodiscard]]
+    constexpr bool bit(this ::mcpprt::format::details::bignum const& self, ::std::int32_t index) noexcept {
+        if (index < 0 || index >= static_cast<::std::int32_t>(limbs * 32)) {
+            return false;
+        }
+        return ((self.limb_[index / 32] >> (index % 32)) & 1u) != 0;
+    }
+
+    /**
+     * @brief floor(self / 2^shift) mod 2^128, a negative shift shifts left
+     */
+    [[nodiscard]]
+    constexpr auto extract(this ::mcpprt::format::details::bignum const& self, ::std::int32_t shift) noexcept
+        -> ::mcpprt::format::details::uint128 {
+        ::mcpprt::format::details::uint128 result{};
+        for (::std::int32_t i{}; i < 64; ++i) {
+            result.low_ |= static_cast<::std::uint64_t>(self.bit(shift + i)) << i;
+            result.high_ |= static_cast<::std::uint64_t>(self.bit(shift + 64 + i)) << i;
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief POW5_INV_SPLIT[i] = floor(2^(pow5bits(i) - 1 + 125) / 5^i) + 1
+ * @note floor(floor(x / a) / b) == floor(x / (a * b)), so one big dividend is divided by 5 step by step
+ */
+[[nodiscard]]
+consteval auto make_pow5_inv_split() noexcept
+    -> ::mcpprt::container::array<::mcpprt::format::details::uint128, pow5_inv_table_size> {
+    constexpr ::std::int32_t top = 1024;
+    ::mcpprt::container::array<::mcpprt::format::details::uint128, pow5_inv_table_size> table{};
+    ::mcpprt::format::details::bignum quotient{};
+    quotient.limb_[top / 32] = 1;
+    for (::std::size_t i{}; i < pow5_inv_table_size; ++i) {
+        auto j = ::mcpprt::format::details::pow5bits(static_cast<::std::int32_t>(i)) - 1 + pow5_inv_bitcount;
+        auto value = quotient.extract(top - j);
+        value.low_ += 1;
+        value.high_ += value.low_ == 0;
+        table[i] = value;
+        (void)quotient.div_small(5);
+    }
+    return table;
+}
+
+/**
+ * @brief POW5_SPLIT[i] = 5^i scaled to exactly 125 bits
+ */
+[[nodiscard]]
+consteval auto make_pow5_split() noexcept
+    -> ::mcpprt::container::array<::mcpprt::format::details::uint128, pow5_table_size> {
+    ::mcpprt::container::array<::mcpprt::format::details::uint128, pow5_table_size> table{};
+    ::mcpprt::format::details::bignum power{};
+    power.limb_[0] = 1;
+    for (::std::size_t i{}; i < pow5_table_size; ++i) {
+        table[i] = power.extract(power.bit_length() - pow5_bitcount);
+        power.mul_small(5);
+    }
+    return table;
+}
+
+inline constexpr auto pow5_inv_split = ::mcpprt::format::details::make_pow5_inv_split();
+inline constexpr auto pow5_split = ::mcpprt::format::details::make_pow5_split();
+
+/**
+ * @brief (m * mul) >> j for 64 < j < 128
+ */
+[[nodiscard]]
+constexpr auto mul_shift64(::std::uint64_t m, ::mcpprt::format::details::uint128 const& mul,
+                           ::std::int32_t j) noexcept -> ::std::uint64_t {
+#if defined(__SIZEOF_INT128__)
+    __extension__ using u128 = unsigned __int128;
+    auto b0 = static_cast<u128>(m) * mul.low_;
+    auto b2 = static_cast<u128>(m) * mul.high_;
+    return static_cast<::std::uint64_t>(((b0 >> 64) + b2) >> (j - 64));
+#else
+    auto umul128 = [](::std::uint64_t a, ::std::uint64_t b, ::std::uint64_t& high) noexcept {
+        auto a_lo = a & 0xFFFFFFFFu;
+        auto a_hi = a >> 32;
+        auto b_lo = b & 0xFFFFFFFFu;
+        auto b_hi = b >> 32;
+        auto lo_lo = a_lo * b_lo;
+        auto hi_lo = a_hi * b_lo;
+        auto lo_hi = a_lo * b_hi;
+        auto hi_hi = a_hi * b_hi;
+        auto cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+        high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+        return (cross << 32) | (lo_lo & 0xFFFFFFFFu);
+    };
+    ::std::uint64_t high0{};
+    umul128(m, mul.low_, high0);
+    ::std::uint64_t high1{};
+    auto low1 = umul128(m, mul.high_, high1);
+    auto sum = high0 + low1;
+    high1 += sum < high0;
+    auto dist = j - 64;
+    return (high1 << (64 - dist)) | (sum >> dist);
+#endif
+}
+
+struct decimal {
+    ::std::uint64_t mantissa_;
+    ::std::int32_t exponent_;
+};
+
+/**
+ * @brief the shortest decimal in the rounding interval of a finite, non-zero value
+ * @param ieee_mantissa: the stored mantissa bits
+ * @param ieee_exponent: the stored biased exponent
+ */
+template<::std::int32_t MantissaBits, ::std::int32_t Bias>
+[[nodiscard]]
+constexpr auto shortest(::std::uint64_t ieee_mantissa, ::std::uint32_t ieee_exponent) noexcept
+    -> ::mcpprt::format::details::decimal {
+    using ::mcpprt::format::details::pow5bits;
+
+    ::std::int32_t e2;
+    ::std::uint64_t m2;
+    if (ieee_exponent == 0) {
+        e2 = 1 - Bias - MantissaBits - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = static_cast<::std::int32_t>(ieee_exponent) - Bias - MantissaBits - 2;
+        m2 = (::std::uint64_t{1} << MantissaBits) | ieee_mantissa;
+    }
+    bool const accept_bounds = (m2 & 1) == 0;
+
+    // the interval of valid representations is [mm, mp], scaled by 4
+    ::std::uint64_t const mv = 4 * m2;
+    ::std::uint32_t const mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+    ::std::uint64_t vr;
+    ::std::uint64_t vp;
+    ::std::uint64_t vm;
+    ::std::int32_t e10;
+    bool vm_is_trailing_zeros = false;
+    bool vr_is_trailing_zeros = false;
+    if (e2 >= 0) {
+        auto const q = ::mcpprt::format::details::log10_pow2(e2) - (e2 > 3);
+        e10 = static_cast<::std::int32_t>(q);
+        auto const k = pow5_inv_bitcount + pow5bits(static_cast<::std::int32_t>(q)) - 1;
+        auto const i = -e2 + static_cast<::std::int32_t>(q) + k;
+        auto const& mul = ::mcpprt::format::details::pow5_inv_split[q];
+        vr = ::mcpprt::format::details::mul_shift64(4 * m2, mul, i);
+        vp = ::mcpprt::format::details::mul_shift64(4 * m2 + 2, mul, i);
+        vm = ::mcpprt::format::details::mul_shift64(4 * m2 - 1 - mm_shift, mul, i);
+        if (q <= 21) {
+            // only one of mp, mv and mm can be a multiple of 5, if any
+            if (mv % 5 == 0) {
+                vr_is_trailing_zeros = ::mcpprt::format::details::multiple_of_pow5(mv, q);
+            } else if (accept_bounds) {
+                vm_is_trailing_zeros = ::mcpprt::format::details::multiple_of_pow5(mv - 1 - mm_shift, q);
+            } else {
+                vp -= ::mcpprt::format::details::multiple_of_pow5(mv + 2, q);
+            }
+        }
+    } else {
+        auto const q = ::mcpprt::format::details::log10_pow5(-e2) - (-e2 > 1);
+        e10 = static_cast<::std::int32_t>(q) + e2;
+        auto const i = -e2 - static_cast<::std::int32_t>(q);
+        auto const k = pow5bits(i) - pow5_bitcount;
+        auto const j = static_cast<::std::int32_t>(q) - k;
+        auto const& mul = ::mcpprt::format::details::pow5_split[static_cast<::std::size_t>(i)];
+        vr = ::mcpprt::format::details::mul_shift64(4 * m2, mul, j);
+        vp = ::mcpprt::format::details::mul_shift64(4 * m2 + 2, mul, j);
+        vm = ::mcpprt::format::details::mul_shift64(4 * m2 - 1 - mm_shift, mul, j);
+        if (q <= 1) {
+            // mv = 4 * m2 always has at least two trailing 0 bits
+            vr_is_trailing_zeros = true;
+            if (accept_bounds) {
+                vm_is_trailing_zeros = mm_shift == 1;
+            } else {
+                --vp;
+            }
+        } else if (q < 63) {
+            vr_is_trailing_zeros = ::mcpprt::format::details::multiple_of_pow2(mv, q);
+        }
+    }
+
+    ::std::int32_t removed{};
+    ::std::uint64_t output;
+    if (vm_is_trailing_zeros || vr_is_trailing_zeros) {
+        // the general case, rare
+        ::std::uint32_t last_removed_digit{};
+        while (vp / 10 > vm / 10) {
+            vm_is_trailing_zeros &= vm % 10 == 0;
+            vr_is_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = static_cast<::std::uint32_t>(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        if (vm_is_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = static_cast<::std::uint32_t>(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+        }
+        if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0) {
+            // round half to even
+            last_removed_digit = 4;
+        }
+        output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) || last_removed_digit >= 5);
+    } else {
+        bool round_up = false;
+        if (vp / 100 > vm / 100) {
+            round_up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10) {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        output = vr + (vr == vm || round_up);
+    }
+    return {output, e10 + removed};
+}
+
+} // namespace mcpprt::format::details
@@ -0,0 +1,184 @@
+#pragma once
+
+/**
+ * @file hash.hh
+ * @brief seedable hashers for integers, floating-point numbers, pointers and the containers of the library
+ * @details `hasher<T>{seed}(value)` hashes with XXH3, so a key hashes the same in constant evaluation and at run
+ *          time. Unlike `std::hash`, integers are mixed rather than returned as they are, which open addressing
+ *          relies on. A seed from `random_seed()` keeps a peer that chooses the keys from forcing collisions.
+ * @example ::mcpprt::hash::hasher<::mcpprt::container::static_vector<char, 6>>{seed}("hello")
+ */
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "../container/array.hh"
+#include "../container/static_vector.hh"
+#include "xxh3.hh"
+
+namespace mcpprt::hash {
+
+/**
+ * @brief specialize for other types, with a `seed_` member and a call operator returning `std::uint64_t`
+ */
+template<typename T>
+struct hasher;
+
+template<typename T>
+concept is_hashable = requires(T const& value, ::std::uint64_t seed) {
+    { ::mcpprt::hash::hasher<T>{seed}(value) } -> ::std::same_as<::std::uint64_t>;
+};
+
+namespace details {
+
+template<typename T>
+constexpr bool is_array_ = false;
+
+template<typename T, ::std::size_t N>
+constexpr bool is_array_<::mcpprt::container::array<T, N>> = true;
+
+/**
+ * @brief contiguous ranges of bytes that are not containers of the library, such as a string type
+ * @note `array` is excluded before its `data()` is looked at
+ */
+template<typename T>
+concept is_byte_range = !::mcpprt::hash::details::is_array_<T> && !::mcpprt::container::is_static_vector<T> &&
+                        requires(T const& value) {
+                            { value.size() } -> ::std::convertible_to<::std::size_t>;
+                            requires ::mcpprt::hash::is_byte_hashable<
+                                ::std::remove_cvref_t<decltype(*value.data())>>;
+                        };
+
+/**
+ * @brief fold the hash of one more element into `state`
+ */
+[[nodiscard]]
+constexpr auto combine(::std::uint64_t state, ::std::uint64_t value) noexcept -> ::std::uint64_t {
+    return ::mcpprt::hash::details::mul_fold(state ^ value, ::mcpprt::hash::details::prime64_1);
+}
+
+/**
+ * @brief the hash of [first, first + count), in one pass over the bytes when the elements allow it
+ */
+template<typename T>
+[[nodiscard]]
+constexpr auto hash_elements(T const* first, ::std::size_t count, ::std::uint64_t seed) noexcept
+    -> ::std::uint64_t {
+    if constexpr (::mcpprt::hash::is_byte_hashable<T>) {
+        return ::mcpprt::hash::xxh3(first, count, seed);
+    } else {
+        static_assert(::mcpprt::hash::is_hashable<T>, "the element type has no hasher");
+        auto state = seed ^ (count * ::mcpprt::hash::details::prime64_2);
+        for (::std::size_t i{}; i < count; ++i) {
+            state = ::mcpprt::hash::details::combine(state, ::mcpprt::hash::hasher<T>{seed}(first[i]));
+        }
+        return ::mcpprt::hash::details::avalanche(state);
+    }
+}
+
+} // namespace details
+
+/**
+ * @brief integers, characters and enumerations, hashed as their object representation
+ */
+template<::mcpprt::hash::is_byte_hashable T>
+struct hasher<T> {
+    ::std::uint64_t seed_{};
+
+    [[nodiscard]]
+    constexpr auto operator()(this hasher const& self, T value) noexcept -> ::std::uint64_t {
+        return ::mcpprt::hash::xxh3(&value, 1, self.seed_);
+    }
+};
+
+/**
+ * @note -0.0 hashes as 0.0 since the two compare equal
+ */
+template<::std::floating_point T>
+    requires (sizeof(T) == 4 || sizeof(T) == 8)
+struct hasher<T> {
+    ::std::uint64_t seed_{};
+
+    [[nodiscard]]
+    constexpr auto operator()(this hasher const& self, T value) noexcept -> ::std::uint64_t {
+        using bits_type = ::std::conditional_t<sizeof(T) == 4, ::std::uint32_t, ::std::uint64_t>;
+        auto bits = ::std::bit_cast<bits_type>(value == T{} ? T{} : value);
+        return ::mcpprt::hash::xxh3(&bits, 1, self.seed_);
+    }
+};
+
+/**
+ * @note addresses have no value in constant evaluation, pointers hash at run time only
+ */
+template<typename T>
+struct hasher<T*> {
+    ::std::uint64_t seed_{};
+
+    [[nodiscard]]
+    auto operator()(this hasher const& self, T* value) noexcept -> ::std::uint64_t {
+        auto bits = reinterpret_cast<::std::uintptr_t>(value);
+        return ::mcpprt::hash::xxh3(&bits, 1, self.seed_);
+    }
+};
+
+template<typename T, ::std::size_t N>
+struct hasher<::mcpprt::container::array<T, N>> {
+    ::std::uint64_t seed_{};
+
+    [[nodiscard]]
+    constexpr auto operator()(this hasher const& self, ::mcpprt::container::array<T, N> const& value) noexcept
+        -> ::std::uint64_t {
+        return ::mcpprt::hash::details::hash_elements(value.value_, N, self.seed_);
+    }
+};
+
+/**
+ * @note the last element is not hashed, as `operator==` does not compare it, so a string literal
+ *       hashes like its characters without the NUL
+ */
+template<typename T, ::std::size_t N>
+struct hasher<::mcpprt::container::static_vector<T, N>> {
+    ::std::uint64_t seed_{};
+
+    [[nodiscard]]
+    constexpr auto operator()(this hasher const& self,
+                              ::mcpprt::container::static_vector<T, N> const& value) noexcept -> ::std::uint64_t {
+        return ::mcpprt::hash::details::hash_elements(value.value_, N - 1, self.seed_);
+    }
+};
+
+/**
+ * @brief anything with `data()` and `size()` over bytes, such as `std::string_view` or a string type
+ * @note hashes like an `array` of the same bytes, and like a string literal in a `static_vector`
+ */
+template<::mcpprt::hash::details::is_byte_range T>
+struct hasher<T> {
+    ::std::uint64_t seed_{};
+
+    [[nodiscard]]
+    constexpr auto operator()(this hasher const& self, T const& value) noexcept -> ::std::uint64_t {
+        return ::mcpprt::hash::xxh3(value.data(), value.size(), self.seed_);
+    }
+};
+
+/**
+ * @brief a seed that differs between processes and between calls, for tables whose keys come from outside
+ * @note not cryptographic: it mixes the cycle counter with addresses that move under ASLR
+ */
+[[nodiscard]]
+inline auto random_seed() noexcept -> ::std::uint64_t {
+    static constexpr char anchor{};
+    ::std::uint64_t counter{};
+#if defined(__SSE2__) || defined(_M_X64)
+    counter = __rdtsc();
+#elif defined(__aarch64__)
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(counter));
+#endif
+    ::mcpprt::container::array<::std::uintptr_t, 2> addresses{
+        {reinterpret_cast<::std::uintptr_t>(&anchor), reinterpret_cast<::std::uintptr_t>(&counter)}};
+    return ::mcpprt::hash::xxh3(addresses.value_, 2, counter);
+}
+
+} // namespace mcpprt::hash
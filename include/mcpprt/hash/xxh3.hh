@@ -0,0 +1,464 @@
+#pragma once
+
+/**
+ * @file xxh3.hh
+ * @brief XXH3, the 64-bit hash of xxHash, usable in constant evaluation, https://github.com/Cyan4973/xxHash
+ * @details inputs up to 16 bytes take one or two multiplications, up to 240 bytes are folded 16 bytes at a time,
+ *          and longer inputs run eight 64-bit accumulators over 64-byte stripes, with SSE2 or AVX2 when available.
+ *          Every path computes the reference `XXH3_64bits_withSeed`, in constant evaluation as well, so a table
+ *          hashed at compile time agrees with one hashed at run time.
+ */
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "../container/array.hh"
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <immintrin.h>
+#endif
+
+namespace mcpprt::hash {
+
+/**
+ * @brief element types hashed through their object representation
+ */
+template<typename T>
+concept is_byte_hashable =
+    (::std::integral<T> || ::std::is_enum_v<T>) && ::std::has_unique_object_representations_v<T>;
+
+namespace details {
+
+inline constexpr ::std::uint64_t prime32_1 = 0x9E3779B1u;
+inline constexpr ::std::uint64_t prime32_2 = 0x85EBCA77u;
+inline constexpr ::std::uint64_t prime32_3 = 0xC2B2AE3Du;
+inline constexpr ::std::uint64_t prime64_1 = 0x9E3779B185EBCA87u;
+inline constexpr ::std::uint64_t prime64_2 = 0xC2B2AE3D27D4EB4Fu;
+inline constexpr ::std::uint64_t prime64_3 = 0x165667B19E3779F9u;
+inline constexpr ::std::uint64_t prime64_4 = 0x85EBCA77C2B2AE63u;
+inline constexpr ::std::uint64_t prime64_5 = 0x27D4EB2F165667C5u;
+inline constexpr ::std::uint64_t prime_mx1 = 0x165667919E3779F9u;
+inline constexpr ::std::uint64_t prime_mx2 = 0x9FB21C651E98DF25u;
+
+inline constexpr ::std::size_t secret_size = 192;
+inline constexpr ::std::size_t stripe_size = 64;
+// a stripe consumes 8 more bytes of the secret than the previous one
+inline constexpr ::std::size_t stripes_per_block = (secret_size - stripe_size) / 8;
+inline constexpr ::std::size_t block_size = stripe_size * stripes_per_block;
+
+alignas(64) inline constexpr ::mcpprt::container::array<unsigned char, secret_size> default_secret{{
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+}};
+
+/**
+ * @brief byte `offset` of the object representation of the elements at `data`
+ */
+template<typename T>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+[[msvc::forceinline]]
+#endif
+[[nodiscard]]
+constexpr auto byte_at(T const* data, ::std::size_t offset) noexcept -> ::std::uint64_t {
+    if constexpr (sizeof(T) == 1) {
+        return ::std::bit_cast<unsigned char>(data[offset]);
+    } else {
+        return ::std::bit_cast<::mcpprt::container::array<unsigned char, sizeof(T)>>(data[offset / sizeof(T)])
+            .value_[offset % sizeof(T)];
+    }
+}
+
+/**
+ * @brief little-endian load of `Bytes` bytes at byte `offset`
+ * @note constant evaluation cannot reinterpret memory, it assembles the bytes one by one instead
+ */
+template<::std::size_t Bytes, typename T>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+[[msvc::forceinline]]
+#endif
+[[nodiscard]]
+constexpr auto load(T const* data, ::std::size_t offset) noexcept -> ::std::uint64_t {
+    static_assert(Bytes == 4 || Bytes == 8);
+    if consteval {
+        ::std::uint64_t result{};
+        for (::std::size_t i{}; i < Bytes; ++i) {
+            result |= ::mcpprt::hash::details::byte_at(data, offset + i) << (i * 8);
+        }
+        return result;
+    } else {
+        ::std::conditional_t<Bytes == 8, ::std::uint64_t, ::std::uint32_t> result;
+        ::std::memcpy(&result, reinterpret_cast<unsigned char const*>(data) + offset, Bytes);
+        if constexpr (::std::endian::native == ::std::endian::big) {
+            result = ::std::byteswap(result);
+        }
+        return result;
+    }
+}
+
+constexpr void store(unsigned char* data, ::std::size_t offset, ::std::uint64_t value) noexcept {
+    for (::std::size_t i{}; i < 8; ++i) {
+        data[offset + i] = static_cast<unsigned char>(value >> (i * 8));
+    }
+}
+
+/**
+ * @brief the 128-bit product of `a` and `b`, its two halves xor-ed together
+ */
+[[nodiscard]]
+constexpr auto mul_fold(::std::uint64_t a, ::std::uint64_t b) noexcept -> ::std::uint64_t {
+#if defined(__SIZEOF_INT128__)
+    __extension__ using u128 = unsigned __int128;
+    auto product = static_cast<u128>(a) * b;
+    return static_cast<::std::uint64_t>(product) ^ static_cast<::std::uint64_t>(product >> 64);
+#else
+    auto a_lo = a & 0xFFFFFFFFu;
+    auto a_hi = a >> 32;
+    auto b_lo = b & 0xFFFFFFFFu;
+    auto b_hi = b >> 32;
+    auto lo_lo = a_lo * b_lo;
+    auto hi_lo = a_hi * b_lo;
+    auto lo_hi = a_lo * b_hi;
+    auto hi_hi = a_hi * b_hi;
+    auto cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+    auto high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    auto low = (cross << 32) | (lo_lo & 0xFFFFFFFFu);
+    return low ^ high;
+#endif
+}
+
+[[nodiscard]]
+constexpr auto avalanche(::std::uint64_t hash) noexcept -> ::std::uint64_t {
+    hash ^= hash >> 37;
+    hash *= ::mcpprt::hash::details::prime_mx1;
+    return hash ^ (hash >> 32);
+}
+
+/**
+ * @brief the final mix of XXH64, for inputs of at most 3 bytes
+ */
+[[nodiscard]]
+constexpr auto avalanche64(::std::uint64_t hash) noexcept -> ::std::uint64_t {
+    hash ^= hash >> 33;
+    hash *= ::mcpprt::hash::details::prime64_2;
+    hash ^= hash >> 29;
+    hash *= ::mcpprt::hash::details::prime64_3;
+    return hash ^ (hash >> 32);
+}
+
+/**
+ * @brief a stronger mix for inputs of 4 to 8 bytes, which are only xor-ed with the secret
+ */
+[[nodiscard]]
+constexpr auto rrmxmx(::std::uint64_t hash, ::std::uint64_t size) noexcept -> ::std::uint64_t {
+    hash ^= ::std::rotl(hash, 49) ^ ::std::rotl(hash, 24);
+    hash *= ::mcpprt::hash::details::prime_mx2;
+    hash ^= (hash >> 35) + size;
+    hash *= ::mcpprt::hash::details::prime_mx2;
+    return hash ^ (hash >> 28);
+}
+
+/**
+ * @brief inputs of at most 16 bytes
+ */
+template<typename T>
+[[nodiscard]]
+constexpr auto hash_short(T const* data, ::std::size_t size, ::std::uint64_t seed) noexcept -> ::std::uint64_t {
+    auto const* secret = ::mcpprt::hash::details::default_secret.value_;
+    if (size > 8) {
+        auto bitflip1 =
+            (::mcpprt::hash::details::load<8>(secret, 24) ^ ::mcpprt::hash::details::load<8>(secret, 32)) + seed;
+        auto bitflip2 =
+            (::mcpprt::hash::details::load<8>(secret, 40) ^ ::mcpprt::hash::details::load<8>(secret, 48)) - seed;
+        auto low = ::mcpprt::hash::details::load<8>(data, 0) ^ bitflip1;
+        auto high = ::mcpprt::hash::details::load<8>(data, size - 8) ^ bitflip2;
+        return ::mcpprt::hash::details::avalanche(size + ::std::byteswap(low) + high +
+                                                  ::mcpprt::hash::details::mul_fold(low, high));
+    }
+    if (size >= 4) {
+        seed ^= static_cast<::std::uint64_t>(::std::byteswap(static_cast<::std::uint32_t>(seed))) << 32;
+        auto first = ::mcpprt::hash::details::load<4>(data, 0);
+        auto last = ::mcpprt::hash::details::load<4>(data, size - 4);
+        auto bitflip =
+            (::mcpprt::hash::details::load<8>(secret, 8) ^ ::mcpprt::hash::details::load<8>(secret, 16)) - seed;
+        return ::mcpprt::hash::details::rrmxmx((last + (first << 32)) ^ bitflip, size);
+    }
+    if (size > 0) {
+        auto combined = (::mcpprt::hash::details::byte_at(data, 0) << 16) |
+                        (::mcpprt::hash::details::byte_at(data, size >> 1) << 24) |
+                        ::mcpprt::hash::details::byte_at(data, size - 1) | (::std::uint64_t{size} << 8);
+        auto bitflip =
+            (::mcpprt::hash::details::load<4>(secret, 0) ^ ::mcpprt::hash::details::load<4>(secret, 4)) + seed;
+        return ::mcpprt::hash::details::avalanche64(combined ^ bitflip);
+    }
+    return ::mcpprt::hash::details::avalanche64(
+        seed ^ ::mcpprt::hash::details::load<8>(secret, 56) ^ ::mcpprt::hash::details::load<8>(secret, 64));
+}
+
+/**
+ * @brief 16 bytes of input at byte `offset` against 16 bytes of secret
+ */
+template<typename T>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+[[msvc::forceinline]]
+#endif
+[[nodiscard]]
+constexpr auto mix16(T const* data, ::std::size_t offset, unsigned char const* secret, ::std::uint64_t seed) noexcept
+    -> ::std::uint64_t {
+    return ::mcpprt::hash::details::mul_fold(
+        ::mcpprt::hash::details::load<8>(data, offset) ^ (::mcpprt::hash::details::load<8>(secret, 0) + seed),
+        ::mcpprt::hash::details::load<8>(data, offset + 8) ^ (::mcpprt::hash::details::load<8>(secret, 8) - seed));
+}
+
+/**
+ * @brief inputs of 17 to 128 bytes, folded from both ends towards the middle
+ */
+template<typename T>
+[[nodiscard]]
+constexpr auto hash_medium(T const* data, ::std::size_t size, ::std::uint64_t seed) noexcept -> ::std::uint64_t {
+    auto const* secret = ::mcpprt::hash::details::default_secret.value_;
+    auto acc = size * ::mcpprt::hash::details::prime64_1;
+    if (size > 32) {
+        if (size > 64) {
+            if (size > 96) {
+                acc += ::mcpprt::hash::details::mix16(data, 48, secret + 96, seed);
+                acc += ::mcpprt::hash::details::mix16(data, size - 64, secret + 112, seed);
+            }
+            acc += ::mcpprt::hash::details::mix16(data, 32, secret + 64, seed);
+            acc += ::mcpprt::hash::details::mix16(data, size - 48, secret + 80, seed);
+        }
+        acc += ::mcpprt::hash::details::mix16(data, 16, secret + 32, seed);
+        acc += ::mcpprt::hash::details::mix16(data, size - 32, secret + 48, seed);
+    }
+    acc += ::mcpprt::hash::details::mix16(data, 0, secret, seed);
+    acc += ::mcpprt::hash::details::mix16(data, size - 16, secret + 16, seed);
+    return ::mcpprt::hash::details::avalanche(acc);
+}
+
+/**
+ * @brief inputs of 129 to 240 bytes
+ */
+template<typename T>
+[[nodiscard]]
+constexpr auto hash_large(T const* data, ::std::size_t size, ::std::uint64_t seed) noexcept -> ::std::uint64_t {
+    auto const* secret = ::mcpprt::hash::details::default_secret.value_;
+    auto acc = size * ::mcpprt::hash::details::prime64_1;
+    for (::std::size_t i{}; i < 8; ++i) {
+        acc += ::mcpprt::hash::details::mix16(data, 16 * i, secret + 16 * i, seed);
+    }
+    acc = ::mcpprt::hash::details::avalanche(acc);
+    // the reference reads the last 16 bytes against the end of its smallest allowed secret, 136 bytes
+    auto tail = ::mcpprt::hash::details::mix16(data, size - 16, secret + 136 - 17, seed);
+    for (::std::size_t i{8}; i < size / 16; ++i) {
+        tail += ::mcpprt::hash::details::mix16(data, 16 * i, secret + 16 * (i - 8) + 3, seed);
+    }
+    return ::mcpprt::hash::details::avalanche(acc + tail);
+}
+
+/**
+ * @brief feed every stripe of an input longer than 240 bytes to `accumulate(offset, secret)`, and scramble the
+ *        accumulators after each block of 16 stripes
+ * @note the last stripe is the last 64 bytes of the input, it may overlap the stripe before it
+ */
+template<typename Accumulate, typename Scramble>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+[[msvc::forceinline]]
+#endif
+constexpr void for_each_stripe(::std::size_t size, unsigned char const* secret, Accumulate&& accumulate,
+                               Scramble&& scramble) noexcept {
+    constexpr auto secret_size = ::mcpprt::hash::details::secret_size;
+    constexpr auto stripe_size = ::mcpprt::hash::details::stripe_size;
+    constexpr auto block_size = ::mcpprt::hash::details::block_size;
+    auto blocks = (size - 1) / block_size;
+    for (::std::size_t block{}; block < blocks; ++block) {
+        for (::std::size_t stripe{}; stripe < ::mcpprt::hash::details::stripes_per_block; ++stripe) {
+            accumulate(block * block_size + stripe * stripe_size, secret + stripe * 8);
+        }
+        scramble(secret + secret_size - stripe_size);
+    }
+    auto stripes = (size - 1 - blocks * block_size) / stripe_size;
+    for (::std::size_t stripe{}; stripe < stripes; ++stripe) {
+        accumulate(blocks * block_size + stripe * stripe_size, secret + stripe * 8);
+    }
+    accumulate(size - stripe_size, secret + secret_size - stripe_size - 7);
+}
+
+using accumulators = ::mcpprt::container::array<::std::uint64_t, 8>;
+
+template<typename T>
+constexpr void accumulate_scalar(::mcpprt::hash::details::accumulators& acc, T const* data, ::std::size_t size,
+                                 unsigned char const* secret) noexcept {
+    ::mcpprt::hash::details::for_each_stripe(
+        size, secret,
+        [&acc, data](::std::size_t offset, unsigned char const* key) noexcept {
+            for (::std::size_t i{}; i < 8; ++i) {
+                auto value = ::mcpprt::hash::details::load<8>(data, offset + 8 * i);
+                auto keyed = value ^ ::mcpprt::hash::details::load<8>(key, 8 * i);
+                acc.value_[i ^ 1] += value;
+                acc.value_[i] += (keyed & 0xFFFFFFFFu) * (keyed >> 32);
+            }
+        },
+        [&acc](unsigned char const* key) noexcept {
+            for (::std::size_t i{}; i < 8; ++i) {
+                auto value = acc.value_[i];
+                value ^= value >> 47;
+                value ^= ::mcpprt::hash::details::load<8>(key, 8 * i);
+                acc.value_[i] = value * ::mcpprt::hash::details::prime32_1;
+            }
+        });
+}
+
+#if defined(__SSE2__) || defined(_M_X64)
+
+/**
+ * @brief the same as `accumulate_scalar`, a 64-bit lane per accumulator and 32x32-bit multiplies
+ * @note the accumulators add the neighbouring lane of the input, which is a swap of the 64-bit halves of a pair
+ */
+inline void accumulate_simd(::mcpprt::hash::details::accumulators& acc, unsigned char const* data, ::std::size_t size,
+                            unsigned char const* secret) noexcept {
+    #if defined(__AVX2__)
+    using vector = __m256i;
+    constexpr ::std::size_t lanes = 2;
+    auto const prime = _mm256_set1_epi32(static_cast<int>(::mcpprt::hash::details::prime32_1));
+    auto load = [](void const* from) noexcept { return _mm256_loadu_si256(static_cast<vector const*>(from)); };
+    auto accumulate_lane = [](vector acc_lane, vector value, vector key) noexcept {
+        auto keyed = _mm256_xor_si256(value, key);
+        auto product = _mm256_mul_epu32(keyed, _mm256_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+        auto swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+        return _mm256_add_epi64(product, _mm256_add_epi64(acc_lane, swapped));
+    };
+    auto scramble_lane = [&prime](vector acc_lane, vector key) noexcept {
+        auto keyed = _mm256_xor_si256(_mm256_xor_si256(acc_lane, _mm256_srli_epi64(acc_lane, 47)), key);
+        auto low = _mm256_mul_epu32(keyed, prime);
+        auto high = _mm256_mul_epu32(_mm256_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+        return _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+    };
+    #else
+    using vector = __m128i;
+    constexpr ::std::size_t lanes = 4;
+    auto const prime = _mm_set1_epi32(static_cast<int>(::mcpprt::hash::details::prime32_1));
+    auto load = [](void const* from) noexcept { return _mm_loadu_si128(static_cast<vector const*>(from)); };
+    auto accumulate_lane = [](vector acc_lane, vector value, vector key) noexcept {
+        auto keyed = _mm_xor_si128(value, key);
+        auto product = _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+        auto swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+        return _mm_add_epi64(product, _mm_add_epi64(acc_lane, swapped));
+    };
+    auto scramble_lane = [&prime](vector acc_lane, vector key) noexcept {
+        auto keyed = _mm_xor_si128(_mm_xor_si128(acc_lane, _mm_srli_epi64(acc_lane, 47)), key);
+        auto low = _mm_mul_epu32(keyed, prime);
+        auto high = _mm_mul_epu32(_mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+        return _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+    };
+    #endif
+    constexpr auto width = sizeof(vector);
+    vector lane[lanes];
+    for (::std::size_t i{}; i < lanes; ++i) {
+        lane[i] = load(acc.value_ + i * width / 8);
+    }
+    ::mcpprt::hash::details::for_each_stripe(
+        size, secret,
+        [&](::std::size_t offset, unsigned char const* key) noexcept {
+            for (::std::size_t i{}; i < lanes; ++i) {
+                lane[i] = accumulate_lane(lane[i], load(data + offset + i * width), load(key + i * width));
+            }
+        },
+        [&](unsigned char const* key) noexcept {
+            for (::std::size_t i{}; i < lanes; ++i) {
+                lane[i] = scramble_lane(lane[i], load(key + i * width));
+            }
+        });
+    ::std::memcpy(acc.value_, lane, sizeof(lane));
+}
+
+#endif
+
+/**
+ * @brief inputs longer than 240 bytes
+ * @note a seed is folded into a derived secret, seed 0 derives the default secret itself
+ */
+template<typename T>
+[[nodiscard]]
+constexpr auto hash_long(T const* data, ::std::size_t size, ::std::uint64_t seed) noexcept -> ::std::uint64_t {
+    alignas(64) ::mcpprt::container::array<unsigned char, ::mcpprt::hash::details::secret_size> secret{};
+    auto const* base = ::mcpprt::hash::details::default_secret.value_;
+    for (::std::size_t i{}; i < ::mcpprt::hash::details::secret_size; i += 16) {
+        ::mcpprt::hash::details::store(secret.value_, i, ::mcpprt::hash::details::load<8>(base, i) + seed);
+        ::mcpprt::hash::details::store(secret.value_, i + 8, ::mcpprt::hash::details::load<8>(base, i + 8) - seed);
+    }
+
+    ::mcpprt::hash::details::accumulators acc{
+        {::mcpprt::hash::details::prime32_3, ::mcpprt::hash::details::prime64_1, ::mcpprt::hash::details::prime64_2,
+         ::mcpprt::hash::details::prime64_3, ::mcpprt::hash::details::prime64_4, ::mcpprt::hash::details::prime32_2,
+         ::mcpprt::hash::details::prime64_5, ::mcpprt::hash::details::prime32_1}};
+#if defined(__SSE2__) || defined(_M_X64)
+    if consteval {
+        ::mcpprt::hash::details::accumulate_scalar(acc, data, size, secret.value_);
+    } else {
+        ::mcpprt::hash::details::accumulate_simd(acc, reinterpret_cast<unsigned char const*>(data), size,
+                                                 secret.value_);
+    }
+#else
+    ::mcpprt::hash::details::accumulate_scalar(acc, data, size, secret.value_);
+#endif
+
+    auto result = size * ::mcpprt::hash::details::prime64_1;
+    for (::std::size_t i{}; i < 4; ++i) {
+        result += ::mcpprt::hash::details::mul_fold(
+            acc.value_[2 * i] ^ ::mcpprt::hash::details::load<8>(secret.value_, 11 + 16 * i),
+            acc.value_[2 * i + 1] ^ ::mcpprt::hash::details::load<8>(secret.value_, 11 + 16 * i + 8));
+    }
+    return ::mcpprt::hash::details::avalanche(result);
+}
+
+} // namespace details
+
+/**
+ * @brief XXH3 of the object representation of [data, data + count)
+ * @note equal to `XXH3_64bits_withSeed` of the same bytes, on big-endian targets too
+ */
+template<::mcpprt::hash::is_byte_hashable T>
+[[nodiscard]]
+constexpr auto xxh3(T const* data, ::std::size_t count, ::std::uint64_t seed = 0) noexcept -> ::std::uint64_t {
+    auto size = count * sizeof(T);
+    if (size <= 16) {
+        return ::mcpprt::hash::details::hash_short(data, size, seed);
+    }
+    if (size <= 128) {
+        return ::mcpprt::hash::details::hash_medium(data, size, seed);
+    }
+    if (size <= 240) {
+        return ::mcpprt::hash::details::hash_large(data, size, seed);
+    }
+    return ::mcpprt::hash::details::hash_long(data, size, seed);
+}
+
+/**
+ * @brief XXH3 of `size` bytes of raw memory
+ */
+[[nodiscard]]
+inline auto xxh3(void const* data, ::std::size_t size, ::std::uint64_t seed = 0) noexcept -> ::std::uint64_t {
+    return ::mcpprt::hash::xxh3(static_cast<unsigned char const*>(data), size, seed);
+}
+
+} // namespace mcpprt::hash
@@ -0,0 +1,436 @@
+#pragma once
+
+/**
+ * @file counters.hh
+ * @brief opt-in allocation and container-operation counters
+ * @details define MCPPRT_ENABLE_INSTRUMENT before including any mcpprt header to turn the counters on,
+ *          otherwise every hook is an empty inline function and `site` is an empty type
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <source_location>
+#include <exception/exception.hh>
+#include "../container/array.hh"
+
+#ifndef MCPPRT_INSTRUMENT_MAX_THREADS
+    #define MCPPRT_INSTRUMENT_MAX_THREADS 32
+#endif
+
+#ifndef MCPPRT_INSTRUMENT_MAX_SITES
+    #define MCPPRT_INSTRUMENT_MAX_SITES 64
+#endif
+
+namespace mcpprt::instrument {
+
+#if defined(MCPPRT_ENABLE_INSTRUMENT)
+inline constexpr bool enabled = true;
+#else
+inline constexpr bool enabled = false;
+#endif
+
+inline constexpr ::std::size_t max_threads = MCPPRT_INSTRUMENT_MAX_THREADS;
+inline constexpr ::std::size_t max_sites = MCPPRT_INSTRUMENT_MAX_SITES;
+
+static_assert(max_threads > 0, "MCPPRT_INSTRUMENT_MAX_THREADS must be greater than 0");
+static_assert(max_sites > 1, "MCPPRT_INSTRUMENT_MAX_SITES must be greater than 1");
+
+namespace details {
+
+struct site_enabled {
+    char const* container_{};
+    ::std::source_location where_{};
+};
+
+struct site_disabled {};
+
+struct location_disabled {
+    [[nodiscard]]
+    static consteval auto current() noexcept -> ::mcpprt::instrument::details::location_disabled {
+        return {};
+    }
+};
+
+} // namespace details
+
+/**
+ * @brief the container type and source location an event is attributed to
+ * @note containers store the `site` of their constructor call, use `[[no_unique_address]]`
+ *       so that it costs nothing when instrumentation is disabled
+ */
+using site = ::std::conditional_t<::mcpprt::instrument::enabled, ::mcpprt::instrument::details::site_enabled,
+                                  ::mcpprt::instrument::details::site_disabled>;
+
+/**
+ * @brief `std::source_location` when instrumentation is enabled, an empty type otherwise
+ * @note use `location where = location::current()` as the last parameter of a constructor
+ */
+using location = ::std::conditional_t<::mcpprt::instrument::enabled, ::std::source_location,
+                                      ::mcpprt::instrument::details::location_disabled>;
+
+[[nodiscard]]
+constexpr auto make_site([[maybe_unused]] char const* container,
+                         [[maybe_unused]] ::mcpprt::instrument::location const& where) noexcept
+    -> ::mcpprt::instrument::site {
+#if defined(MCPPRT_ENABLE_INSTRUMENT)
+    return {container, where};
+#else
+    return {};
+#endif
+}
+
+struct counters {
+    ::std::uint64_t allocations{};
+    ::std::uint64_t deallocations{};
+    ::std::uint64_t bytes_allocated{};
+    ::std::uint64_t bytes_deallocated{};
+    ::std::uint64_t reallocations{};
+    ::std::uint64_t growths{};
+    ::std::uint64_t relocated_bytes{};
+    ::std::uint64_t peak_capacity{};
+
+    constexpr void merge(this ::mcpprt::instrument::counters& self,
+                         ::mcpprt::instrument::counters const& other) noexcept {
+        self.allocations += other.allocations;
+        self.deallocations += other.deallocations;
+        self.bytes_allocated += other.bytes_allocated;
+        self.bytes_deallocated += other.bytes_deallocated;
+        self.reallocations += other.reallocations;
+        self.growths += other.growths;
+        self.relocated_bytes += other.relocated_bytes;
+        if (other.peak_capacity > self.peak_capacity) {
+            self.peak_capacity = other.peak_capacity;
+        }
+    }
+};
+
+/**
+ * @note `container` and `file` are nullptr for the bucket that collects sites beyond `max_sites`
+ */
+struct site_counters {
+    char const* container{};
+    char const* file{};
+    ::std::uint_least32_t line{};
+    ::std::uint_least32_t column{};
+    ::mcpprt::instrument::counters value{};
+};
+
+struct snapshot {
+    ::mcpprt::container::array<::mcpprt::instrument::site_counters, ::mcpprt::instrument::max_sites> sites{};
+    ::std::size_t size{};
+    ::mcpprt::instrument::counters total{};
+
+    [[nodiscard]]
+    constexpr auto begin(this ::mcpprt::instrument::snapshot const& self) noexcept {
+        return self.sites.begin();
+    }
+
+    [[nodiscard]]
+    constexpr auto end(this ::mcpprt::instrument::snapshot const& self) noexcept {
+        return self.sites.begin() + self.size;
+    }
+};
+
+#if defined(MCPPRT_ENABLE_INSTRUMENT)
+namespace details {
+
+enum class field : ::std::size_t {
+    allocations,
+    deallocations,
+    bytes_allocated,
+    bytes_deallocated,
+    reallocations,
+    growths,
+    relocated_bytes,
+    peak_capacity,
+    count_,
+};
+
+/**
+ * @brief counters of one site, written only by the thread that owns the record
+ */
+struct slot {
+    ::std::atomic<bool> used_;
+    char const* container_;
+    char const* file_;
+    ::std::uint_least32_t line_;
+    ::std::uint_least32_t column_;
+    ::std::atomic<::std::uint64_t> fields_[static_cast<::std::size_t>(field::count_)];
+};
+
+/**
+ * @note the last slot collects the sites that do not fit in the table
+ */
+struct thread_record {
+    ::mcpprt::instrument::details::slot slots_[::mcpprt::instrument::max_sites];
+};
+
+/**
+ * @brief threads claim records by bumping `claimed_`, records are never released so that
+ *        the counters of exited threads stay in the snapshot
+ * @note threads beyond `max_threads` share `overflow_` and update it with atomic read-modify-write
+ */
+struct registry {
+    ::mcpprt::instrument::details::thread_record records_[::mcpprt::instrument::max_threads];
+    ::mcpprt::instrument::details::thread_record overflow_;
+    ::std::atomic<::std::size_t> claimed_;
+};
+
+inline ::mcpprt::instrument::details::registry registry_{};
+
+inline thread_local ::mcpprt::instrument::details::thread_record* this_thread_{};
+
+[[nodiscard]]
+inline bool is_shared(::mcpprt::instrument::details::thread_record const& record) noexcept {
+    return &record == &::mcpprt::instrument::details::registry_.overflow_;
+}
+
+[[nodiscard]]
+inline auto this_thread() noexcept -> ::mcpprt::instrument::details::thread_record& {
+    auto* record = ::mcpprt::instrument::details::this_thread_;
+    if (record == nullptr) [[unlikely]] {
+        auto index = ::mcpprt::instrument::details::registry_.claimed_.fetch_add(1, ::std::memory_order_relaxed);
+        if (index < ::mcpprt::instrument::max_threads) {
+            record = &::mcpprt::instrument::details::registry_.records_[index];
+        } else {
+            record = &::mcpprt::instrument::details::registry_.overflow_;
+        }
+        ::mcpprt::instrument::details::this_thread_ = record;
+    }
+    return *record;
+}
+
+[[nodiscard]]
+constexpr bool str_equal(char const* lhs, char const* rhs) noexcept {
+    if (lhs == rhs) {
+        return true;
+    }
+    if (lhs == nullptr || rhs == nullptr) {
+        return false;
+    }
+    for (; *lhs != '\0' && *lhs == *rhs; ++lhs, ++rhs) {
+    }
+    return *lhs == *rhs;
+}
+
+[[nodiscard]]
+inline auto find_slot(::mcpprt::instrument::details::thread_record& record,
+                      ::mcpprt::instrument::site const& where) noexcept -> ::mcpprt::instrument::details::slot& {
+    constexpr ::std::size_t capacity = ::mcpprt::instrument::max_sites - 1;
+
+    if (::mcpprt::instrument::details::is_shared(record)) [[unlikely]] {
+        // claiming slots concurrently is not worth it, the overflow record keeps a single bucket
+        return record.slots_[capacity];
+    }
+
+    auto* file = where.where_.file_name();
+    auto line = static_cast<::std::uint_least32_t>(where.where_.line());
+    auto column = static_cast<::std::uint_least32_t>(where.where_.column());
+    auto hash = (reinterpret_cast<::std::uintptr_t>(file) >> 3) ^
+                (reinterpret_cast<::std::uintptr_t>(where.container_) >> 3) ^ (line * 31u + column);
+
+    for (::std::size_t probe{}; probe < capacity; ++probe) {
+        auto& slot = record.slots_[(hash + probe) % capacity];
+        if (slot.used_.load(::std::memory_order_relaxed) == false) {
+            slot.container_ = where.container_;
+            slot.file_ = file;
+            slot.line_ = line;
+            slot.column_ = column;
+            slot.used_.store(true, ::std::memory_order_release);
+            return slot;
+        }
+        if (slot.line_ == line && slot.column_ == column && slot.file_ == file &&
+            slot.container_ == where.container_) {
+            return slot;
+        }
+    }
+    return record.slots_[capacity];
+}
+
+inline void add(::mcpprt::instrument::site const& where, ::mcpprt::instrument::details::field field,
+                ::std::uint64_t value) noexcept {
+    auto& record = ::mcpprt::instrument::details::this_thread();
+    auto& counter = ::mcpprt::instrument::details::find_slot(record, where).fields_[static_cast<::std::size_t>(field)];
+    if (::mcpprt::instrument::details::is_shared(record)) [[unlikely]] {
+        counter.fetch_add(value, ::std::memory_order_relaxed);
+    } else {
+        // single writer, a relaxed load and store avoids the locked instruction
+        counter.store(counter.load(::std::memory_order_relaxed) + value, ::std::memory_order_relaxed);
+    }
+}
+
+inline void max(::mcpprt::instrument::site const& where, ::mcpprt::instrument::details::field field,
+                ::std::uint64_t value) noexcept {
+    auto& record = ::mcpprt::instrument::details::this_thread();
+    auto& counter = ::mcpprt::instrument::details::find_slot(record, where).fields_[static_cast<::std::size_t>(field)];
+    auto old = counter.load(::std::memory_order_relaxed);
+    if (::mcpprt::instrument::details::is_shared(record)) [[unlikely]] {
+        while (old < value && !counter.compare_exchange_weak(old, value, ::std::memory_order_relaxed)) {
+        }
+    } else if (old < value) {
+        counter.store(value, ::std::memory_order_relaxed);
+    }
+}
+
+inline void collect(::mcpprt::instrument::snapshot& result,
+                    ::mcpprt::instrument::details::thread_record const& record) noexcept {
+    for (auto const& slot : record.slots_) {
+        bool is_other = &slot == &record.slots_[::mcpprt::instrument::max_sites - 1];
+        if (!is_other && slot.used_.load(::std::memory_order_acquire) == false) {
+            continue;
+        }
+
+        auto load = [&slot](::mcpprt::instrument::details::field field) noexcept {
+            return slot.fields_[static_cast<::std::size_t>(field)].load(::std::memory_order_relaxed);
+        };
+        ::mcpprt::instrument::counters value{
+            load(field::allocations),   load(field::deallocations), load(field::bytes_allocated),
+            load(field::bytes_deallocated), load(field::reallocations), load(field::growths),
+            load(field::relocated_bytes),   load(field::peak_capacity),
+        };
+        if (is_other && value.allocations == 0 && value.deallocations == 0 && value.reallocations == 0 &&
+            value.growths == 0 && value.relocated_bytes == 0 && value.peak_capacity == 0) {
+            continue;
+        }
+        result.total.merge(value);
+
+        char const* container = is_other ? nullptr : slot.container_;
+        char const* file = is_other ? nullptr : slot.file_;
+        ::std::uint_least32_t line = is_other ? 0u : slot.line_;
+        ::std::uint_least32_t column = is_other ? 0u : slot.column_;
+
+        ::std::size_t i{};
+        for (; i < result.size; ++i) {
+            auto const& entry = result.sites[i];
+            if (entry.line == line && entry.column == column &&
+                ::mcpprt::instrument::details::str_equal(entry.file, file) &&
+                ::mcpprt::instrument::details::str_equal(entry.container, container)) {
+                break;
+            }
+        }
+        if (i == result.size) {
+            if (result.size == ::mcpprt::instrument::max_sites) {
+                // still accounted for in `total`
+                continue;
+            }
+            result.sites[i] = {container, file, line, column, {}};
+            ++result.size;
+        }
+        result.sites[i].value.merge(value);
+    }
+}
+
+} // namespace details
+#endif
+
+/**
+ * @brief a block of `bytes` was obtained from an allocator
+ */
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+[[msvc::forceinline]]
+#endif
+constexpr void on_allocate([[maybe_unused]] ::mcpprt::instrument::site const& where,
+                           [[maybe_unused]] ::std::size_t bytes) noexcept {
+#if defined(MCPPRT_ENABLE_INSTRUMENT)
+    if !consteval {
+        ::mcpprt::instrument::details::add(where, ::mcpprt::instrument::details::field::allocations, 1);
+        ::mcpprt::instrument::details::add(where, ::mcpprt::instrument::details::field::bytes_allocated, bytes);
+    }
+#endif
+}
+
+/**
+ * @brief a block of `bytes` was given back to an allocator
+ */
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+[[msvc::forceinline]]
+#endif
+constexpr void on_deallocate([[maybe_unused]] ::mcpprt::instrument::site const& where,
+                             [[maybe_unused]] ::std::size_t bytes) noexcept {
+#if defined(MCPPRT_ENABLE_INSTRUMENT)
+    if !consteval {
+        ::mcpprt::instrument::details::add(where, ::mcpprt::instrument::details::field::deallocations, 1);
+        ::mcpprt::instrument::details::add(where, ::mcpprt::instrument::details::field::bytes_deallocated, bytes);
+    }
+#endif
+}
+
+/**
+ * @brief the storage was replaced by a new block, the blocks themselves are reported by
+ *        `on_allocate` and `on_deallocate`
+ */
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+[[msvc::forceinline]]
+#endif
+constexpr void on_reallocate([[maybe_unused]] ::mcpprt::instrument::site const& where) noexcept {
+#if defined(MCPPRT_ENABLE_INSTRUMENT)
+    if !consteval {
+        ::mcpprt::instrument::details::add(where, ::mcpprt::instrument::details::field::reallocations, 1);
+    }
+#endif
+}
+
+/**
+ * @brief the capacity grew to `new_capacity` elements
+ */
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+[[msvc::forceinline]]
+#endif
+constexpr void on_grow([[maybe_unused]] ::mcpprt::instrument::site const& where,
+                       [[maybe_unused]] ::std::size_t new_capacity) noexcept {
+#if defined(MCPPRT_ENABLE_INSTRUMENT)
+    if !consteval {
+        ::mcpprt::instrument::details::add(where, ::mcpprt::instrument::details::field::growths, 1);
+        ::mcpprt::instrument::details::max(where, ::mcpprt::instrument::details::field::peak_capacity, new_capacity);
+    }
+#endif
+}
+
+/**
+ * @brief `bytes` of live elements were moved to another address
+ */
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+[[msvc::forceinline]]
+#endif
+constexpr void on_relocate([[maybe_unused]] ::mcpprt::instrument::site const& where,
+                           [[maybe_unused]] ::std::size_t bytes) noexcept {
+#if defined(MCPPRT_ENABLE_INSTRUMENT)
+    if !consteval {
+        ::mcpprt::instrument::details::add(where, ::mcpprt::instrument::details::field::relocated_bytes, bytes);
+    }
+#endif
+}
+
+/**
+ * @brief aggregate the counters of every thread, sites are merged by container name and source location
+ * @note counters are read one by one, events racing with the snapshot may be partially visible
+ */
+[[nodiscard]]
+inline auto take_snapshot() noexcept -> ::mcpprt::instrument::snapshot {
+    ::mcpprt::instrument::snapshot result{};
+#if defined(MCPPRT_ENABLE_INSTRUMENT)
+    auto& registry = ::mcpprt::instrument::details::registry_;
+    auto claimed = registry.claimed_.load(::std::memory_order_acquire);
+    if (claimed > ::mcpprt::instrument::max_threads) {
+        claimed = ::mcpprt::instrument::max_threads;
+    }
+    for (::std::size_t i{}; i < claimed; ++i) {
+        ::mcpprt::instrument::details::collect(result, registry.records_[i]);
+    }
+    ::mcpprt::instrument::details::collect(result, registry.overflow_);
+#endif
+    return result;
+}
+
+} // namespace mcpprt::instrument
@@ -0,0 +1,485 @@
+#pragma once
+
+/**
+ * @file file.hh
+ * @brief buffered file reader and writer over raw system calls
+ * @details writers gather small writes in a buffer and hand everything to the kernel as one `writev`,
+ *          or as one io_uring submission shared by several writers with `flush_all`
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <exception/exception.hh>
+#include "syscall.hh"
+#include "uring.hh"
+
+namespace mcpprt::io {
+
+namespace details {
+
+/**
+ * @brief skip `bytes` already written from the front of an iovec list
+ */
+constexpr void advance(::mcpprt::io::iovec*& iov, ::std::size_t& count, ::std::size_t bytes) noexcept {
+    while (count != 0 && bytes >= iov->size_) {
+        bytes -= iov->size_;
+        ++iov;
+        --count;
+    }
+    if (count != 0 && bytes != 0) {
+        iov->base_ = static_cast<::std::byte const*>(iov->base_) + bytes;
+        iov->size_ -= bytes;
+    }
+}
+
+} // namespace details
+
+enum class open_mode {
+    read,
+    /**
+     * @brief create or truncate
+     */
+    write,
+    /**
+     * @brief create or append
+     */
+    append,
+    read_write,
+};
+
+/**
+ * @brief owns a file descriptor
+ */
+class file {
+    int fd_{-1};
+
+public:
+    constexpr file() noexcept = default;
+
+    /**
+     * @brief adopt an open file descriptor
+     */
+    constexpr explicit file(int fd) noexcept
+        : fd_{fd} {
+    }
+
+    file(::mcpprt::io::file const&) = delete;
+
+    constexpr file(::mcpprt::io::file&& other) noexcept
+        : fd_{::std::exchange(other.fd_, -1)} {
+    }
+
+    file& operator=(::mcpprt::io::file const&) = delete;
+
+    auto&& operator=(this ::mcpprt::io::file& self, ::mcpprt::io::file&& other) noexcept {
+        if (&self != &other) {
+            (void)self.close();
+            self.fd_ = ::std::exchange(other.fd_, -1);
+        }
+        return self;
+    }
+
+    ~file() noexcept {
+        (void)this->close();
+    }
+
+    [[nodiscard]]
+    static auto open(char const* path, ::mcpprt::io::open_mode mode, unsigned permissions = 0644) noexcept
+        -> ::mcpprt::io::result<::mcpprt::io::file> {
+        int flags = ::mcpprt::io::sys::o_cloexec;
+        switch (mode) {
+        case ::mcpprt::io::open_mode::read:
+            flags |= ::mcpprt::io::sys::o_rdonly;
+            break;
+        case ::mcpprt::io::open_mode::write:
+            flags |= ::mcpprt::io::sys::o_wronly | ::mcpprt::io::sys::o_creat | ::mcpprt::io::sys::o_trunc;
+            break;
+        case ::mcpprt::io::open_mode::append:
+            flags |= ::mcpprt::io::sys::o_wronly | ::mcpprt::io::sys::o_creat | ::mcpprt::io::sys::o_append;
+            break;
+        case ::mcpprt::io::open_mode::read_write:
+            flags |= ::mcpprt::io::sys::o_rdwr | ::mcpprt::io::sys::o_creat;
+            break;
+        }
+
+        auto fd = ::mcpprt::io::sys::openat(::mcpprt::io::sys::at_fdcwd, path, flags, permissions);
+        if (!fd.has_value()) {
+            return ::exception::unexpected<::mcpprt::io::error>{fd.error()};
+        }
+        return ::mcpprt::io::file{static_cast<int>(fd.value())};
+    }
+
+    [[nodiscard]]
+    constexpr int fd(this ::mcpprt::io::file const& self) noexcept {
+        return self.fd_;
+    }
+
+    [[nodiscard]]
+    constexpr bool is_open(this ::mcpprt::io::file const& self) noexcept {
+        return self.fd_ >= 0;
+    }
+
+    /**
+     * @return the number of bytes read, 0 at end of file
+     */
+    [[nodiscard]]
+    auto read(this ::mcpprt::io::file const& self, void* buffer, ::std::size_t size) noexcept
+        -> ::mcpprt::io::result<::std::size_t> {
+        while (true) {
+            auto ret = ::mcpprt::io::sys::read(self.fd_, buffer, size);
+            if (ret.has_value()) {
+                return static_cast<::std::size_t>(ret.value());
+            }
+            if (ret.error() != ::mcpprt::io::errc::interrupted) {
+                return ::exception::unexpected<::mcpprt::io::error>{ret.error()};
+            }
+        }
+    }
+
+    /**
+     * @brief write every byte of `iov`, retrying short writes
+     * @note `iov` is advanced in place past the written bytes
+     */
+    [[nodiscard]]
+    auto write_all(this ::mcpprt::io::file const& self, ::mcpprt::io::iovec* iov, ::std::size_t count) noexcept
+        -> ::mcpprt::io::result<::std::size_t> {
+        ::std::size_t total{};
+        while (count != 0) {
+            if (iov->size_ == 0) {
+                ++iov;
+                --count;
+                continue;
+            }
+            auto ret = ::mcpprt::io::sys::writev(self.fd_, iov, count);
+            if (!ret.has_value()) {
+                if (ret.error() == ::mcpprt::io::errc::interrupted) {
+                    continue;
+                }
+                return ::exception::unexpected<::mcpprt::io::error>{ret.error()};
+            }
+            auto written = static_cast<::std::size_t>(ret.value());
+            total += written;
+            ::mcpprt::io::details::advance(iov, count, written);
+        }
+        return total;
+    }
+
+    [[nodiscard]]
+    auto write_all(this ::mcpprt::io::file const& self, void const* buffer, ::std::size_t size) noexcept
+        -> ::mcpprt::io::result<::std::size_t> {
+        ::mcpprt::io::iovec iov{buffer, size};
+        return self.write_all(&iov, 1);
+    }
+
+    [[nodiscard]]
+    auto sync(this ::mcpprt::io::file const& self) noexcept -> ::mcpprt::io::result<long> {
+        return ::mcpprt::io::sys::fsync(self.fd_);
+    }
+
+    auto close(this ::mcpprt::io::file& self) noexcept -> ::mcpprt::io::result<long> {
+        if (self.fd_ < 0) {
+            return 0l;
+        }
+        return ::mcpprt::io::sys::close(::std::exchange(self.fd_, -1));
+    }
+};
+
+[[nodiscard]]
+inline auto remove(char const* path) noexcept -> ::mcpprt::io::result<long> {
+    return ::mcpprt::io::sys::unlinkat(::mcpprt::io::sys::at_fdcwd, path, 0);
+}
+
+/**
+ * @brief buffered reader, reads larger than the buffer bypass it
+ */
+template<::std::size_t BufferSize = 64 * 1024>
+class reader {
+    static_assert(BufferSize > 0, "BufferSize must be greater than 0");
+
+    ::mcpprt::io::file file_;
+    ::std::size_t begin_{};
+    ::std::size_t end_{};
+    ::std::byte buffer_[BufferSize];
+
+public:
+    constexpr explicit reader(::mcpprt::io::file&& file) noexcept
+        : file_{::std::move(file)} {
+    }
+
+    reader(::mcpprt::io::reader<BufferSize> const&) = delete;
+
+    reader& operator=(::mcpprt::io::reader<BufferSize> const&) = delete;
+
+    /**
+     * @return the number of bytes read, 0 at end of file
+     */
+    [[nodiscard]]
+    auto read(this ::mcpprt::io::reader<BufferSize>& self, void* buffer, ::std::size_t size) noexcept
+        -> ::mcpprt::io::result<::std::size_t> {
+        if (self.begin_ == self.end_) {
+            if (size >= BufferSize) {
+                return self.file_.read(buffer, size);
+            }
+            auto filled = self.file_.read(self.buffer_, BufferSize);
+            if (!filled.has_value()) {
+                return filled;
+            }
+            self.begin_ = 0;
+            self.end_ = filled.value();
+        }
+
+        auto count = ::std::min(size, self.end_ - self.begin_);
+        ::std::copy_n(self.buffer_ + self.begin_, count, static_cast<::std::byte*>(buffer));
+        self.begin_ += count;
+        return count;
+    }
+
+    /**
+     * @brief read until `size` bytes or end of file
+     */
+    [[nodiscard]]
+    auto read_full(this ::mcpprt::io::reader<BufferSize>& self, void* buffer, ::std::size_t size) noexcept
+        -> ::mcpprt::io::result<::std::size_t> {
+        auto* out = static_cast<::std::byte*>(buffer);
+        ::std::size_t total{};
+        while (total < size) {
+            auto ret = self.read(out + total, size - total);
+            if (!ret.has_value()) {
+                return ret;
+            }
+            if (ret.value() == 0) {
+                break;
+            }
+            total += ret.value();
+        }
+        return total;
+    }
+
+    [[nodiscard]]
+    constexpr auto file(this auto&& self) noexcept -> auto&& {
+        return ::std::forward_like<decltype(self)>(self.file_);
+    }
+};
+
+/**
+ * @brief buffered writer
+ * @details pieces up to a quarter of the buffer are copied, larger ones are referenced in place and written
+ *          together with the buffered bytes by a single `writev` before the call returns
+ */
+template<::std::size_t BufferSize = 64 * 1024>
+class writer {
+    static_assert(BufferSize >= 4, "BufferSize must be at least 4");
+
+    static constexpr ::std::size_t gather_max = 16;
+    static constexpr ::std::size_t copy_threshold = BufferSize / 4;
+
+    ::mcpprt::io::file file_;
+    ::mcpprt::io::ring* ring_{};
+    ::mcpprt::io::completion completion_{};
+    ::std::size_t size_{};
+    ::std::size_t gather_size_{};
+    bool external_{};
+    ::mcpprt::io::iovec gather_[gather_max];
+    ::std::byte buffer_[BufferSize];
+
+    void append(this ::mcpprt::io::writer<BufferSize>& self, ::mcpprt::io::iovec const& piece) noexcept {
+        auto* dst = self.buffer_ + self.size_;
+        ::std::copy_n(static_cast<::std::byte const*>(piece.base_), piece.size_, dst);
+        self.size_ += piece.size_;
+        if (self.gather_size_ != 0) {
+            auto& last = self.gather_[self.gather_size_ - 1];
+            if (static_cast<::std::byte const*>(last.base_) + last.size_ == dst) {
+                last.size_ += piece.size_;
+                return;
+            }
+        }
+        self.gather_[self.gather_size_++] = {dst, piece.size_};
+    }
+
+    [[nodiscard]]
+    auto pending_bytes(this ::mcpprt::io::writer<BufferSize> const& self) noexcept -> ::std::size_t {
+        ::std::size_t total{};
+        for (::std::size_t i{}; i < self.gather_size_; ++i) {
+            total += self.gather_[i].size_;
+        }
+        return total;
+    }
+
+    void reset(this ::mcpprt::io::writer<BufferSize>& self) noexcept {
+        self.size_ = 0;
+        self.gather_size_ = 0;
+        self.external_ = false;
+    }
+
+public:
+    /**
+     * @param ring: submit flushes through this ring instead of `writev`, must outlive the writer
+     */
+    constexpr explicit writer(::mcpprt::io::file&& file, ::mcpprt::io::ring* ring = nullptr) noexcept
+        : file_{::std::move(file)},
+          ring_{ring} {
+    }
+
+    writer(::mcpprt::io::writer<BufferSize> const&) = delete;
+
+    writer& operator=(::mcpprt::io::writer<BufferSize> const&) = delete;
+
+    /**
+     * @note errors are dropped, call `flush` first to observe them
+     */
+    ~writer() noexcept {
+        (void)this->flush();
+    }
+
+    [[nodiscard]]
+    auto write_vectored(this ::mcpprt::io::writer<BufferSize>& self, ::mcpprt::io::iovec const* iov,
+                        ::std::size_t count) noexcept -> ::mcpprt::io::result<::std::size_t> {
+        ::std::size_t total{};
+        for (::std::size_t i{}; i < count; ++i) {
+            auto const& piece = iov[i];
+            if (piece.size_ == 0) {
+                continue;
+            }
+            bool copy = piece.size_ <= copy_threshold;
+            if (self.gather_size_ == gather_max || (copy && piece.size_ > BufferSize - self.size_)) {
+                if (auto ret = self.flush(); !ret.has_value()) {
+                    return ret;
+                }
+            }
+            if (copy) {
+                self.append(piece);
+            } else {
+                self.gather_[self.gather_size_++] = piece;
+                self.external_ = true;
+            }
+            total += piece.size_;
+        }
+        // the caller's memory must not be referenced after returning
+        if (self.external_) {
+            if (auto ret = self.flush(); !ret.has_value()) {
+                return ret;
+            }
+        }
+        return total;
+    }
+
+    [[nodiscard]]
+    auto write(this ::mcpprt::io::writer<BufferSize>& self, void const* data, ::std::size_t size) noexcept
+        -> ::mcpprt::io::result<::std::size_t> {
+        if (size <= BufferSize - self.size_ && size <= copy_threshold && self.gather_size_ < gather_max) [[likely]] {
+            self.append({data, size});
+            return size;
+        }
+        ::mcpprt::io::iovec piece{data, size};
+        return self.write_vectored(&piece, 1);
+    }
+
+    /**
+     * @brief queue the pending bytes on the ring without submitting, see `flush_all`
+     * @return false if nothing was queued, either because nothing is pending or the ring is full
+     */
+    [[nodiscard]]
+    bool prepare_flush(this ::mcpprt::io::writer<BufferSize>& self, ::mcpprt::io::ring& ring) noexcept {
+        self.completion_ = {};
+        if (self.gather_size_ == 0) {
+            return false;
+        }
+        return ring.prepare_writev(self.file_.fd(), self.gather_, static_cast<unsigned>(self.gather_size_),
+                                   self.completion_);
+    }
+
+    /**
+     * @brief finish a flush started by `prepare_flush`, short or unsubmitted writes complete synchronously
+     */
+    [[nodiscard]]
+    auto finish_flush(this ::mcpprt::io::writer<BufferSize>& self) noexcept -> ::mcpprt::io::result<::std::size_t> {
+        if (self.gather_size_ == 0) {
+            return ::std::size_t{};
+        }
+        ::std::size_t written{};
+        if (self.completion_.done_) {
+            if (self.completion_.result_ < 0) {
+                self.reset();
+                return ::exception::unexpected<::mcpprt::io::error>{{static_cast<int>(-self.completion_.result_)}};
+            }
+            written = static_cast<::std::size_t>(self.completion_.result_);
+        }
+        self.completion_ = {};
+
+        auto* iov = self.gather_;
+        auto count = self.gather_size_;
+        ::mcpprt::io::details::advance(iov, count, written);
+        auto ret = self.file_.write_all(iov, count);
+        self.reset();
+        if (!ret.has_value()) {
+            return ret;
+        }
+        return written + ret.value();
+    }
+
+    /**
+     * @return the number of bytes handed to the kernel
+     */
+    auto flush(this ::mcpprt::io::writer<BufferSize>& self) noexcept -> ::mcpprt::io::result<::std::size_t> {
+        // if the submission fails the operation is withdrawn and `finish_flush` writes synchronously
+        if (self.ring_ != nullptr && self.prepare_flush(*self.ring_)) {
+            if (auto submitted = self.ring_->submit(); submitted.has_value() && submitted.value() != 0) {
+                // returns only once the kernel is done with the buffer
+                if (auto waited = self.ring_->wait(submitted.value()); !waited.has_value()) {
+                    (void)self.finish_flush();
+                    return ::exception::unexpected<::mcpprt::io::error>{waited.error()};
+                }
+            }
+        }
+        return self.finish_flush();
+    }
+
+    [[nodiscard]]
+    auto buffered(this ::mcpprt::io::writer<BufferSize> const& self) noexcept -> ::std::size_t {
+        return self.pending_bytes();
+    }
+
+    [[nodiscard]]
+    constexpr auto file(this auto&& self) noexcept -> auto&& {
+        return ::std::forward_like<decltype(self)>(self.file_);
+    }
+};
+
+/**
+ * @brief flush several writers with a single io_uring submission
+ * @return the number of bytes flushed, or the first error
+ */
+template<::std::size_t... BufferSizes>
+auto flush_all(::mcpprt::io::ring& ring, ::mcpprt::io::writer<BufferSizes>&... writers) noexcept
+    -> ::mcpprt::io::result<::std::size_t> {
+    unsigned queued = (0u + ... + (writers.prepare_flush(ring) ? 1u : 0u));
+    ::exception::optional<::mcpprt::io::error> failure{::exception::nullopt_t{}};
+    if (queued != 0) {
+        // writers whose operation was not submitted finish synchronously, the others only once their
+        // operation has completed, so that no byte is written twice
+        if (auto submitted = ring.submit(); submitted.has_value()) {
+            if (auto waited = ring.wait(submitted.value()); !waited.has_value()) {
+                failure = waited.error();
+            }
+        }
+    }
+
+    ::std::size_t total{};
+    auto finish = [&](auto& writer) noexcept {
+        auto ret = writer.finish_flush();
+        if (ret.has_value()) {
+            total += ret.value();
+        } else if (!failure.has_value()) {
+            failure = ret.error();
+        }
+    };
+    (finish(writers), ...);
+
+    if (failure.has_value()) {
+        return ::exception::unexpected<::mcpprt::io::error>{failure.value()};
+    }
+    return total;
+}
+
+} // namespace mcpprt::io
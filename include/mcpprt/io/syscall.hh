@@ -0,0 +1,223 @@
+#pragma once
+
+/**
+ * @file syscall.hh
+ * @brief raw Linux system calls, no libc involved
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <exception/exception.hh>
+
+#if !defined(__linux__)
+    #error "mcpprt/io requires Linux"
+#endif
+
+#if !defined(__x86_64__) && !defined(__aarch64__)
+    #error "mcpprt/io supports x86_64 and aarch64 only"
+#endif
+
+namespace mcpprt::io {
+
+/**
+ * @brief errno value of a failed system call
+ */
+struct error {
+    int code_{};
+
+    [[nodiscard]]
+    constexpr bool operator==(this ::mcpprt::io::error const& self, ::mcpprt::io::error const& other) noexcept {
+        return self.code_ == other.code_;
+    }
+};
+
+namespace errc {
+
+inline constexpr ::mcpprt::io::error permission{1};
+inline constexpr ::mcpprt::io::error no_entry{2};
+inline constexpr ::mcpprt::io::error interrupted{4};
+inline constexpr ::mcpprt::io::error io{5};
+inline constexpr ::mcpprt::io::error bad_file{9};
+inline constexpr ::mcpprt::io::error again{11};
+inline constexpr ::mcpprt::io::error busy{16};
+inline constexpr ::mcpprt::io::error invalid{22};
+inline constexpr ::mcpprt::io::error no_space{28};
+inline constexpr ::mcpprt::io::error not_supported{38};
+
+} // namespace errc
+
+template<typename T>
+using result = ::exception::expected<T, ::mcpprt::io::error>;
+
+/**
+ * @brief layout-compatible with the kernel `struct iovec`
+ */
+struct iovec {
+    void const* base_{};
+    ::std::size_t size_{};
+};
+
+namespace sys {
+
+#if defined(__x86_64__)
+inline constexpr long nr_read = 0;
+inline constexpr long nr_write = 1;
+inline constexpr long nr_close = 3;
+inline constexpr long nr_lseek = 8;
+inline constexpr long nr_mmap = 9;
+inline constexpr long nr_munmap = 11;
+inline constexpr long nr_writev = 20;
+inline constexpr long nr_fsync = 74;
+inline constexpr long nr_openat = 257;
+inline constexpr long nr_unlinkat = 263;
+#elif defined(__aarch64__)
+inline constexpr long nr_read = 63;
+inline constexpr long nr_write = 64;
+inline constexpr long nr_close = 57;
+inline constexpr long nr_lseek = 62;
+inline constexpr long nr_mmap = 222;
+inline constexpr long nr_munmap = 215;
+inline constexpr long nr_writev = 66;
+inline constexpr long nr_fsync = 82;
+inline constexpr long nr_openat = 56;
+inline constexpr long nr_unlinkat = 35;
+#endif
+inline constexpr long nr_io_uring_setup = 425;
+inline constexpr long nr_io_uring_enter = 426;
+
+inline constexpr int at_fdcwd = -100;
+
+inline constexpr int o_rdonly = 00;
+inline constexpr int o_wronly = 01;
+inline constexpr int o_rdwr = 02;
+inline constexpr int o_creat = 0100;
+inline constexpr int o_trunc = 01000;
+inline constexpr int o_append = 02000;
+inline constexpr int o_cloexec = 02000000;
+
+inline constexpr int prot_read = 0x1;
+inline constexpr int prot_write = 0x2;
+inline constexpr int map_shared = 0x01;
+inline constexpr int map_populate = 0x08000;
+
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline long syscall(long number, long a1 = 0, long a2 = 0, long a3 = 0, long a4 = 0, long a5 = 0,
+                    long a6 = 0) noexcept {
+#if defined(__x86_64__)
+    long ret;
+    register long r10 __asm__("r10") = a4;
+    register long r8 __asm__("r8") = a5;
+    register long r9 __asm__("r9") = a6;
+    __asm__ volatile("syscall"
+                     : "=a"(ret)
+                     : "a"(number), "D"(a1), "S"(a2), "d"(a3), "r"(r10), "r"(r8), "r"(r9)
+                     : "rcx", "r11", "memory");
+    return ret;
+#elif defined(__aarch64__)
+    register long x8 __asm__("x8") = number;
+    register long x0 __asm__("x0") = a1;
+    register long x1 __asm__("x1") = a2;
+    register long x2 __asm__("x2") = a3;
+    register long x3 __asm__("x3") = a4;
+    register long x4 __asm__("x4") = a5;
+    register long x5 __asm__("x5") = a6;
+    __asm__ volatile("svc 0" : "+r"(x0) : "r"(x8), "r"(x1), "r"(x2), "r"(x3), "r"(x4), "r"(x5) : "memory", "cc");
+    return x0;
+#endif
+}
+
+/**
+ * @brief the kernel returns -errno in [-4095, -1] on failure
+ */
+[[nodiscard]]
+constexpr auto to_result(long ret) noexcept -> ::mcpprt::io::result<long> {
+    if (ret < 0 && ret > -4096) [[unlikely]] {
+        return ::exception::unexpected<::mcpprt::io::error>{{static_cast<int>(-ret)}};
+    }
+    return ret;
+}
+
+template<typename T>
+[[nodiscard]]
+inline long arg(T* ptr) noexcept {
+    return static_cast<long>(reinterpret_cast<::std::uintptr_t>(ptr));
+}
+
+[[nodiscard]]
+inline auto openat(int dirfd, char const* path, int flags, unsigned mode) noexcept -> ::mcpprt::io::result<long> {
+    return ::mcpprt::io::sys::to_result(::mcpprt::io::sys::syscall(::mcpprt::io::sys::nr_openat, dirfd,
+                                                                   ::mcpprt::io::sys::arg(path), flags, mode));
+}
+
+[[nodiscard]]
+inline auto close(int fd) noexcept -> ::mcpprt::io::result<long> {
+    return ::mcpprt::io::sys::to_result(::mcpprt::io::sys::syscall(::mcpprt::io::sys::nr_close, fd));
+}
+
+[[nodiscard]]
+inline auto read(int fd, void* buffer, ::std::size_t size) noexcept -> ::mcpprt::io::result<long> {
+    return ::mcpprt::io::sys::to_result(::mcpprt::io::sys::syscall(
+        ::mcpprt::io::sys::nr_read, fd, ::mcpprt::io::sys::arg(buffer), static_cast<long>(size)));
+}
+
+[[nodiscard]]
+inline auto write(int fd, void const* buffer, ::std::size_t size) noexcept -> ::mcpprt::io::result<long> {
+    return ::mcpprt::io::sys::to_result(::mcpprt::io::sys::syscall(
+        ::mcpprt::io::sys::nr_write, fd, ::mcpprt::io::sys::arg(buffer), static_cast<long>(size)));
+}
+
+[[nodiscard]]
+inline auto writev(int fd, ::mcpprt::io::iovec const* iov, ::std::size_t count) noexcept
+    -> ::mcpprt::io::result<long> {
+    return ::mcpprt::io::sys::to_result(::mcpprt::io::sys::syscall(
+        ::mcpprt::io::sys::nr_writev, fd, ::mcpprt::io::sys::arg(iov), static_cast<long>(count)));
+}
+
+[[nodiscard]]
+inline auto lseek(int fd, long offset, int whence) noexcept -> ::mcpprt::io::result<long> {
+    return ::mcpprt::io::sys::to_result(::mcpprt::io::sys::syscall(::mcpprt::io::sys::nr_lseek, fd, offset, whence));
+}
+
+[[nodiscard]]
+inline auto fsync(int fd) noexcept -> ::mcpprt::io::result<long> {
+    return ::mcpprt::io::sys::to_result(::mcpprt::io::sys::syscall(::mcpprt::io::sys::nr_fsync, fd));
+}
+
+[[nodiscard]]
+inline auto unlinkat(int dirfd, char const* path, int flags) noexcept -> ::mcpprt::io::result<long> {
+    return ::mcpprt::io::sys::to_result(
+        ::mcpprt::io::sys::syscall(::mcpprt::io::sys::nr_unlinkat, dirfd, ::mcpprt::io::sys::arg(path), flags));
+}
+
+[[nodiscard]]
+inline auto mmap(void* addr, ::std::size_t size, int prot, int flags, int fd, long offset) noexcept
+    -> ::mcpprt::io::result<long> {
+    return ::mcpprt::io::sys::to_result(::mcpprt::io::sys::syscall(::mcpprt::io::sys::nr_mmap,
+                                                                   ::mcpprt::io::sys::arg(addr),
+                                                                   static_cast<long>(size), prot, flags, fd, offset));
+}
+
+[[nodiscard]]
+inline auto munmap(void* addr, ::std::size_t size) noexcept -> ::mcpprt::io::result<long> {
+    return ::mcpprt::io::sys::to_result(::mcpprt::io::sys::syscall(
+        ::mcpprt::io::sys::nr_munmap, ::mcpprt::io::sys::arg(addr), static_cast<long>(size)));
+}
+
+[[nodiscard]]
+inline auto io_uring_setup(unsigned entries, void* params) noexcept -> ::mcpprt::io::result<long> {
+    return ::mcpprt::io::sys::to_result(::mcpprt::io::sys::syscall(::mcpprt::io::sys::nr_io_uring_setup, entries,
+                                                                   ::mcpprt::io::sys::arg(params)));
+}
+
+[[nodiscard]]
+inline auto io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) noexcept
+    -> ::mcpprt::io::result<long> {
+    return ::mcpprt::io::sys::to_result(::mcpprt::io::sys::syscall(::mcpprt::io::sys::nr_io_uring_enter, fd,
+                                                                   to_submit, min_complete, flags, 0, 0));
+}
+
+} // namespace sys
+
+} // namespace mcpprt::io
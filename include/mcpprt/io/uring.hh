@@ -0,0 +1,304 @@
+#pragma once
+
+/**
+ * @file uring.hh
+ * @brief minimal io_uring submission ring for batching writes into one system call
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <linux/io_uring.h>
+#include <exception/exception.hh>
+#include "syscall.hh"
+
+namespace mcpprt::io {
+
+/**
+ * @brief filled in by `ring::reap` once the operation it was submitted with completes
+ */
+struct completion {
+    long result_{};
+    bool done_{};
+};
+
+namespace details {
+
+struct ring_state {
+    int fd_{-1};
+    unsigned features_{};
+    void* sq_ring_{};
+    ::std::size_t sq_ring_size_{};
+    void* cq_ring_{};
+    ::std::size_t cq_ring_size_{};
+    ::io_uring_sqe* sqes_{};
+    ::std::size_t sqes_size_{};
+
+    unsigned* sq_head_{};
+    unsigned* sq_tail_{};
+    unsigned* sq_array_{};
+    unsigned sq_mask_{};
+    unsigned sq_entries_{};
+
+    unsigned* cq_head_{};
+    unsigned* cq_tail_{};
+    ::io_uring_cqe* cqes_{};
+    unsigned cq_mask_{};
+
+    /**
+     * @brief prepared but not yet submitted
+     */
+    unsigned pending_{};
+};
+
+template<typename T>
+[[nodiscard]]
+inline auto at_offset(void* base, unsigned offset) noexcept -> T* {
+    return reinterpret_cast<T*>(static_cast<::std::byte*>(base) + offset);
+}
+
+} // namespace details
+
+/**
+ * @brief an io_uring instance owned by one thread
+ * @note `create` fails with ENOSYS or EPERM where io_uring is unavailable or filtered,
+ *       callers are expected to fall back to plain system calls
+ */
+class ring {
+    ::mcpprt::io::details::ring_state state_{};
+
+    constexpr ring() noexcept = default;
+
+public:
+    ring(::mcpprt::io::ring const&) = delete;
+
+    constexpr ring(::mcpprt::io::ring&& other) noexcept
+        : state_{::std::exchange(other.state_, {})} {
+    }
+
+    ring& operator=(::mcpprt::io::ring const&) = delete;
+
+    auto&& operator=(this ::mcpprt::io::ring& self, ::mcpprt::io::ring&& other) noexcept {
+        if (&self != &other) {
+            self.release();
+            self.state_ = ::std::exchange(other.state_, {});
+        }
+        return self;
+    }
+
+    ~ring() noexcept {
+        this->release();
+    }
+
+    [[nodiscard]]
+    static auto create(unsigned entries) noexcept -> ::mcpprt::io::result<::mcpprt::io::ring> {
+        ::io_uring_params params{};
+        auto fd = ::mcpprt::io::sys::io_uring_setup(entries, &params);
+        if (!fd.has_value()) {
+            return ::exception::unexpected<::mcpprt::io::error>{fd.error()};
+        }
+
+        ::mcpprt::io::ring result{};
+        auto& state = result.state_;
+        state.fd_ = static_cast<int>(fd.value());
+        state.features_ = params.features;
+        // writes at offset -1 must use and advance the file position, like write(2)
+        if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+            return ::exception::unexpected<::mcpprt::io::error>{::mcpprt::io::errc::not_supported};
+        }
+
+        state.sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        state.cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe);
+        bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap && state.cq_ring_size_ > state.sq_ring_size_) {
+            state.sq_ring_size_ = state.cq_ring_size_;
+        }
+
+        auto map = [&state](::std::size_t size, ::std::uint64_t offset) noexcept {
+            return ::mcpprt::io::sys::mmap(nullptr, size, ::mcpprt::io::sys::prot_read | ::mcpprt::io::sys::prot_write,
+                                          ::mcpprt::io::sys::map_shared | ::mcpprt::io::sys::map_populate, state.fd_,
+                                          static_cast<long>(offset));
+        };
+
+        auto sq_ring = map(state.sq_ring_size_, IORING_OFF_SQ_RING);
+        if (!sq_ring.has_value()) {
+            return ::exception::unexpected<::mcpprt::io::error>{sq_ring.error()};
+        }
+        state.sq_ring_ = reinterpret_cast<void*>(sq_ring.value());
+
+        if (single_mmap) {
+            state.cq_ring_ = state.sq_ring_;
+        } else {
+            auto cq_ring = map(state.cq_ring_size_, IORING_OFF_CQ_RING);
+            if (!cq_ring.has_value()) {
+                return ::exception::unexpected<::mcpprt::io::error>{cq_ring.error()};
+            }
+            state.cq_ring_ = reinterpret_cast<void*>(cq_ring.value());
+        }
+
+        state.sqes_size_ = params.sq_entries * sizeof(::io_uring_sqe);
+        auto sqes = map(state.sqes_size_, IORING_OFF_SQES);
+        if (!sqes.has_value()) {
+            return ::exception::unexpected<::mcpprt::io::error>{sqes.error()};
+        }
+        state.sqes_ = reinterpret_cast<::io_uring_sqe*>(sqes.value());
+
+        using ::mcpprt::io::details::at_offset;
+        state.sq_head_ = at_offset<unsigned>(state.sq_ring_, params.sq_off.head);
+        state.sq_tail_ = at_offset<unsigned>(state.sq_ring_, params.sq_off.tail);
+        state.sq_array_ = at_offset<unsigned>(state.sq_ring_, params.sq_off.array);
+        state.sq_mask_ = *at_offset<unsigned>(state.sq_ring_, params.sq_off.ring_mask);
+        state.sq_entries_ = *at_offset<unsigned>(state.sq_ring_, params.sq_off.ring_entries);
+        state.cq_head_ = at_offset<unsigned>(state.cq_ring_, params.cq_off.head);
+        state.cq_tail_ = at_offset<unsigned>(state.cq_ring_, params.cq_off.tail);
+        state.cqes_ = at_offset<::io_uring_cqe>(state.cq_ring_, params.cq_off.cqes);
+        state.cq_mask_ = *at_offset<unsigned>(state.cq_ring_, params.cq_off.ring_mask);
+
+        return result;
+    }
+
+    /**
+     * @brief queue a vectored write at the current file position, nothing is submitted yet
+     * @param done: completed by `reap`, must stay alive until then
+     * @return false when the submission queue is full
+     */
+    [[nodiscard]]
+    bool prepare_writev(this ::mcpprt::io::ring& self, int fd, ::mcpprt::io::iovec const* iov, unsigned count,
+                        ::mcpprt::io::completion& done) noexcept {
+        auto& state = self.state_;
+        auto tail = *state.sq_tail_;
+        auto head = ::std::atomic_ref<unsigned>{*state.sq_head_}.load(::std::memory_order_acquire);
+        if (tail - head >= state.sq_entries_) {
+            return false;
+        }
+
+        auto index = tail & state.sq_mask_;
+        auto& sqe = state.sqes_[index];
+        sqe = ::io_uring_sqe{};
+        sqe.opcode = IORING_OP_WRITEV;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<::std::uintptr_t>(iov);
+        sqe.len = count;
+        sqe.off = static_cast<::std::uint64_t>(-1);
+        sqe.user_data = reinterpret_cast<::std::uintptr_t>(&done);
+        state.sq_array_[index] = index;
+
+        done = {};
+        ::std::atomic_ref<unsigned>{*state.sq_tail_}.store(tail + 1, ::std::memory_order_release);
+        ++state.pending_;
+        return true;
+    }
+
+    /**
+     * @brief hand every prepared operation to the kernel with one system call
+     * @return the number of operations submitted, an error only when none was. Operations the kernel
+     *         refused are withdrawn and their completions are never marked done
+     */
+    auto submit(this ::mcpprt::io::ring& self) noexcept -> ::mcpprt::io::result<unsigned> {
+        auto& state = self.state_;
+        unsigned submitted{};
+        while (state.pending_ != 0) {
+            auto ret = ::mcpprt::io::sys::io_uring_enter(state.fd_, state.pending_, 0, 0);
+            if (!ret.has_value()) {
+                if (ret.error() == ::mcpprt::io::errc::interrupted) {
+                    continue;
+                }
+                self.withdraw();
+                if (submitted != 0) {
+                    // the submitted ones are in flight, the caller must still wait for them
+                    break;
+                }
+                return ::exception::unexpected<::mcpprt::io::error>{ret.error()};
+            }
+            auto count = static_cast<unsigned>(ret.value());
+            if (count == 0) {
+                self.withdraw();
+                break;
+            }
+            state.pending_ -= count;
+            submitted += count;
+        }
+        return submitted;
+    }
+
+    /**
+     * @brief complete every finished operation without blocking
+     * @return the number of completions reaped
+     */
+    auto reap(this ::mcpprt::io::ring& self) noexcept -> unsigned {
+        auto& state = self.state_;
+        auto head = *state.cq_head_;
+        auto tail = ::std::atomic_ref<unsigned>{*state.cq_tail_}.load(::std::memory_order_acquire);
+        unsigned count{};
+        for (; head != tail; ++head, ++count) {
+            auto const& cqe = state.cqes_[head & state.cq_mask_];
+            auto* done = reinterpret_cast<::mcpprt::io::completion*>(static_cast<::std::uintptr_t>(cqe.user_data));
+            done->result_ = cqe.res;
+            done->done_ = true;
+        }
+        ::std::atomic_ref<unsigned>{*state.cq_head_}.store(head, ::std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief block until `count` operations have completed
+     * @return the first transient error of waiting, reported only once the operations have completed anyway,
+     *         because until then the kernel may still use their buffers. Any other error is returned at once,
+     *         no completion can arrive after it and the ring must not be used again.
+     */
+    auto wait(this ::mcpprt::io::ring& self, unsigned count) noexcept -> ::mcpprt::io::result<unsigned> {
+        ::exception::optional<::mcpprt::io::error> failure{::exception::nullopt_t{}};
+        unsigned reaped = self.reap();
+        while (reaped < count) {
+            auto ret = ::mcpprt::io::sys::io_uring_enter(self.state_.fd_, 0, count - reaped, IORING_ENTER_GETEVENTS);
+            if (!ret.has_value() && ret.error() != ::mcpprt::io::errc::interrupted) {
+                if (ret.error() != ::mcpprt::io::errc::again && ret.error() != ::mcpprt::io::errc::busy) {
+                    return ::exception::unexpected<::mcpprt::io::error>{ret.error()};
+                }
+                if (!failure.has_value()) {
+                    failure = ret.error();
+                }
+            }
+            reaped += self.reap();
+        }
+        if (failure.has_value()) {
+            return ::exception::unexpected<::mcpprt::io::error>{failure.value()};
+        }
+        return reaped;
+    }
+
+    /**
+     * @brief take back the prepared operations, their completions are never marked done and the callers
+     *        complete the work themselves
+     * @note the kernel reads the submission queue only inside `io_uring_enter` without SQPOLL, so moving
+     *       the tail back is safe
+     */
+    void withdraw(this ::mcpprt::io::ring& self) noexcept {
+        auto& state = self.state_;
+        ::std::atomic_ref<unsigned>{*state.sq_tail_}.store(*state.sq_tail_ - state.pending_,
+                                                           ::std::memory_order_release);
+        state.pending_ = 0;
+    }
+
+private:
+
+    void release(this ::mcpprt::io::ring& self) noexcept {
+        auto& state = self.state_;
+        if (state.sqes_ != nullptr) {
+            (void)::mcpprt::io::sys::munmap(state.sqes_, state.sqes_size_);
+        }
+        if (state.cq_ring_ != nullptr && state.cq_ring_ != state.sq_ring_) {
+            (void)::mcpprt::io::sys::munmap(state.cq_ring_, state.cq_ring_size_);
+        }
+        if (state.sq_ring_ != nullptr) {
+            (void)::mcpprt::io::sys::munmap(state.sq_ring_, state.sq_ring_size_);
+        }
+        if (state.fd_ >= 0) {
+            (void)::mcpprt::io::sys::close(state.fd_);
+        }
+        state = {};
+    }
+};
+
+} // namespace mcpprt::io
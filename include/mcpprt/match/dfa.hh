@@ -0,0 +1,307 @@
+#pragma once
+
+/**
+ * @file dfa.hh
+ * @brief table-driven automata built in constant evaluation, shared by the keyword and regex matchers
+ * @details bytes are first mapped to the classes the automaton can tell apart, a transition is then one load
+ *          from a row of `Classes` entries. States are stored premultiplied by the row length, and the top bit of
+ *          a state marks it accepting, so the inner loop is a load, an add and a test.
+ */
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <exception/exception.hh>
+#include "../container/array.hh"
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <immintrin.h>
+#endif
+
+namespace mcpprt::match::details {
+
+/**
+ * @brief set of byte values
+ */
+using byte_set = ::mcpprt::container::array<::std::uint64_t, 4>;
+
+[[nodiscard]]
+constexpr bool contains(::mcpprt::match::details::byte_set const& set, unsigned char byte) noexcept {
+    return (set.value_[byte >> 6] >> (byte & 63)) & 1;
+}
+
+constexpr void insert(::mcpprt::match::details::byte_set& set, unsigned char byte) noexcept {
+    set.value_[byte >> 6] |= ::std::uint64_t{1} << (byte & 63);
+}
+
+constexpr void insert(::mcpprt::match::details::byte_set& set, unsigned char first, unsigned char last) noexcept {
+    for (unsigned byte{first}; byte <= last; ++byte) {
+        ::mcpprt::match::details::insert(set, static_cast<unsigned char>(byte));
+    }
+}
+
+constexpr void invert(::mcpprt::match::details::byte_set& set) noexcept {
+    for (auto& word : set.value_) {
+        word = ~word;
+    }
+}
+
+/**
+ * @brief partition of the byte values into classes that no pattern tells apart
+ */
+struct byte_classes {
+    ::mcpprt::container::array<::std::uint8_t, 256> class_;
+    ::std::size_t count_;
+
+    /**
+     * @brief a single class holding every byte
+     */
+    [[nodiscard]]
+    static consteval auto make() noexcept -> ::mcpprt::match::details::byte_classes {
+        return ::mcpprt::match::details::byte_classes{{}, 1};
+    }
+
+    /**
+     * @brief split the classes so that each lies either inside `set` or outside of it
+     */
+    consteval void refine(this byte_classes& self, ::mcpprt::match::details::byte_set const& set) noexcept {
+        // the new class of (old class, inside `set`), classes are numbered by their smallest byte
+        ::mcpprt::container::array<int, 512> renumber{};
+        for (auto& i : renumber.value_) {
+            i = -1;
+        }
+        ::std::size_t count{};
+        for (unsigned byte{}; byte < 256; ++byte) {
+            auto key = self.class_.value_[byte] * 2u +
+                       ::mcpprt::match::details::contains(set, static_cast<unsigned char>(byte));
+            if (renumber.value_[key] < 0) {
+                renumber.value_[key] = static_cast<int>(count++);
+            }
+            self.class_.value_[byte] = static_cast<::std::uint8_t>(renumber.value_[key]);
+        }
+        self.count_ = count;
+    }
+
+    /**
+     * @brief the smallest byte of every class
+     */
+    [[nodiscard]]
+    consteval auto representatives(this byte_classes const& self) noexcept
+        -> ::mcpprt::container::array<unsigned char, 256> {
+        ::mcpprt::container::array<unsigned char, 256> result{};
+        for (unsigned byte{256}; byte-- > 0;) {
+            result.value_[self.class_.value_[byte]] = static_cast<unsigned char>(byte);
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief transition table of a deterministic automaton, state 0 is the dead state
+ * @tparam States: number of states, including the dead state
+ * @tparam Classes: number of byte classes, the length of a row
+ */
+template<::std::size_t States, ::std::size_t Classes>
+struct dfa_table {
+    // half of the state range is left for the accepting bit
+    static constexpr bool narrow = States * Classes <= 0x8000;
+
+    using state_type = ::std::conditional_t<narrow, ::std::uint16_t, ::std::uint32_t>;
+
+    static constexpr state_type accepting = static_cast<state_type>(narrow ? 0x8000u : 0x80000000u);
+
+    ::mcpprt::container::array<::std::uint8_t, 256> class_;
+    ::mcpprt::container::array<state_type, States * Classes> next_;
+    /**
+     * @brief the pattern accepted in a state, plus one, 0 for states that accept nothing
+     */
+    ::mcpprt::container::array<::std::uint16_t, States> accept_;
+    state_type start_;
+    /**
+     * @brief the bytes that leave the start state, with their count, and the bytes themselves when there are
+     *        few enough to compare against directly
+     */
+    ::mcpprt::match::details::byte_set first_;
+    ::std::size_t first_count_;
+    ::mcpprt::container::array<unsigned char, 4> first_bytes_;
+
+    [[nodiscard]]
+    static constexpr auto index(state_type state) noexcept -> ::std::size_t {
+        return static_cast<::std::size_t>(state & static_cast<state_type>(~accepting));
+    }
+
+    [[nodiscard]]
+    static constexpr bool is_accepting(state_type state) noexcept {
+        return (state & accepting) != 0;
+    }
+
+    [[nodiscard]]
+    static constexpr bool is_dead(state_type state) noexcept {
+        return state == 0;
+    }
+
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+    [[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+    [[msvc::forceinline]]
+#endif
+    [[nodiscard]]
+    constexpr auto step(this dfa_table const& self, state_type state, char byte) noexcept -> state_type {
+        return self.next_.value_[index(state) + self.class_.value_[static_cast<unsigned char>(byte)]];
+    }
+
+    /**
+     * @brief the pattern accepted in `state`, plus one
+     */
+    [[nodiscard]]
+    constexpr auto accepted(this dfa_table const& self, state_type state) noexcept -> ::std::size_t {
+        return self.accept_.value_[index(state) / Classes];
+    }
+
+    /**
+     * @brief the state after reading all of [first, last), the dead state as soon as no pattern can match
+     */
+    [[nodiscard]]
+    constexpr auto run(this dfa_table const& self, char const* first, char const* last) noexcept -> state_type {
+        auto state = self.start_;
+        for (; first != last; ++first) {
+            state = self.step(state, *first);
+            if (is_dead(state)) {
+                break;
+            }
+        }
+        return state;
+    }
+
+    /**
+     * @brief the end of the longest prefix of [first, last) that reaches an accepting state, nullptr if none
+     * @note the accepting state is stored through `state`
+     */
+    [[nodiscard]]
+    constexpr auto longest(this dfa_table const& self, char const* first, char const* last,
+                           state_type& state) noexcept -> char const* {
+        char const* result{};
+        auto current = self.start_;
+        if (is_accepting(current)) {
+            result = first;
+            state = current;
+        }
+        while (first != last) {
+            current = self.step(current, *first++);
+            if (is_dead(current)) {
+                break;
+            }
+            if (is_accepting(current)) {
+                result = first;
+                state = current;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief the end of the first match in [first, last), nullptr if none
+     * @note the accepting state is stored through `state`, while in the start state the input is skipped up to
+     *       the next byte that leaves it
+     */
+    [[nodiscard]]
+    constexpr auto search(this dfa_table const& self, char const* first, char const* last,
+                          state_type& state) noexcept -> char const* {
+        state = self.start_;
+        if (is_accepting(state)) {
+            return first;
+        }
+        while (first != last) {
+            if (state == self.start_) {
+                first = self.skip(first, last);
+                if (first == last) {
+                    break;
+                }
+            }
+            state = self.step(state, *first++);
+            if (is_accepting(state)) {
+                return first;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief the first position in [first, last) whose byte leaves the start state
+     */
+    [[nodiscard]]
+    constexpr auto skip(this dfa_table const& self, char const* first, char const* last) noexcept -> char const* {
+#if defined(__SSE2__) || defined(_M_X64)
+        if !consteval {
+            if (self.first_count_ != 0 && self.first_count_ <= 4) {
+                // unused lanes repeat the first byte
+                auto const b0 = _mm_set1_epi8(static_cast<char>(self.first_bytes_.value_[0]));
+                auto const b1 = _mm_set1_epi8(static_cast<char>(self.first_bytes_.value_[1]));
+                auto const b2 = _mm_set1_epi8(static_cast<char>(self.first_bytes_.value_[2]));
+                auto const b3 = _mm_set1_epi8(static_cast<char>(self.first_bytes_.value_[3]));
+                for (; last - first >= 16; first += 16) {
+                    auto v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+                    auto hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, b0), _mm_cmpeq_epi8(v, b1)),
+                                            _mm_or_si128(_mm_cmpeq_epi8(v, b2), _mm_cmpeq_epi8(v, b3)));
+                    auto mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+                    if (mask != 0) {
+                        return first + ::std::countr_zero(mask);
+                    }
+                }
+            }
+        }
+#endif
+        while (first != last && !::mcpprt::match::details::contains(self.first_, static_cast<unsigned char>(*first))) {
+            ++first;
+        }
+        return first;
+    }
+};
+
+/**
+ * @brief pack an automaton given as `next(state, class)` and `accept(state)` into a table
+ * @param start: the start state, never 0, which is the dead state
+ */
+template<::std::size_t States, ::std::size_t Classes, typename Next, typename Accept>
+[[nodiscard]]
+consteval auto make_table(::mcpprt::match::details::byte_classes const& classes, ::std::size_t start, Next next,
+                          Accept accept) noexcept -> ::mcpprt::match::details::dfa_table<States, Classes> {
+    using table_type = ::mcpprt::match::details::dfa_table<States, Classes>;
+    using state_type = typename table_type::state_type;
+    ::exception::assert_true(classes.count_ == Classes && start != 0 && start < States);
+
+    auto encode = [&accept](::std::size_t state) noexcept {
+        auto result = static_cast<state_type>(state * Classes);
+        if (state != 0 && accept(state) != 0) {
+            result |= table_type::accepting;
+        }
+        return result;
+    };
+
+    table_type table{};
+    table.class_ = classes.class_;
+    for (::std::size_t state{}; state < States; ++state) {
+        for (::std::size_t c{}; c < Classes; ++c) {
+            table.next_.value_[state * Classes + c] = state == 0 ? state_type{} : encode(next(state, c));
+        }
+        table.accept_.value_[state] = state == 0 ? ::std::uint16_t{} : static_cast<::std::uint16_t>(accept(state));
+    }
+    table.start_ = encode(start);
+
+    for (unsigned byte{}; byte < 256; ++byte) {
+        if (next(start, classes.class_.value_[byte]) != start) {
+            ::mcpprt::match::details::insert(table.first_, static_cast<unsigned char>(byte));
+            if (table.first_count_ < 4) {
+                table.first_bytes_.value_[table.first_count_] = static_cast<unsigned char>(byte);
+            }
+            ++table.first_count_;
+        }
+    }
+    for (auto i = table.first_count_; i < 4; ++i) {
+        table.first_bytes_.value_[i] = table.first_bytes_.value_[0];
+    }
+    return table;
+}
+
+} // namespace mcpprt::match::details
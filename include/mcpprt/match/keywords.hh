@@ -0,0 +1,260 @@
+#pragma once
+
+/**
+ * @file keywords.hh
+ * @brief match a fixed set of keywords given as `static_vector` template arguments
+ * @details the keywords are turned into two automata in constant evaluation: a trie with a dead state for
+ *          exact matches, and the Aho-Corasick automaton, with every failure link already followed, for
+ *          searching, https://en.wikipedia.org/wiki/Aho%E2%80%93Corasick_algorithm
+ * @example ::mcpprt::match::keywords<"GET", "HEAD", "POST">::match(first, last) // index of the keyword
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <exception/exception.hh>
+#include "../container/array.hh"
+#include "../container/static_vector.hh"
+#include "dfa.hh"
+
+namespace mcpprt::match {
+
+/**
+ * @brief a keyword found in a text, [first_, last_) is where it occurs
+ */
+struct keyword_match {
+    ::std::size_t index_;
+    char const* first_;
+    char const* last_;
+};
+
+namespace details {
+
+struct keyword_view {
+    char const* data_;
+    ::std::size_t size_;
+};
+
+[[nodiscard]]
+constexpr auto to_lower(unsigned char byte) noexcept -> unsigned char {
+    return byte >= 'A' && byte <= 'Z' ? static_cast<unsigned char>(byte - 'A' + 'a') : byte;
+}
+
+[[nodiscard]]
+constexpr auto to_upper(unsigned char byte) noexcept -> unsigned char {
+    return byte >= 'a' && byte <= 'z' ? static_cast<unsigned char>(byte - 'a' + 'A') : byte;
+}
+
+template<::std::size_t N>
+[[nodiscard]]
+consteval auto keyword_classes(::mcpprt::container::array<::mcpprt::match::details::keyword_view, N> const& keywords,
+                               bool ignore_case) noexcept -> ::mcpprt::match::details::byte_classes {
+    auto result = ::mcpprt::match::details::byte_classes::make();
+    for (auto const& keyword : keywords.value_) {
+        for (::std::size_t i{}; i < keyword.size_; ++i) {
+            auto byte = static_cast<unsigned char>(keyword.data_[i]);
+            ::mcpprt::match::details::byte_set set{};
+            ::mcpprt::match::details::insert(set, byte);
+            if (ignore_case) {
+                ::mcpprt::match::details::insert(set, ::mcpprt::match::details::to_lower(byte));
+                ::mcpprt::match::details::insert(set, ::mcpprt::match::details::to_upper(byte));
+            }
+            result.refine(set);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief the trie of the keywords over byte classes, node 0 is left for the dead state and node 1 is the root
+ */
+template<::std::size_t Nodes, ::std::size_t Classes>
+struct keyword_trie {
+    static constexpr ::std::size_t none = static_cast<::std::size_t>(-1);
+
+    ::mcpprt::container::array<::std::size_t, Nodes * Classes> child_;
+    /**
+     * @brief the keyword ending at a node, plus one
+     */
+    ::mcpprt::container::array<::std::size_t, Nodes> accept_;
+    ::std::size_t size_;
+};
+
+/**
+ * @note when several keywords are equal, the first one is kept
+ */
+template<::std::size_t Nodes, ::std::size_t Classes, ::std::size_t N>
+[[nodiscard]]
+consteval auto make_keyword_trie(::mcpprt::container::array<::mcpprt::match::details::keyword_view, N> const& keywords,
+                                 ::mcpprt::match::details::byte_classes const& classes) noexcept {
+    using trie_type = ::mcpprt::match::details::keyword_trie<Nodes, Classes>;
+    trie_type result{};
+    for (auto& i : result.child_.value_) {
+        i = trie_type::none;
+    }
+    result.size_ = 2;
+    for (::std::size_t index{}; index < N; ++index) {
+        auto const& keyword = keywords.value_[index];
+        ::std::size_t node{1};
+        for (::std::size_t i{}; i < keyword.size_; ++i) {
+            auto c = classes.class_.value_[static_cast<unsigned char>(keyword.data_[i])];
+            auto& child = result.child_.value_[node * Classes + c];
+            if (child == trie_type::none) {
+                child = result.size_++;
+            }
+            node = child;
+        }
+        if (result.accept_.value_[node] == 0) {
+            result.accept_.value_[node] = index + 1;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief the trie itself, a missing edge leads to the dead state
+ */
+template<::std::size_t States, ::std::size_t Classes, typename Trie>
+[[nodiscard]]
+consteval auto make_exact_table(Trie const& trie, ::mcpprt::match::details::byte_classes const& classes) noexcept {
+    return ::mcpprt::match::details::make_table<States, Classes>(
+        classes, 1,
+        [&trie](::std::size_t state, ::std::size_t c) noexcept {
+            auto child = trie.child_.value_[state * Classes + c];
+            return child == Trie::none ? ::std::size_t{} : child;
+        },
+        [&trie](::std::size_t state) noexcept { return trie.accept_.value_[state]; });
+}
+
+/**
+ * @brief complete the trie breadth first, a missing edge of a node is the edge of its failure node
+ * @note a node accepts the longest keyword that is a suffix of its text
+ */
+template<::std::size_t States, ::std::size_t Classes, typename Trie>
+[[nodiscard]]
+consteval auto make_search_table(Trie const& trie, ::mcpprt::match::details::byte_classes const& classes) noexcept {
+    struct {
+        ::mcpprt::container::array<::std::size_t, States * Classes> next_;
+        ::mcpprt::container::array<::std::size_t, States> accept_;
+    } result{};
+    ::mcpprt::container::array<::std::size_t, States> fail{};
+    ::mcpprt::container::array<::std::size_t, States> queue{};
+    ::std::size_t head{};
+    ::std::size_t tail{};
+
+    for (::std::size_t node{}; node < States; ++node) {
+        result.accept_.value_[node] = trie.accept_.value_[node];
+    }
+    for (::std::size_t c{}; c < Classes; ++c) {
+        auto child = trie.child_.value_[Classes + c];
+        if (child == Trie::none) {
+            result.next_.value_[Classes + c] = 1;
+        } else {
+            result.next_.value_[Classes + c] = child;
+            fail.value_[child] = 1;
+            queue.value_[tail++] = child;
+        }
+    }
+    while (head != tail) {
+        auto node = queue.value_[head++];
+        if (result.accept_.value_[node] == 0) {
+            result.accept_.value_[node] = result.accept_.value_[fail.value_[node]];
+        }
+        for (::std::size_t c{}; c < Classes; ++c) {
+            auto child = trie.child_.value_[node * Classes + c];
+            auto fallback = result.next_.value_[fail.value_[node] * Classes + c];
+            if (child == Trie::none) {
+                result.next_.value_[node * Classes + c] = fallback;
+            } else {
+                result.next_.value_[node * Classes + c] = child;
+                fail.value_[child] = fallback;
+                queue.value_[tail++] = child;
+            }
+        }
+    }
+
+    return ::mcpprt::match::details::make_table<States, Classes>(
+        classes, 1,
+        [&result](::std::size_t state, ::std::size_t c) noexcept { return result.next_.value_[state * Classes + c]; },
+        [&result](::std::size_t state) noexcept { return result.accept_.value_[state]; });
+}
+
+} // namespace details
+
+/**
+ * @tparam IgnoreCase: ASCII letters match either case
+ * @tparam Keywords: string literals, or any NUL-terminated `static_vector<char, N>`
+ * @note when several keywords are equal, the first one is reported
+ */
+template<bool IgnoreCase, ::mcpprt::container::static_vector... Keywords>
+struct basic_keywords {
+    static_assert(sizeof...(Keywords) > 0 && sizeof...(Keywords) < 0xFFFF, "at most 65534 keywords");
+    static_assert(((Keywords.back() == '\0') && ...), "keywords must be NUL-terminated");
+
+private:
+    static constexpr ::mcpprt::container::array<::mcpprt::match::details::keyword_view, sizeof...(Keywords)> views{
+        {::mcpprt::match::details::keyword_view{Keywords.data(), Keywords.size() - 1}...}};
+
+    static constexpr auto classes = ::mcpprt::match::details::keyword_classes(views, IgnoreCase);
+
+    static constexpr auto trie =
+        ::mcpprt::match::details::make_keyword_trie<((Keywords.size() - 1) + ... + 2), classes.count_>(views, classes);
+
+    static constexpr auto exact =
+        ::mcpprt::match::details::make_exact_table<trie.size_, classes.count_>(trie, classes);
+
+    static constexpr auto searcher =
+        ::mcpprt::match::details::make_search_table<trie.size_, classes.count_>(trie, classes);
+
+public:
+    [[nodiscard]]
+    static constexpr auto size() noexcept -> ::std::size_t {
+        return sizeof...(Keywords);
+    }
+
+    /**
+     * @brief the index of the keyword equal to all of [first, last)
+     */
+    [[nodiscard]]
+    static constexpr auto match(char const* first, char const* last) noexcept -> ::exception::optional<::std::size_t> {
+        auto state = exact.run(first, last);
+        if (!exact.is_accepting(state)) {
+            return ::exception::nullopt_t{};
+        }
+        return exact.accepted(state) - 1;
+    }
+
+    /**
+     * @brief the first keyword to end in [first, last), the longest one if several end at the same byte
+     */
+    [[nodiscard]]
+    static constexpr auto find(char const* first, char const* last) noexcept
+        -> ::exception::optional<::mcpprt::match::keyword_match> {
+        typename decltype(searcher)::state_type state{};
+        auto end = searcher.search(first, last, state);
+        if (end == nullptr) {
+            return ::exception::nullopt_t{};
+        }
+        auto index = searcher.accepted(state) - 1;
+        return ::mcpprt::match::keyword_match{index, end - views.value_[index].size_, end};
+    }
+
+    /**
+     * @brief whether any keyword occurs in [first, last)
+     */
+    [[nodiscard]]
+    static constexpr bool contains(char const* first, char const* last) noexcept {
+        typename decltype(searcher)::state_type state{};
+        return searcher.search(first, last, state) != nullptr;
+    }
+};
+
+template<::mcpprt::container::static_vector... Keywords>
+using keywords = ::mcpprt::match::basic_keywords<false, Keywords...>;
+
+/**
+ * @brief keywords whose ASCII letters match either case, for HTTP header names and the like
+ */
+template<::mcpprt::container::static_vector... Keywords>
+using keywords_icase = ::mcpprt::match::basic_keywords<true, Keywords...>;
+
+} // namespace mcpprt::match
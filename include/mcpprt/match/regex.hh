@@ -0,0 +1,452 @@
+#pragma once
+
+/**
+ * @file regex.hh
+ * @brief a regular expression given as a `static_vector` template argument, compiled to a DFA in constant evaluation
+ * @details the pattern is parsed into a Thompson NFA, https://swtch.com/~rsc/regexp/regexp1.html, which the subset
+ *          construction turns into a table over byte classes. Matching is a table walk, there is no backtracking
+ *          and nothing is compiled at run time.
+ * @note the supported subset, a syntax error fails the compilation:
+ *       - literal bytes, `.` for any byte
+ *       - classes `[abc]`, `[a-z]`, `[^...]`
+ *       - escapes `\d \D \w \W \s \S \n \r \t` and `\` before any punctuation
+ *       - grouping `( )`, alternation `|`, repetition `* + ?`
+ * @example ::mcpprt::match::regex<"[A-Za-z-]+:">::prefix(first, last)
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception/exception.hh>
+#include "../container/array.hh"
+#include "../container/static_vector.hh"
+#include "dfa.hh"
+
+namespace mcpprt::match {
+
+namespace details {
+
+/**
+ * @brief the subset construction gives up, and fails the compilation, beyond this many DFA states
+ */
+inline constexpr ::std::size_t regex_max_states = 512;
+
+enum class nfa_kind : ::std::uint8_t {
+    // follows `out1_` without reading
+    epsilon,
+    // follows both `out1_` and `out2_` without reading
+    split,
+    // reads one byte of `sets_[set_]` and follows `out1_`
+    set,
+    accept,
+};
+
+struct nfa_node {
+    ::mcpprt::match::details::nfa_kind kind_;
+    ::std::size_t out1_;
+    ::std::size_t out2_;
+    ::std::size_t set_;
+};
+
+template<::std::size_t Length>
+struct nfa {
+    // every byte of the pattern adds at most three nodes
+    static constexpr ::std::size_t capacity = 4 * Length + 4;
+
+    ::mcpprt::container::array<::mcpprt::match::details::nfa_node, capacity> nodes_;
+    ::std::size_t size_;
+    ::mcpprt::container::array<::mcpprt::match::details::byte_set, Length + 1> sets_;
+    ::std::size_t set_count_;
+    ::std::size_t start_;
+    ::std::size_t accept_;
+};
+
+/**
+ * @brief a piece of the NFA entered at `start_` and left through the `out1_` of the epsilon node `end_`
+ */
+struct nfa_fragment {
+    ::std::size_t start_;
+    ::std::size_t end_;
+};
+
+/**
+ * @brief recursive descent over the pattern, building the NFA as it goes
+ */
+template<::std::size_t Length>
+struct regex_parser {
+    char const* pos_;
+    char const* end_;
+    ::mcpprt::match::details::nfa<Length> nfa_;
+
+    consteval auto add(this regex_parser& self, ::mcpprt::match::details::nfa_kind kind, ::std::size_t out1 = 0,
+                       ::std::size_t out2 = 0, ::std::size_t set = 0) noexcept -> ::std::size_t {
+        ::exception::assert_true(self.nfa_.size_ < self.nfa_.capacity);
+        self.nfa_.nodes_.value_[self.nfa_.size_] = ::mcpprt::match::details::nfa_node{kind, out1, out2, set};
+        return self.nfa_.size_++;
+    }
+
+    consteval void patch(this regex_parser& self, ::std::size_t end, ::std::size_t target) noexcept {
+        self.nfa_.nodes_.value_[end].out1_ = target;
+    }
+
+    [[nodiscard]]
+    consteval bool at(this regex_parser const& self, char c) noexcept {
+        return self.pos_ != self.end_ && *self.pos_ == c;
+    }
+
+    [[nodiscard]]
+    consteval auto next(this regex_parser& self) noexcept -> unsigned char {
+        ::exception::assert_true(self.pos_ != self.end_);
+        return static_cast<unsigned char>(*self.pos_++);
+    }
+
+    consteval auto parse(this regex_parser& self) noexcept -> ::mcpprt::match::details::nfa<Length> {
+        auto fragment = self.parse_alternation();
+        // a `)` without its `(`
+        ::exception::assert_true(self.pos_ == self.end_);
+        self.nfa_.accept_ = self.add(::mcpprt::match::details::nfa_kind::accept);
+        self.patch(fragment.end_, self.nfa_.accept_);
+        self.nfa_.start_ = fragment.start_;
+        return self.nfa_;
+    }
+
+    consteval auto parse_alternation(this regex_parser& self) noexcept -> ::mcpprt::match::details::nfa_fragment {
+        auto result = self.parse_concatenation();
+        while (self.at('|')) {
+            ++self.pos_;
+            auto other = self.parse_concatenation();
+            auto start = self.add(::mcpprt::match::details::nfa_kind::split, result.start_, other.start_);
+            auto end = self.add(::mcpprt::match::details::nfa_kind::epsilon);
+            self.patch(result.end_, end);
+            self.patch(other.end_, end);
+            result = {start, end};
+        }
+        return result;
+    }
+
+    consteval auto parse_concatenation(this regex_parser& self) noexcept -> ::mcpprt::match::details::nfa_fragment {
+        if (self.pos_ == self.end_ || self.at('|') || self.at(')')) {
+            auto empty = self.add(::mcpprt::match::details::nfa_kind::epsilon);
+            return {empty, empty};
+        }
+        auto result = self.parse_repetition();
+        while (self.pos_ != self.end_ && !self.at('|') && !self.at(')')) {
+            auto other = self.parse_repetition();
+            self.patch(result.end_, other.start_);
+            result.end_ = other.end_;
+        }
+        return result;
+    }
+
+    consteval auto parse_repetition(this regex_parser& self) noexcept -> ::mcpprt::match::details::nfa_fragment {
+        auto result = self.parse_atom();
+        while (self.at('*') || self.at('+') || self.at('?')) {
+            auto op = self.next();
+            auto end = self.add(::mcpprt::match::details::nfa_kind::epsilon);
+            auto split = self.add(::mcpprt::match::details::nfa_kind::split, result.start_, end);
+            if (op == '?') {
+                self.patch(result.end_, end);
+                result = {split, end};
+            } else {
+                // `*` may skip the atom, `+` enters it at least once
+                self.patch(result.end_, split);
+                result = {op == '*' ? split : result.start_, end};
+            }
+        }
+        return result;
+    }
+
+    consteval auto parse_atom(this regex_parser& self) noexcept -> ::mcpprt::match::details::nfa_fragment {
+        auto c = self.next();
+        ::mcpprt::match::details::byte_set set{};
+        switch (c) {
+        case '(': {
+            auto result = self.parse_alternation();
+            ::exception::assert_true(self.next() == ')');
+            return result;
+        }
+        case ')':
+        case '*':
+        case '+':
+        case '?':
+        case '|':
+            // nothing to group or repeat
+            ::exception::unreachable();
+        case '[':
+            set = self.parse_class();
+            break;
+        case '.':
+            ::mcpprt::match::details::invert(set);
+            break;
+        case '\\':
+            set = self.parse_escape();
+            break;
+        default:
+            ::mcpprt::match::details::insert(set, c);
+            break;
+        }
+        auto index = self.nfa_.set_count_++;
+        self.nfa_.sets_.value_[index] = set;
+        auto end = self.add(::mcpprt::match::details::nfa_kind::epsilon);
+        auto start = self.add(::mcpprt::match::details::nfa_kind::set, end, 0, index);
+        return {start, end};
+    }
+
+    /**
+     * @note the `[` is already consumed, a `]` first in the class is a literal
+     */
+    consteval auto parse_class(this regex_parser& self) noexcept -> ::mcpprt::match::details::byte_set {
+        ::mcpprt::match::details::byte_set result{};
+        bool negate = self.at('^');
+        if (negate) {
+            ++self.pos_;
+        }
+        bool first = true;
+        while (first || !self.at(']')) {
+            first = false;
+            auto c = self.next();
+            if (c == '\\') {
+                auto escaped = self.parse_escape();
+                for (::std::size_t i{}; i < 4; ++i) {
+                    result.value_[i] |= escaped.value_[i];
+                }
+                continue;
+            }
+            if (self.at('-') && self.pos_ + 1 != self.end_ && self.pos_[1] != ']') {
+                ++self.pos_;
+                auto last = self.next();
+                ::exception::assert_true(c <= last);
+                ::mcpprt::match::details::insert(result, c, last);
+            } else {
+                ::mcpprt::match::details::insert(result, c);
+            }
+        }
+        ++self.pos_;
+        if (negate) {
+            ::mcpprt::match::details::invert(result);
+        }
+        return result;
+    }
+
+    /**
+     * @note the `\` is already consumed
+     */
+    consteval auto parse_escape(this regex_parser& self) noexcept -> ::mcpprt::match::details::byte_set {
+        ::mcpprt::match::details::byte_set result{};
+        auto c = self.next();
+        switch (c) {
+        case 'd':
+        case 'D':
+            ::mcpprt::match::details::insert(result, '0', '9');
+            break;
+        case 'w':
+        case 'W':
+            ::mcpprt::match::details::insert(result, '0', '9');
+            ::mcpprt::match::details::insert(result, 'A', 'Z');
+            ::mcpprt::match::details::insert(result, 'a', 'z');
+            ::mcpprt::match::details::insert(result, '_');
+            break;
+        case 's':
+        case 'S':
+            ::mcpprt::match::details::insert(result, ' ');
+            ::mcpprt::match::details::insert(result, '\t', '\r');
+            break;
+        case 'n':
+            ::mcpprt::match::details::insert(result, '\n');
+            break;
+        case 'r':
+            ::mcpprt::match::details::insert(result, '\r');
+            break;
+        case 't':
+            ::mcpprt::match::details::insert(result, '\t');
+            break;
+        default:
+            // an unknown letter or digit escape is more likely a mistake than a literal
+            ::exception::assert_true(!(c >= '0' && c <= '9') && !(c >= 'A' && c <= 'Z') && !(c >= 'a' && c <= 'z'));
+            ::mcpprt::match::details::insert(result, c);
+            break;
+        }
+        if (c == 'D' || c == 'W' || c == 'S') {
+            ::mcpprt::match::details::invert(result);
+        }
+        return result;
+    }
+};
+
+template<::std::size_t Length>
+[[nodiscard]]
+consteval auto parse_regex(char const* pattern) noexcept -> ::mcpprt::match::details::nfa<Length> {
+    ::mcpprt::match::details::regex_parser<Length> parser{pattern, pattern + Length, {}};
+    return parser.parse();
+}
+
+template<::std::size_t Length>
+[[nodiscard]]
+consteval auto regex_classes(::mcpprt::match::details::nfa<Length> const& nfa) noexcept
+    -> ::mcpprt::match::details::byte_classes {
+    auto result = ::mcpprt::match::details::byte_classes::make();
+    for (::std::size_t i{}; i < nfa.set_count_; ++i) {
+        result.refine(nfa.sets_.value_[i]);
+    }
+    return result;
+}
+
+/**
+ * @brief the DFA states found by the subset construction, before they are packed into a table
+ */
+template<::std::size_t Classes>
+struct regex_dfa {
+    ::mcpprt::container::array<::std::size_t, ::mcpprt::match::details::regex_max_states * Classes> next_;
+    ::mcpprt::container::array<bool, ::mcpprt::match::details::regex_max_states> accept_;
+    ::std::size_t size_;
+};
+
+/**
+ * @brief https://en.wikipedia.org/wiki/Powerset_construction, state 0 is the empty set of NFA nodes
+ * @param unanchored: a match may start anywhere, the NFA start is added back after every byte
+ */
+template<::std::size_t Classes, ::std::size_t Length>
+[[nodiscard]]
+consteval auto make_regex_dfa(::mcpprt::match::details::nfa<Length> const& nfa,
+                              ::mcpprt::match::details::byte_classes const& classes, bool unanchored) noexcept
+    -> ::mcpprt::match::details::regex_dfa<Classes> {
+    using nfa_type = ::mcpprt::match::details::nfa<Length>;
+    using node_set = ::mcpprt::container::array<::std::uint64_t, (nfa_type::capacity + 63) / 64>;
+
+    auto has = [](node_set const& set, ::std::size_t node) noexcept {
+        return (set.value_[node / 64] >> (node % 64)) & 1;
+    };
+
+    auto closure = [&nfa, &has](node_set& set) noexcept {
+        ::mcpprt::container::array<::std::size_t, nfa_type::capacity> stack{};
+        ::std::size_t top{};
+        for (::std::size_t node{}; node < nfa.size_; ++node) {
+            if (has(set, node)) {
+                stack.value_[top++] = node;
+            }
+        }
+        auto push = [&](::std::size_t node) noexcept {
+            if (!has(set, node)) {
+                set.value_[node / 64] |= ::std::uint64_t{1} << (node % 64);
+                stack.value_[top++] = node;
+            }
+        };
+        while (top != 0) {
+            auto const& node = nfa.nodes_.value_[stack.value_[--top]];
+            if (node.kind_ == ::mcpprt::match::details::nfa_kind::epsilon) {
+                push(node.out1_);
+            } else if (node.kind_ == ::mcpprt::match::details::nfa_kind::split) {
+                push(node.out1_);
+                push(node.out2_);
+            }
+        }
+    };
+
+    ::mcpprt::match::details::regex_dfa<Classes> result{};
+    ::mcpprt::container::array<node_set, ::mcpprt::match::details::regex_max_states> states{};
+    node_set start{};
+    start.value_[nfa.start_ / 64] |= ::std::uint64_t{1} << (nfa.start_ % 64);
+    closure(start);
+    states.value_[1] = start;
+    result.size_ = 2;
+
+    auto representatives = classes.representatives();
+    for (::std::size_t state{1}; state < result.size_; ++state) {
+        result.accept_.value_[state] = has(states.value_[state], nfa.accept_);
+        for (::std::size_t c{}; c < Classes; ++c) {
+            node_set target{};
+            for (::std::size_t node{}; node < nfa.size_; ++node) {
+                auto const& n = nfa.nodes_.value_[node];
+                if (has(states.value_[state], node) && n.kind_ == ::mcpprt::match::details::nfa_kind::set &&
+                    ::mcpprt::match::details::contains(nfa.sets_.value_[n.set_], representatives.value_[c])) {
+                    target.value_[n.out1_ / 64] |= ::std::uint64_t{1} << (n.out1_ % 64);
+                }
+            }
+            closure(target);
+            if (unanchored) {
+                for (::std::size_t i{}; i < target.size(); ++i) {
+                    target.value_[i] |= start.value_[i];
+                }
+            }
+
+            ::std::size_t found{};
+            while (found < result.size_ && !::std::ranges::equal(states.value_[found].value_, target.value_)) {
+                ++found;
+            }
+            if (found == result.size_) {
+                ::exception::assert_true(result.size_ < ::mcpprt::match::details::regex_max_states);
+                states.value_[result.size_++] = target;
+            }
+            result.next_.value_[state * Classes + c] = found;
+        }
+    }
+    return result;
+}
+
+template<::std::size_t States, ::std::size_t Classes>
+[[nodiscard]]
+consteval auto make_regex_table(::mcpprt::match::details::regex_dfa<Classes> const& dfa,
+                                ::mcpprt::match::details::byte_classes const& classes) noexcept {
+    return ::mcpprt::match::details::make_table<States, Classes>(
+        classes, 1,
+        [&dfa](::std::size_t state, ::std::size_t c) noexcept { return dfa.next_.value_[state * Classes + c]; },
+        [&dfa](::std::size_t state) noexcept { return static_cast<::std::size_t>(dfa.accept_.value_[state]); });
+}
+
+} // namespace details
+
+/**
+ * @tparam Pattern: a string literal, or any NUL-terminated `static_vector<char, N>`
+ */
+template<::mcpprt::container::static_vector Pattern>
+struct regex {
+    static_assert(Pattern.back() == '\0', "the pattern must be NUL-terminated");
+
+private:
+    static constexpr auto nfa = ::mcpprt::match::details::parse_regex<Pattern.size() - 1>(Pattern.data());
+
+    static constexpr auto classes = ::mcpprt::match::details::regex_classes(nfa);
+
+    static constexpr auto anchored = ::mcpprt::match::details::make_regex_dfa<classes.count_>(nfa, classes, false);
+
+    static constexpr auto unanchored = ::mcpprt::match::details::make_regex_dfa<classes.count_>(nfa, classes, true);
+
+    static constexpr auto anchored_table =
+        ::mcpprt::match::details::make_regex_table<anchored.size_, classes.count_>(anchored, classes);
+
+    static constexpr auto unanchored_table =
+        ::mcpprt::match::details::make_regex_table<unanchored.size_, classes.count_>(unanchored, classes);
+
+public:
+    /**
+     * @brief whether the pattern matches all of [first, last)
+     */
+    [[nodiscard]]
+    static constexpr bool match(char const* first, char const* last) noexcept {
+        return anchored_table.is_accepting(anchored_table.run(first, last));
+    }
+
+    /**
+     * @brief the end of the longest match that starts at `first`
+     */
+    [[nodiscard]]
+    static constexpr auto prefix(char const* first, char const* last) noexcept -> ::exception::optional<char const*> {
+        typename decltype(anchored_table)::state_type state{};
+        auto end = anchored_table.longest(first, last, state);
+        if (end == nullptr) {
+            return ::exception::nullopt_t{};
+        }
+        return end;
+    }
+
+    /**
+     * @brief whether the pattern matches anywhere in [first, last)
+     */
+    [[nodiscard]]
+    static constexpr bool contains(char const* first, char const* last) noexcept {
+        typename decltype(unanchored_table)::state_type state{};
+        return unanchored_table.search(first, last, state) != nullptr;
+    }
+};
+
+} // namespace mcpprt::match
@@ -0,0 +1,439 @@
+#pragma once
+
+/**
+ * @file epoch.hh
+ * @brief epoch-based reclamation, frees nodes of lock-free structures once no reader can still hold them
+ * @details a thread enrolled in a domain pins itself around every read of shared nodes. A node unlinked from the
+ *          structure is retired with the global epoch of that moment, and freed once the epoch has moved two
+ *          steps further. The epoch moves one step only when every pinned thread has seen the current one,
+ *          so by then every reader that could have reached the node has unpinned.
+ *          Pinning is one exchange on a record of the thread's own, no shared cache line is written.
+ * @example
+ *     auto self = domain.enroll();
+ *     {
+ *         auto guard = self.pin();
+ *         read(head.load(::std::memory_order_acquire));
+ *     }
+ *     self.retire(head.exchange(next, ::std::memory_order_acq_rel));
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <exception/exception.hh>
+#include "pool.hh"
+
+namespace mcpprt::memory {
+
+/**
+ * @brief retired nodes kept per batch, a batch fills a 1 KiB pool block
+ */
+inline constexpr ::std::size_t epoch_batch_size = 62;
+
+namespace details {
+
+/**
+ * @brief the pin state of one enrolled thread, on a cache line of its own
+ */
+struct alignas(64) epoch_record {
+    // `epoch << 1 | 1` while pinned, 0 otherwise
+    ::std::atomic<::std::uint64_t> state_;
+    ::std::atomic<bool> in_use_;
+    // written once before the record is published
+    ::mcpprt::memory::details::epoch_record* next_;
+};
+
+struct retired {
+    void* ptr_;
+    void (*reclaim_)(void*) noexcept;
+};
+
+struct epoch_batch {
+    ::mcpprt::memory::details::epoch_batch* next_;
+    // the latest epoch any of the nodes was retired in
+    ::std::uint64_t epoch_;
+    ::std::size_t size_;
+    ::mcpprt::memory::details::retired nodes_[::mcpprt::memory::epoch_batch_size];
+};
+
+inline void reclaim_batch(::mcpprt::memory::details::epoch_batch& batch) noexcept {
+    for (::std::size_t i{}; i < batch.size_; ++i) {
+        batch.nodes_[i].reclaim_(batch.nodes_[i].ptr_);
+    }
+    batch.size_ = 0;
+}
+
+} // namespace details
+
+/**
+ * @brief the shared epoch and the records of the enrolled threads
+ * @tparam Allocator: allocates the records and the batches of retired nodes
+ * @note must outlive its handles, and must not be moved while it has any
+ */
+template<typename Allocator = ::mcpprt::memory::pool_allocator<::std::byte>>
+class epoch_domain {
+    using record_type = ::mcpprt::memory::details::epoch_record;
+    using batch_type = ::mcpprt::memory::details::epoch_batch;
+    using record_allocator = typename ::std::allocator_traits<Allocator>::template rebind_alloc<record_type>;
+    using batch_allocator = typename ::std::allocator_traits<Allocator>::template rebind_alloc<batch_type>;
+
+public:
+    class handle;
+
+    /**
+     * @brief keeps the thread pinned until destroyed, guards of one handle nest
+     */
+    class guard {
+        friend class handle;
+
+        handle* owner_;
+
+        explicit guard(handle* owner) noexcept : owner_{owner} {
+        }
+
+    public:
+        guard(guard const&) = delete;
+        auto operator=(guard const&) -> guard& = delete;
+
+        guard(guard&& other) noexcept : owner_{::std::exchange(other.owner_, nullptr)} {
+        }
+
+        auto operator=(guard&&) -> guard& = delete;
+
+        ~guard() noexcept {
+            if (this->owner_ != nullptr) {
+                this->owner_->unpin();
+            }
+        }
+    };
+
+    /**
+     * @brief the membership of one thread, used only by that thread
+     * @details retired nodes gather in batches owned by the handle. Whenever a batch fills, the handle tries to
+     *          move the epoch on and frees its batches that are two epochs old, so unless a thread stays pinned
+     *          the garbage of a handle stays within a few batches.
+     */
+    class handle {
+        friend class epoch_domain;
+        friend class guard;
+
+        epoch_domain* domain_{};
+        record_type* record_{};
+        ::std::size_t depth_{};
+        // batches in the order they were filled, the last one is being filled
+        batch_type* first_{};
+        batch_type* last_{};
+        ::std::size_t pending_{};
+
+        handle(epoch_domain* domain, record_type* record) noexcept : domain_{domain}, record_{record} {
+        }
+
+        void unpin(this handle& self) noexcept {
+            if (--self.depth_ == 0) {
+                self.record_->state_.store(0, ::std::memory_order_release);
+            }
+        }
+
+        /**
+         * @brief free the batches two epochs older than `epoch`, keeping the last one for later nodes
+         */
+        void reclaim(this handle& self, ::std::uint64_t epoch) noexcept {
+            while (self.first_ != nullptr && self.first_->size_ != 0 && self.first_->epoch_ + 2 <= epoch) {
+                auto* batch = self.first_;
+                self.pending_ -= batch->size_;
+                ::mcpprt::memory::details::reclaim_batch(*batch);
+                if (batch == self.last_) {
+                    break;
+                }
+                self.first_ = batch->next_;
+                self.domain_->deallocate_batch(batch);
+            }
+        }
+
+        void release(this handle& self) noexcept {
+            if (self.record_ == nullptr) {
+                return;
+            }
+            ::exception::assert_true(self.depth_ == 0);
+            self.collect();
+            // what is still too recent is left to the domain
+            for (auto* batch = self.first_; batch != nullptr;) {
+                auto* next = batch->next_;
+                if (batch->size_ == 0) {
+                    self.domain_->deallocate_batch(batch);
+                } else {
+                    self.domain_->orphan(batch);
+                }
+                batch = next;
+            }
+            self.record_->in_use_.store(false, ::std::memory_order_release);
+            self.record_ = nullptr;
+            self.first_ = nullptr;
+            self.last_ = nullptr;
+            self.pending_ = 0;
+        }
+
+    public:
+        handle() noexcept = default;
+
+        handle(handle const&) = delete;
+        auto operator=(handle const&) -> handle& = delete;
+
+        /**
+         * @note `other` must not be pinned, its guards would unpin the moved-from handle
+         */
+        handle(handle&& other) noexcept
+            : domain_{other.domain_}, record_{::std::exchange(other.record_, nullptr)},
+              depth_{::std::exchange(other.depth_, 0)}, first_{::std::exchange(other.first_, nullptr)},
+              last_{::std::exchange(other.last_, nullptr)}, pending_{::std::exchange(other.pending_, 0)} {
+            ::exception::assert_true(this->depth_ == 0);
+        }
+
+        /**
+         * @note neither handle may be pinned
+         */
+        auto&& operator=(this handle& self, handle&& other) noexcept {
+            if (&self != &other) {
+                ::exception::assert_true(other.depth_ == 0);
+                self.release();
+                self.domain_ = other.domain_;
+                self.record_ = ::std::exchange(other.record_, nullptr);
+                self.depth_ = ::std::exchange(other.depth_, 0);
+                self.first_ = ::std::exchange(other.first_, nullptr);
+                self.last_ = ::std::exchange(other.last_, nullptr);
+                self.pending_ = ::std::exchange(other.pending_, 0);
+            }
+            return self;
+        }
+
+        /**
+         * @note must not be pinned
+         */
+        ~handle() noexcept {
+            this->release();
+        }
+
+        /**
+         * @brief nodes reachable from the structure stay allocated while the guard lives
+         */
+        [[nodiscard]]
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+        [[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+        [[msvc::forceinline]]
+#endif
+        auto pin(this handle& self) noexcept -> guard {
+            if (self.depth_++ == 0) {
+                auto epoch = self.domain_->epoch_.load(::std::memory_order_relaxed);
+                // the exchange is the full fence that orders the pin before the reads it protects
+                self.record_->state_.exchange(epoch << 1 | 1, ::std::memory_order_seq_cst);
+            }
+            return guard{&self};
+        }
+
+        [[nodiscard]]
+        bool pinned(this handle const& self) noexcept {
+            return self.depth_ != 0;
+        }
+
+        /**
+         * @brief nodes retired and not freed yet
+         */
+        [[nodiscard]]
+        auto pending(this handle const& self) noexcept -> ::std::size_t {
+            return self.pending_;
+        }
+
+        /**
+         * @brief call `reclaim(ptr)` once no pinned thread can reach `ptr`
+         * @note `ptr` must already be unreachable from the structure
+         */
+        void retire(this handle& self, void* ptr, void (*reclaim)(void*) noexcept) noexcept {
+            ::std::atomic_thread_fence(::std::memory_order_seq_cst);
+            auto epoch = self.domain_->epoch_.load(::std::memory_order_relaxed);
+            if (self.last_ == nullptr) {
+                self.first_ = self.last_ = self.domain_->allocate_batch();
+            } else if (self.last_->size_ == ::mcpprt::memory::epoch_batch_size) {
+                self.collect();
+                if (self.last_->size_ != 0) {
+                    auto* batch = self.domain_->allocate_batch();
+                    self.last_->next_ = batch;
+                    self.last_ = batch;
+                }
+            }
+            auto& batch = *self.last_;
+            batch.nodes_[batch.size_++] = ::mcpprt::memory::details::retired{ptr, reclaim};
+            batch.epoch_ = epoch;
+            ++self.pending_;
+        }
+
+        /**
+         * @brief destroy `*ptr` and give it back to `NodeAllocator` once no pinned thread can reach it
+         */
+        template<typename T, typename NodeAllocator = ::mcpprt::memory::pool_allocator<T>>
+        void retire(this handle& self, T* ptr) noexcept {
+            static_assert(::std::is_empty_v<NodeAllocator> && ::std::is_default_constructible_v<NodeAllocator>,
+                          "the allocator is recreated when the node is freed, it must be stateless");
+            self.retire(static_cast<void*>(ptr), [](void* node) noexcept {
+                NodeAllocator alloc{};
+                auto* value = static_cast<T*>(node);
+                ::std::allocator_traits<NodeAllocator>::destroy(alloc, value);
+                ::std::allocator_traits<NodeAllocator>::deallocate(alloc, value, 1);
+            });
+        }
+
+        /**
+         * @brief move the epoch on if every pinned thread allows it, and free what is old enough
+         */
+        void collect(this handle& self) noexcept {
+            auto epoch = self.domain_->try_advance();
+            self.reclaim(epoch);
+            self.domain_->reclaim_orphans(epoch);
+        }
+
+        /**
+         * @brief wait until every node retired so far is freed
+         * @note spins while another thread stays pinned, must not be pinned itself
+         */
+        void synchronize(this handle& self) noexcept {
+            ::exception::assert_true(self.depth_ == 0);
+            while (self.pending_ != 0) {
+                self.collect();
+            }
+        }
+    };
+
+private:
+    alignas(64) ::std::atomic<::std::uint64_t> epoch_{};
+    ::std::atomic<record_type*> records_{};
+    // batches left by handles released before they could be freed
+    ::std::atomic<batch_type*> orphans_{};
+    [[no_unique_address]] Allocator alloc_{};
+
+public:
+    epoch_domain() noexcept = default;
+
+    explicit epoch_domain(Allocator const& alloc) noexcept : alloc_{alloc} {
+    }
+
+    epoch_domain(epoch_domain const&) = delete;
+    auto operator=(epoch_domain const&) -> epoch_domain& = delete;
+
+    /**
+     * @note every handle must be released, their remaining nodes are freed here
+     */
+    ~epoch_domain() noexcept {
+        for (auto* batch = this->orphans_.load(::std::memory_order_acquire); batch != nullptr;) {
+            auto* next = batch->next_;
+            ::mcpprt::memory::details::reclaim_batch(*batch);
+            this->deallocate_batch(batch);
+            batch = next;
+        }
+        record_allocator alloc{this->alloc_};
+        for (auto* record = this->records_.load(::std::memory_order_acquire); record != nullptr;) {
+            ::exception::assert_false(record->in_use_.load(::std::memory_order_relaxed));
+            auto* next = record->next_;
+            ::std::destroy_at(record);
+            ::std::allocator_traits<record_allocator>::deallocate(alloc, record, 1);
+            record = next;
+        }
+    }
+
+    /**
+     * @brief a membership for the calling thread, reusing the record of a released handle when there is one
+     */
+    [[nodiscard]]
+    auto enroll(this epoch_domain& self) noexcept -> handle {
+        for (auto* record = self.records_.load(::std::memory_order_acquire); record != nullptr;
+             record = record->next_) {
+            bool expected{false};
+            if (!record->in_use_.load(::std::memory_order_relaxed) &&
+                record->in_use_.compare_exchange_strong(expected, true, ::std::memory_order_acquire,
+                                                        ::std::memory_order_relaxed)) {
+                return handle{&self, record};
+            }
+        }
+
+        record_allocator alloc{self.alloc_};
+        auto* record = ::std::allocator_traits<record_allocator>::allocate(alloc, 1);
+        ::std::construct_at(record);
+        record->in_use_.store(true, ::std::memory_order_relaxed);
+        record->next_ = self.records_.load(::std::memory_order_relaxed);
+        while (!self.records_.compare_exchange_weak(record->next_, record, ::std::memory_order_release,
+                                                    ::std::memory_order_relaxed)) {
+        }
+        return handle{&self, record};
+    }
+
+    [[nodiscard]]
+    auto epoch(this epoch_domain const& self) noexcept -> ::std::uint64_t {
+        return self.epoch_.load(::std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * @return the epoch after the attempt
+     */
+    auto try_advance(this epoch_domain& self) noexcept -> ::std::uint64_t {
+        auto epoch = self.epoch_.load(::std::memory_order_relaxed);
+        ::std::atomic_thread_fence(::std::memory_order_seq_cst);
+        for (auto* record = self.records_.load(::std::memory_order_acquire); record != nullptr;
+             record = record->next_) {
+            auto state = record->state_.load(::std::memory_order_relaxed);
+            if ((state & 1) != 0 && (state >> 1) != epoch) {
+                return epoch;
+            }
+        }
+        ::std::atomic_thread_fence(::std::memory_order_acquire);
+        if (self.epoch_.compare_exchange_strong(epoch, epoch + 1, ::std::memory_order_release,
+                                                ::std::memory_order_acquire)) {
+            return epoch + 1;
+        }
+        // another thread moved it on, acquiring its move orders the unpins it saw before what is freed here
+        return epoch;
+    }
+
+    void orphan(this epoch_domain& self, batch_type* batch) noexcept {
+        batch->next_ = self.orphans_.load(::std::memory_order_relaxed);
+        while (!self.orphans_.compare_exchange_weak(batch->next_, batch, ::std::memory_order_release,
+                                                    ::std::memory_order_relaxed)) {
+        }
+    }
+
+    void reclaim_orphans(this epoch_domain& self, ::std::uint64_t epoch) noexcept {
+        if (self.orphans_.load(::std::memory_order_relaxed) == nullptr) [[likely]] {
+            return;
+        }
+        auto* batch = self.orphans_.exchange(nullptr, ::std::memory_order_acquire);
+        while (batch != nullptr) {
+            auto* next = batch->next_;
+            if (batch->epoch_ + 2 <= epoch) {
+                ::mcpprt::memory::details::reclaim_batch(*batch);
+                self.deallocate_batch(batch);
+            } else {
+                self.orphan(batch);
+            }
+            batch = next;
+        }
+    }
+
+    [[nodiscard]]
+    auto allocate_batch(this epoch_domain& self) noexcept -> batch_type* {
+        batch_allocator alloc{self.alloc_};
+        auto* batch = ::std::allocator_traits<batch_allocator>::allocate(alloc, 1);
+        batch->next_ = nullptr;
+        batch->epoch_ = 0;
+        batch->size_ = 0;
+        return batch;
+    }
+
+    void deallocate_batch(this epoch_domain& self, batch_type* batch) noexcept {
+        batch_allocator alloc{self.alloc_};
+        ::std::allocator_traits<batch_allocator>::deallocate(alloc, batch, 1);
+    }
+};
+
+} // namespace mcpprt::memory
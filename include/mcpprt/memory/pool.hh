@@ -0,0 +1,164 @@
+#pragma once
+
+/**
+ * @file pool.hh
+ * @brief per-thread size-class pool for small, short-lived blocks
+ * @details blocks are carved out of chunks taken from the global allocator and are recycled through
+ *          per-thread free lists, chunks are never returned. A block freed on another thread joins the
+ *          free list of that thread, which is safe because every block of a class has the same size.
+ */
+
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <exception/exception.hh>
+
+namespace mcpprt::memory {
+
+inline constexpr ::std::size_t pool_block_min = 64;
+inline constexpr ::std::size_t pool_block_max = 4096;
+inline constexpr ::std::size_t pool_chunk_size = 64 * 1024;
+
+/**
+ * @brief every block is aligned to at least this many bytes
+ */
+inline constexpr ::std::size_t pool_alignment = 64;
+
+static_assert(::std::has_single_bit(::mcpprt::memory::pool_block_min) &&
+                  ::std::has_single_bit(::mcpprt::memory::pool_block_max),
+              "pool block sizes must be powers of two");
+static_assert(::mcpprt::memory::pool_block_min >= ::mcpprt::memory::pool_alignment);
+static_assert(::mcpprt::memory::pool_chunk_size % ::mcpprt::memory::pool_block_max == 0);
+
+namespace details {
+
+inline constexpr ::std::size_t pool_classes = ::std::countr_zero(::mcpprt::memory::pool_block_max) -
+                                              ::std::countr_zero(::mcpprt::memory::pool_block_min) + 1;
+
+struct free_block {
+    ::mcpprt::memory::details::free_block* next_;
+};
+
+struct thread_pool {
+    ::mcpprt::memory::details::free_block* free_[::mcpprt::memory::details::pool_classes];
+    ::std::byte* cursor_;
+    ::std::byte* end_;
+};
+
+/**
+ * @note trivially destructible on purpose, no thread exit hook is needed
+ */
+inline thread_local ::mcpprt::memory::details::thread_pool thread_pool_{};
+
+[[nodiscard]]
+constexpr auto size_class(::std::size_t bytes) noexcept -> ::std::size_t {
+    if (bytes <= ::mcpprt::memory::pool_block_min) {
+        return 0;
+    }
+    return static_cast<::std::size_t>(::std::bit_width(bytes - 1)) -
+           static_cast<::std::size_t>(::std::countr_zero(::mcpprt::memory::pool_block_min));
+}
+
+[[nodiscard]]
+inline void* upstream_allocate(::std::size_t bytes) noexcept {
+    auto* ptr = ::operator new(bytes, ::std::align_val_t{::mcpprt::memory::pool_alignment}, ::std::nothrow);
+    if (ptr == nullptr) [[unlikely]] {
+        ::exception::terminate();
+    }
+    return ptr;
+}
+
+inline void upstream_deallocate(void* ptr) noexcept {
+    ::operator delete(ptr, ::std::align_val_t{::mcpprt::memory::pool_alignment});
+}
+
+} // namespace details
+
+/**
+ * @brief allocate `bytes` from the pool of the calling thread, terminates when out of memory
+ * @note requests larger than `pool_block_max` go straight to the global allocator
+ */
+[[nodiscard]]
+inline void* pool_allocate(::std::size_t bytes) noexcept {
+    if (bytes > ::mcpprt::memory::pool_block_max) [[unlikely]] {
+        return ::mcpprt::memory::details::upstream_allocate(bytes);
+    }
+
+    auto index = ::mcpprt::memory::details::size_class(bytes);
+    auto& pool = ::mcpprt::memory::details::thread_pool_;
+    if (auto* block = pool.free_[index]; block != nullptr) [[likely]] {
+        pool.free_[index] = block->next_;
+        return block;
+    }
+
+    auto block_size = ::mcpprt::memory::pool_block_min << index;
+    if (static_cast<::std::size_t>(pool.end_ - pool.cursor_) < block_size) [[unlikely]] {
+        pool.cursor_ =
+            static_cast<::std::byte*>(::mcpprt::memory::details::upstream_allocate(::mcpprt::memory::pool_chunk_size));
+        pool.end_ = pool.cursor_ + ::mcpprt::memory::pool_chunk_size;
+    }
+    auto* ptr = pool.cursor_;
+    pool.cursor_ += block_size;
+    return ptr;
+}
+
+/**
+ * @brief give a block back to the pool of the calling thread
+ * @param bytes: must be the size passed to `pool_allocate`
+ */
+inline void pool_deallocate(void* ptr, ::std::size_t bytes) noexcept {
+    if (bytes > ::mcpprt::memory::pool_block_max) [[unlikely]] {
+        ::mcpprt::memory::details::upstream_deallocate(ptr);
+        return;
+    }
+
+    auto index = ::mcpprt::memory::details::size_class(bytes);
+    auto& pool = ::mcpprt::memory::details::thread_pool_;
+    pool.free_[index] = ::new (ptr) ::mcpprt::memory::details::free_block{pool.free_[index]};
+}
+
+/**
+ * @brief allocator over `pool_allocate`, falls back to `std::allocator` during constant evaluation
+ */
+template<typename T>
+struct pool_allocator {
+    static_assert(alignof(T) <= ::mcpprt::memory::pool_alignment, "over-aligned types are not supported");
+
+    using value_type = T;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+
+    constexpr pool_allocator() noexcept = default;
+
+    template<typename U>
+    constexpr pool_allocator(::mcpprt::memory::pool_allocator<U> const&) noexcept {
+    }
+
+    [[nodiscard]]
+    static constexpr auto allocate(::std::size_t n) noexcept -> T* {
+        if consteval {
+            return ::std::allocator<T>{}.allocate(n);
+        } else {
+            ::exception::assert_true(n <= static_cast<::std::size_t>(-1) / sizeof(T));
+            return static_cast<T*>(::mcpprt::memory::pool_allocate(n * sizeof(T)));
+        }
+    }
+
+    static constexpr void deallocate(T* ptr, ::std::size_t n) noexcept {
+        if consteval {
+            ::std::allocator<T>{}.deallocate(ptr, n);
+        } else {
+            ::mcpprt::memory::pool_deallocate(ptr, n * sizeof(T));
+        }
+    }
+
+    template<typename U>
+    [[nodiscard]]
+    constexpr bool operator==(this ::mcpprt::memory::pool_allocator<T> const&,
+                              ::mcpprt::memory::pool_allocator<U> const&) noexcept {
+        return true;
+    }
+};
+
+} // namespace mcpprt::memory
@@ -0,0 +1,694 @@
+#pragma once
+
+/**
+ * @file expression.hh
+ * @brief lazy element-wise expressions over `array`, `static_vector` and contiguous ranges
+ * @details operators on `lazy(...)` build a tree of small nodes that refer to the operands instead of computing
+ *          them, `assign` and `evaluate` then run the whole tree in a single loop over the elements, so
+ *          `a * x + b - c` reads every input once and writes the result once, without temporaries. The loop has
+ *          no dependency between elements and is left to the auto-vectorizer, which keeps it usable in constant
+ *          evaluation. Reductions keep several partial results so that the vectorizer can split them into lanes.
+ * @example ::mcpprt::numeric::assign(y, ::mcpprt::numeric::lazy(x) * 2.0f + y)
+ * @note operands are referenced, not copied, an expression must not outlive the containers it reads
+ */
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <exception/exception.hh>
+#include "../container/array.hh"
+#include "../container/static_vector.hh"
+
+namespace mcpprt::numeric {
+
+/**
+ * @brief the extent of an operand whose size is only known at run time
+ */
+inline constexpr ::std::size_t dynamic_extent = static_cast<::std::size_t>(-1);
+
+namespace details {
+
+/**
+ * @brief the extent of a scalar, which is broadcast to the size of the other operands
+ */
+inline constexpr ::std::size_t broadcast_extent = 0;
+
+template<typename T>
+constexpr bool is_array_ = false;
+
+template<typename T, ::std::size_t N>
+constexpr bool is_array_<::mcpprt::container::array<T, N>> = true;
+
+/**
+ * @brief contiguous ranges with `data()` and `size()` whose size is a run-time value, such as a vector
+ * @note `array` is excluded before its `data()` is looked at
+ */
+template<typename T>
+concept is_range = !::mcpprt::numeric::details::is_array_<::std::remove_cvref_t<T>> &&
+                   !::mcpprt::container::is_static_vector<T> && requires(T& value) {
+                       { value.data() } -> ::std::convertible_to<void const*>;
+                       { value.size() } -> ::std::convertible_to<::std::size_t>;
+                   };
+
+[[nodiscard]]
+consteval bool compatible(::std::size_t left, ::std::size_t right) noexcept {
+    return left == right || left == ::mcpprt::numeric::details::broadcast_extent ||
+           right == ::mcpprt::numeric::details::broadcast_extent || left == ::mcpprt::numeric::dynamic_extent ||
+           right == ::mcpprt::numeric::dynamic_extent;
+}
+
+/**
+ * @brief a static extent wins over a dynamic one, which wins over a broadcast
+ */
+[[nodiscard]]
+consteval auto common_extent(::std::size_t left, ::std::size_t right) noexcept -> ::std::size_t {
+    if (left == ::mcpprt::numeric::details::broadcast_extent) {
+        return right;
+    }
+    if (right == ::mcpprt::numeric::details::broadcast_extent || right == ::mcpprt::numeric::dynamic_extent) {
+        return left;
+    }
+    return right;
+}
+
+struct minimum {
+    template<typename T, typename U>
+    [[nodiscard]]
+    constexpr auto operator()(T const& left, U const& right) const noexcept {
+        return right < left ? right : left;
+    }
+};
+
+struct maximum {
+    template<typename T, typename U>
+    [[nodiscard]]
+    constexpr auto operator()(T const& left, U const& right) const noexcept {
+        return left < right ? right : left;
+    }
+};
+
+struct absolute {
+    template<typename T>
+    [[nodiscard]]
+    constexpr auto operator()(T const& value) const noexcept {
+        return value < T{} ? -value : value;
+    }
+};
+
+} // namespace details
+
+/**
+ * @brief a container as a leaf of an expression
+ */
+template<typename T, ::std::size_t Extent>
+struct terminal {
+    static constexpr ::std::size_t extent = Extent;
+
+    T const* data_;
+    ::std::size_t size_;
+
+    [[nodiscard]]
+    constexpr auto size(this terminal const& self) noexcept -> ::std::size_t {
+        return self.size_;
+    }
+
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+    [[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+    [[msvc::forceinline]]
+#endif
+    [[nodiscard]]
+    constexpr auto operator[](this terminal const& self, ::std::size_t index) noexcept -> T const& {
+        return self.data_[index];
+    }
+};
+
+/**
+ * @brief a number that takes part in an expression, the same for every element
+ */
+template<typename T>
+struct scalar {
+    static constexpr ::std::size_t extent = ::mcpprt::numeric::details::broadcast_extent;
+
+    T value_;
+
+    [[nodiscard]]
+    static constexpr auto size() noexcept -> ::std::size_t {
+        return 0;
+    }
+
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+    [[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+    [[msvc::forceinline]]
+#endif
+    [[nodiscard]]
+    constexpr auto operator[](this scalar const& self, ::std::size_t) noexcept -> T const& {
+        return self.value_;
+    }
+};
+
+template<typename Operation, typename Operand>
+struct unary_expression {
+    static constexpr ::std::size_t extent = Operand::extent;
+
+    Operand operand_;
+
+    [[nodiscard]]
+    constexpr auto size(this unary_expression const& self) noexcept -> ::std::size_t {
+        return self.operand_.size();
+    }
+
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+    [[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+    [[msvc::forceinline]]
+#endif
+    [[nodiscard]]
+    constexpr auto operator[](this unary_expression const& self, ::std::size_t index) noexcept {
+        return Operation{}(self.operand_[index]);
+    }
+};
+
+template<typename Operation, typename Left, typename Right>
+struct binary_expression {
+    static_assert(::mcpprt::numeric::details::compatible(Left::extent, Right::extent), "operands differ in size");
+
+    static constexpr ::std::size_t extent = ::mcpprt::numeric::details::common_extent(Left::extent, Right::extent);
+
+    Left left_;
+    Right right_;
+
+    [[nodiscard]]
+    constexpr auto size(this binary_expression const& self) noexcept -> ::std::size_t {
+        if constexpr (Left::extent == ::mcpprt::numeric::details::broadcast_extent) {
+            return self.right_.size();
+        } else {
+            return self.left_.size();
+        }
+    }
+
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+    [[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+    [[msvc::forceinline]]
+#endif
+    [[nodiscard]]
+    constexpr auto operator[](this binary_expression const& self, ::std::size_t index) noexcept {
+        return Operation{}(self.left_[index], self.right_[index]);
+    }
+};
+
+/**
+ * @brief `condition[i] ? left[i] : right[i]`, both sides are cheap to evaluate so the choice is a blend
+ */
+template<typename Condition, typename Left, typename Right>
+struct select_expression {
+    static_assert(::mcpprt::numeric::details::compatible(Condition::extent, Left::extent) &&
+                      ::mcpprt::numeric::details::compatible(Condition::extent, Right::extent) &&
+                      ::mcpprt::numeric::details::compatible(Left::extent, Right::extent),
+                  "operands differ in size");
+
+    static constexpr ::std::size_t extent = ::mcpprt::numeric::details::common_extent(
+        Condition::extent, ::mcpprt::numeric::details::common_extent(Left::extent, Right::extent));
+
+    Condition condition_;
+    Left left_;
+    Right right_;
+
+    [[nodiscard]]
+    constexpr auto size(this select_expression const& self) noexcept -> ::std::size_t {
+        if constexpr (Condition::extent != ::mcpprt::numeric::details::broadcast_extent) {
+            return self.condition_.size();
+        } else if constexpr (Left::extent != ::mcpprt::numeric::details::broadcast_extent) {
+            return self.left_.size();
+        } else {
+            return self.right_.size();
+        }
+    }
+
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+    [[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+    [[msvc::forceinline]]
+#endif
+    [[nodiscard]]
+    constexpr auto operator[](this select_expression const& self, ::std::size_t index) noexcept {
+        using value_type = ::std::common_type_t<decltype(self.left_[index]), decltype(self.right_[index])>;
+        return self.condition_[index] ? static_cast<value_type>(self.left_[index])
+                                      : static_cast<value_type>(self.right_[index]);
+    }
+};
+
+namespace details {
+
+template<typename T>
+constexpr bool is_expression_ = false;
+
+template<typename T, ::std::size_t Extent>
+constexpr bool is_expression_<::mcpprt::numeric::terminal<T, Extent>> = true;
+
+template<typename Operation, typename Operand>
+constexpr bool is_expression_<::mcpprt::numeric::unary_expression<Operation, Operand>> = true;
+
+template<typename Operation, typename Left, typename Right>
+constexpr bool is_expression_<::mcpprt::numeric::binary_expression<Operation, Left, Right>> = true;
+
+template<typename Condition, typename Left, typename Right>
+constexpr bool is_expression_<::mcpprt::numeric::select_expression<Condition, Left, Right>> = true;
+
+} // namespace details
+
+template<typename T>
+concept is_expression = ::mcpprt::numeric::details::is_expression_<::std::remove_cvref_t<T>>;
+
+template<typename T, ::std::size_t N>
+[[nodiscard]]
+constexpr auto lazy(::mcpprt::container::array<T, N> const& value) noexcept -> ::mcpprt::numeric::terminal<T, N> {
+    return {value.value_, N};
+}
+
+template<typename T, ::std::size_t N>
+[[nodiscard]]
+constexpr auto lazy(::mcpprt::container::static_vector<T, N> const& value) noexcept
+    -> ::mcpprt::numeric::terminal<T, N> {
+    return {value.value_, N};
+}
+
+template<::mcpprt::numeric::details::is_range Range>
+[[nodiscard]]
+constexpr auto lazy(Range const& value) noexcept {
+    using value_type = ::std::remove_cvref_t<decltype(*value.data())>;
+    return ::mcpprt::numeric::terminal<value_type, ::mcpprt::numeric::dynamic_extent>{value.data(), value.size()};
+}
+
+/**
+ * @note the expression would refer to a temporary that is gone by the time it is evaluated
+ */
+template<typename T>
+void lazy(T const&&) = delete;
+
+template<typename T>
+concept is_operand = ::mcpprt::numeric::is_expression<T> || ::std::is_arithmetic_v<T> ||
+                     requires(T const& value) { ::mcpprt::numeric::lazy(value); };
+
+namespace details {
+
+template<typename T>
+[[nodiscard]]
+constexpr auto wrap(T const& value) noexcept {
+    if constexpr (::mcpprt::numeric::is_expression<T>) {
+        return value;
+    } else if constexpr (::std::is_arithmetic_v<T>) {
+        return ::mcpprt::numeric::scalar<T>{value};
+    } else {
+        return ::mcpprt::numeric::lazy(value);
+    }
+}
+
+/**
+ * @brief operands of run-time size are checked against each other once, when the node is built
+ */
+template<typename Left, typename Right>
+constexpr void check_size(Left const& left, Right const& right) noexcept {
+    if constexpr (Left::extent != ::mcpprt::numeric::details::broadcast_extent &&
+                  Right::extent != ::mcpprt::numeric::details::broadcast_extent &&
+                  (Left::extent == ::mcpprt::numeric::dynamic_extent ||
+                   Right::extent == ::mcpprt::numeric::dynamic_extent)) {
+        ::exception::assert_true(left.size() == right.size());
+    }
+}
+
+template<typename Operation, typename Operand>
+[[nodiscard]]
+constexpr auto make_unary(Operand const& operand) noexcept {
+    using operand_type = decltype(::mcpprt::numeric::details::wrap(operand));
+    return ::mcpprt::numeric::unary_expression<Operation, operand_type>{::mcpprt::numeric::details::wrap(operand)};
+}
+
+template<typename Operation, typename Left, typename Right>
+[[nodiscard]]
+constexpr auto make_binary(Left const& left, Right const& right) noexcept {
+    auto wrapped_left = ::mcpprt::numeric::details::wrap(left);
+    auto wrapped_right = ::mcpprt::numeric::details::wrap(right);
+    ::mcpprt::numeric::details::check_size(wrapped_left, wrapped_right);
+    return ::mcpprt::numeric::binary_expression<Operation, decltype(wrapped_left), decltype(wrapped_right)>{
+        wrapped_left, wrapped_right};
+}
+
+/**
+ * @brief operands of a binary operator, at least one of which is already an expression
+ */
+template<typename Left, typename Right>
+concept is_binary_operand = (::mcpprt::numeric::is_expression<Left> || ::mcpprt::numeric::is_expression<Right>) &&
+                            ::mcpprt::numeric::is_operand<Left> && ::mcpprt::numeric::is_operand<Right>;
+
+} // namespace details
+
+template<typename Left, typename Right>
+    requires ::mcpprt::numeric::details::is_binary_operand<Left, Right>
+[[nodiscard]]
+constexpr auto operator+(Left const& left, Right const& right) noexcept {
+    return ::mcpprt::numeric::details::make_binary<::std::plus<>>(left, right);
+}
+
+template<typename Left, typename Right>
+    requires ::mcpprt::numeric::details::is_binary_operand<Left, Right>
+[[nodiscard]]
+constexpr auto operator-(Left const& left, Right const& right) noexcept {
+    return ::mcpprt::numeric::details::make_binary<::std::minus<>>(left, right);
+}
+
+template<typename Left, typename Right>
+    requires ::mcpprt::numeric::details::is_binary_operand<Left, Right>
+[[nodiscard]]
+constexpr auto operator*(Left const& left, Right const& right) noexcept {
+    return ::mcpprt::numeric::details::make_binary<::std::multiplies<>>(left, right);
+}
+
+template<typename Left, typename Right>
+    requires ::mcpprt::numeric::details::is_binary_operand<Left, Right>
+[[nodiscard]]
+constexpr auto operator/(Left const& left, Right const& right) noexcept {
+    return ::mcpprt::numeric::details::make_binary<::std::divides<>>(left, right);
+}
+
+template<typename Left, typename Right>
+    requires ::mcpprt::numeric::details::is_binary_operand<Left, Right>
+[[nodiscard]]
+constexpr auto operator==(Left const& left, Right const& right) noexcept {
+    return ::mcpprt::numeric::details::make_binary<::std::equal_to<>>(left, right);
+}
+
+template<typename Left, typename Right>
+    requires ::mcpprt::numeric::details::is_binary_operand<Left, Right>
+[[nodiscard]]
+constexpr auto operator!=(Left const& left, Right const& right) noexcept {
+    return ::mcpprt::numeric::details::make_binary<::std::not_equal_to<>>(left, right);
+}
+
+template<typename Left, typename Right>
+    requires ::mcpprt::numeric::details::is_binary_operand<Left, Right>
+[[nodiscard]]
+constexpr auto operator<(Left const& left, Right const& right) noexcept {
+    return ::mcpprt::numeric::details::make_binary<::std::less<>>(left, right);
+}
+
+template<typename Left, typename Right>
+    requires ::mcpprt::numeric::details::is_binary_operand<Left, Right>
+[[nodiscard]]
+constexpr auto operator<=(Left const& left, Right const& right) noexcept {
+    return ::mcpprt::numeric::details::make_binary<::std::less_equal<>>(left, right);
+}
+
+template<typename Left, typename Right>
+    requires ::mcpprt::numeric::details::is_binary_operand<Left, Right>
+[[nodiscard]]
+constexpr auto operator>(Left const& left, Right const& right) noexcept {
+    return ::mcpprt::numeric::details::make_binary<::std::greater<>>(left, right);
+}
+
+template<typename Left, typename Right>
+    requires ::mcpprt::numeric::details::is_binary_operand<Left, Right>
+[[nodiscard]]
+constexpr auto operator>=(Left const& left, Right const& right) noexcept {
+    return ::mcpprt::numeric::details::make_binary<::std::greater_equal<>>(left, right);
+}
+
+/**
+ * @note both sides are evaluated, element-wise there is nothing to short-circuit
+ */
+template<typename Left, typename Right>
+    requires ::mcpprt::numeric::details::is_binary_operand<Left, Right>
+[[nodiscard]]
+constexpr auto operator&&(Left const& left, Right const& right) noexcept {
+    return ::mcpprt::numeric::details::make_binary<::std::logical_and<>>(left, right);
+}
+
+template<typename Left, typename Right>
+    requires ::mcpprt::numeric::details::is_binary_operand<Left, Right>
+[[nodiscard]]
+constexpr auto operator||(Left const& left, Right const& right) noexcept {
+    return ::mcpprt::numeric::details::make_binary<::std::logical_or<>>(left, right);
+}
+
+template<::mcpprt::numeric::is_expression Operand>
+[[nodiscard]]
+constexpr auto operator-(Operand const& operand) noexcept {
+    return ::mcpprt::numeric::details::make_unary<::std::negate<>>(operand);
+}
+
+template<::mcpprt::numeric::is_expression Operand>
+[[nodiscard]]
+constexpr auto operator!(Operand const& operand) noexcept {
+    return ::mcpprt::numeric::details::make_unary<::std::logical_not<>>(operand);
+}
+
+/**
+ * @brief element-wise smaller of the operands, the first one when they compare equal
+ */
+template<typename Left, typename Right>
+    requires ::mcpprt::numeric::details::is_binary_operand<Left, Right>
+[[nodiscard]]
+constexpr auto min(Left const& left, Right const& right) noexcept {
+    return ::mcpprt::numeric::details::make_binary<::mcpprt::numeric::details::minimum>(left, right);
+}
+
+template<typename Left, typename Right>
+    requires ::mcpprt::numeric::details::is_binary_operand<Left, Right>
+[[nodiscard]]
+constexpr auto max(Left const& left, Right const& right) noexcept {
+    return ::mcpprt::numeric::details::make_binary<::mcpprt::numeric::details::maximum>(left, right);
+}
+
+template<::mcpprt::numeric::is_expression Operand>
+[[nodiscard]]
+constexpr auto abs(Operand const& operand) noexcept {
+    return ::mcpprt::numeric::details::make_unary<::mcpprt::numeric::details::absolute>(operand);
+}
+
+/**
+ * @brief element-wise `condition ? left : right`, any of the three may be a container or a scalar
+ */
+template<::mcpprt::numeric::is_operand Condition, ::mcpprt::numeric::is_operand Left,
+         ::mcpprt::numeric::is_operand Right>
+[[nodiscard]]
+constexpr auto select(Condition const& condition, Left const& left, Right const& right) noexcept {
+    auto wrapped_condition = ::mcpprt::numeric::details::wrap(condition);
+    auto wrapped_left = ::mcpprt::numeric::details::wrap(left);
+    auto wrapped_right = ::mcpprt::numeric::details::wrap(right);
+    ::mcpprt::numeric::details::check_size(wrapped_condition, wrapped_left);
+    ::mcpprt::numeric::details::check_size(wrapped_condition, wrapped_right);
+    ::mcpprt::numeric::details::check_size(wrapped_left, wrapped_right);
+    return ::mcpprt::numeric::select_expression<decltype(wrapped_condition), decltype(wrapped_left),
+                                                decltype(wrapped_right)>{wrapped_condition, wrapped_left,
+                                                                         wrapped_right};
+}
+
+namespace details {
+
+/**
+ * @brief whether an expression reads a range, which may partially overlap the destination
+ * @note an `array` or a `static_vector` can only be the destination itself or not overlap it at all
+ */
+template<typename T>
+constexpr bool reads_range = false;
+
+template<typename T>
+constexpr bool reads_range<::mcpprt::numeric::terminal<T, ::mcpprt::numeric::dynamic_extent>> = true;
+
+template<typename Operation, typename Operand>
+constexpr bool reads_range<::mcpprt::numeric::unary_expression<Operation, Operand>> =
+    ::mcpprt::numeric::details::reads_range<Operand>;
+
+template<typename Operation, typename Left, typename Right>
+constexpr bool reads_range<::mcpprt::numeric::binary_expression<Operation, Left, Right>> =
+    ::mcpprt::numeric::details::reads_range<Left> || ::mcpprt::numeric::details::reads_range<Right>;
+
+template<typename Condition, typename Left, typename Right>
+constexpr bool reads_range<::mcpprt::numeric::select_expression<Condition, Left, Right>> =
+    ::mcpprt::numeric::details::reads_range<Condition> || ::mcpprt::numeric::details::reads_range<Left> ||
+    ::mcpprt::numeric::details::reads_range<Right>;
+
+/**
+ * @brief the single loop every expression is evaluated by
+ * @tparam Disjoint: no operand partially overlaps the destination. An element only depends on the same
+ *         element of the operands, so a destination that is also an operand is fine and the loop is marked
+ *         free of dependencies. Otherwise the vectorizer has to check the overlap at run time
+ */
+template<bool Disjoint, typename T, typename Expression>
+constexpr void store(T* destination, ::std::size_t size, Expression const& expression) noexcept {
+    if constexpr (Expression::extent != ::mcpprt::numeric::details::broadcast_extent) {
+        ::exception::assert_true(expression.size() == size);
+    }
+    if constexpr (Disjoint) {
+#if defined(__clang__)
+    #pragma clang loop vectorize(enable)
+#elif defined(__GNUC__)
+    #pragma GCC ivdep
+#endif
+        for (::std::size_t i{}; i < size; ++i) {
+            destination[i] = static_cast<T>(expression[i]);
+        }
+    } else {
+        for (::std::size_t i{}; i < size; ++i) {
+            destination[i] = static_cast<T>(expression[i]);
+        }
+    }
+}
+
+/**
+ * @brief independent partial results, one per lane of the widest vector of floats
+ */
+inline constexpr ::std::size_t reduce_lanes = 16;
+
+/**
+ * @brief fold the elements with `operation`, starting every partial result at `init`
+ * @note the partial results are combined pairwise, the order is fixed, so constant evaluation gives the same
+ *       floating-point result as run time
+ */
+template<typename Operation, typename Expression, typename T>
+[[nodiscard]]
+constexpr auto reduce(Expression const& expression, T init, Operation operation) noexcept -> T {
+    auto size = expression.size();
+    T partial[::mcpprt::numeric::details::reduce_lanes];
+    for (auto& i : partial) {
+        i = init;
+    }
+    ::std::size_t i{};
+    for (; i + ::mcpprt::numeric::details::reduce_lanes <= size; i += ::mcpprt::numeric::details::reduce_lanes) {
+        for (::std::size_t lane{}; lane < ::mcpprt::numeric::details::reduce_lanes; ++lane) {
+            partial[lane] = operation(partial[lane], static_cast<T>(expression[i + lane]));
+        }
+    }
+    for (::std::size_t lane{}; lane < size - i; ++lane) {
+        partial[lane] = operation(partial[lane], static_cast<T>(expression[i + lane]));
+    }
+    for (auto width = ::mcpprt::numeric::details::reduce_lanes / 2; width != 0; width /= 2) {
+        for (::std::size_t lane{}; lane < width; ++lane) {
+            partial[lane] = operation(partial[lane], partial[lane + width]);
+        }
+    }
+    return partial[0];
+}
+
+template<typename Expression>
+using value_type = ::std::remove_cvref_t<decltype(::std::declval<Expression const&>()[0])>;
+
+} // namespace details
+
+/**
+ * @brief evaluate `source` into every element of `destination`
+ * @note a scalar source fills the destination
+ */
+template<typename T, ::std::size_t N, ::mcpprt::numeric::is_operand Source>
+constexpr void assign(::mcpprt::container::array<T, N>& destination, Source const& source) noexcept {
+    auto expression = ::mcpprt::numeric::details::wrap(source);
+    static_assert(::mcpprt::numeric::details::compatible(N, decltype(expression)::extent), "operands differ in size");
+    ::mcpprt::numeric::details::store<!::mcpprt::numeric::details::reads_range<decltype(expression)>>(
+        destination.value_, N, expression);
+}
+
+template<typename T, ::std::size_t N, ::mcpprt::numeric::is_operand Source>
+constexpr void assign(::mcpprt::container::static_vector<T, N>& destination, Source const& source) noexcept {
+    auto expression = ::mcpprt::numeric::details::wrap(source);
+    static_assert(::mcpprt::numeric::details::compatible(N, decltype(expression)::extent), "operands differ in size");
+    ::mcpprt::numeric::details::store<!::mcpprt::numeric::details::reads_range<decltype(expression)>>(
+        destination.value_, N, expression);
+}
+
+/**
+ * @note the operands may overlap the destination in any way
+ */
+template<::mcpprt::numeric::details::is_range Range, ::mcpprt::numeric::is_operand Source>
+constexpr void assign(Range& destination, Source const& source) noexcept {
+    ::mcpprt::numeric::details::store<false>(destination.data(), destination.size(),
+                                             ::mcpprt::numeric::details::wrap(source));
+}
+
+/**
+ * @brief the result of an expression of static extent, as a new `array`
+ */
+template<::mcpprt::numeric::is_expression Expression>
+    requires (Expression::extent != ::mcpprt::numeric::dynamic_extent)
+[[nodiscard]]
+constexpr auto evaluate(Expression const& expression) noexcept {
+    ::mcpprt::container::array<::mcpprt::numeric::details::value_type<Expression>, Expression::extent> result{};
+    // a new array overlaps nothing
+    ::mcpprt::numeric::details::store<true>(result.value_, Expression::extent, expression);
+    return result;
+}
+
+/**
+ * @brief sum of the elements, 0 for no elements
+ */
+template<::mcpprt::numeric::is_operand Source>
+    requires (!::std::is_arithmetic_v<Source>)
+[[nodiscard]]
+constexpr auto sum(Source const& source) noexcept {
+    auto expression = ::mcpprt::numeric::details::wrap(source);
+    using value_type = ::mcpprt::numeric::details::value_type<decltype(expression)>;
+    return ::mcpprt::numeric::details::reduce(expression, value_type{}, ::std::plus<>{});
+}
+
+/**
+ * @brief sum of the products of the elements
+ */
+template<::mcpprt::numeric::is_operand Left, ::mcpprt::numeric::is_operand Right>
+    requires (!::std::is_arithmetic_v<Left> && !::std::is_arithmetic_v<Right>)
+[[nodiscard]]
+constexpr auto dot(Left const& left, Right const& right) noexcept {
+    return ::mcpprt::numeric::sum(
+        ::mcpprt::numeric::details::make_binary<::std::multiplies<>>(left, right));
+}
+
+/**
+ * @note there must be at least one element
+ */
+template<::mcpprt::numeric::is_operand Source>
+    requires (!::std::is_arithmetic_v<Source>)
+[[nodiscard]]
+constexpr auto reduce_min(Source const& source) noexcept {
+    auto expression = ::mcpprt::numeric::details::wrap(source);
+    ::exception::assert_true(expression.size() != 0);
+    using value_type = ::mcpprt::numeric::details::value_type<decltype(expression)>;
+    return ::mcpprt::numeric::details::reduce(expression, static_cast<value_type>(expression[0]),
+                                              ::mcpprt::numeric::details::minimum{});
+}
+
+/**
+ * @note there must be at least one element
+ */
+template<::mcpprt::numeric::is_operand Source>
+    requires (!::std::is_arithmetic_v<Source>)
+[[nodiscard]]
+constexpr auto reduce_max(Source const& source) noexcept {
+    auto expression = ::mcpprt::numeric::details::wrap(source);
+    ::exception::assert_true(expression.size() != 0);
+    using value_type = ::mcpprt::numeric::details::value_type<decltype(expression)>;
+    return ::mcpprt::numeric::details::reduce(expression, static_cast<value_type>(expression[0]),
+                                              ::mcpprt::numeric::details::maximum{});
+}
+
+/**
+ * @brief whether every element is true, true for no elements
+ */
+template<::mcpprt::numeric::is_operand Source>
+    requires (!::std::is_arithmetic_v<Source>)
+[[nodiscard]]
+constexpr bool all(Source const& source) noexcept {
+    return ::mcpprt::numeric::details::reduce(::mcpprt::numeric::details::wrap(source), true, ::std::logical_and<>{});
+}
+
+/**
+ * @brief whether any element is true, false for no elements
+ */
+template<::mcpprt::numeric::is_operand Source>
+    requires (!::std::is_arithmetic_v<Source>)
+[[nodiscard]]
+constexpr bool any(Source const& source) noexcept {
+    return ::mcpprt::numeric::details::reduce(::mcpprt::numeric::details::wrap(source), false, ::std::logical_or<>{});
+}
+
+} // namespace mcpprt::numeric
@@ -0,0 +1,658 @@
+#pragma once
+
+/**
+ * @file binary.hh
+ * @brief fixed-layout binary format for scalars, `array`, `static_vector`, `expected` and aggregates of them
+ * @details every serializable type has a size known at compile time, so the layout is generated from the type:
+ *          scalars are little-endian at offsets that are multiples of their size, elements follow each other, the
+ *          members of an aggregate are placed as a C compiler would place them, and `expected` is a tag byte
+ *          followed by the larger of its alternatives. Padding is written as zero and ignored when read.
+ *          A 16-byte header holds a fingerprint of the layout and the payload size, so a reader expecting another
+ *          type is refused. `open` checks a buffer once and returns a view that reads fields in place.
+ * @example
+ *     auto written = ::mcpprt::serial::write(message, buffer, sizeof(buffer));
+ *     auto view = ::mcpprt::serial::open<message_type>(buffer, written.value());
+ *     auto id = view.value().get<0>().load();
+ * @note aggregates have at most 16 members, no base classes and no C array members
+ */
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <exception/exception.hh>
+#include "../container/array.hh"
+#include "../container/static_vector.hh"
+#include "../hash/xxh3.hh"
+
+namespace mcpprt::serial {
+
+enum class errc : unsigned char {
+    /**
+     * @brief the output buffer is smaller than `serialized_size`
+     */
+    buffer_too_small,
+    /**
+     * @brief the input ends before the header or the payload
+     */
+    truncated,
+    /**
+     * @brief the input was written for another type or another version of the format
+     */
+    layout_mismatch,
+    /**
+     * @brief a `bool` other than 0 or 1, or an `expected` tag other than 0 or 1
+     */
+    invalid_value,
+};
+
+namespace details {
+
+inline constexpr ::std::uint64_t format_version = 1;
+
+/**
+ * @brief fingerprint and payload size, both 64-bit little-endian
+ */
+inline constexpr ::std::size_t header_size = 16;
+
+inline constexpr ::std::size_t max_members = 16;
+
+enum class kind : ::std::uint64_t {
+    boolean = 1,
+    signed_integer,
+    unsigned_integer,
+    floating,
+    sequence,
+    expected,
+    aggregate,
+};
+
+template<::std::size_t Size>
+using unsigned_of =
+    ::std::conditional_t<Size == 1, ::std::uint8_t,
+                         ::std::conditional_t<Size == 2, ::std::uint16_t,
+                                              ::std::conditional_t<Size == 4, ::std::uint32_t, ::std::uint64_t>>>;
+
+[[nodiscard]]
+constexpr auto align_up(::std::size_t offset, ::std::size_t alignment) noexcept -> ::std::size_t {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+template<::std::size_t N>
+[[nodiscard]]
+constexpr auto combine(::std::uint64_t const (&parts)[N]) noexcept -> ::std::uint64_t {
+    return ::mcpprt::hash::xxh3(parts, N);
+}
+
+template<typename U>
+[[nodiscard]]
+constexpr auto load_le(::std::byte const* in) noexcept -> U {
+    if consteval {
+        U value{};
+        for (::std::size_t i{}; i < sizeof(U); ++i) {
+            value |= static_cast<U>(static_cast<U>(::std::to_integer<unsigned char>(in[i])) << (8 * i));
+        }
+        return value;
+    } else {
+        U value;
+        ::std::memcpy(&value, in, sizeof(U));
+        if constexpr (::std::endian::native == ::std::endian::big) {
+            value = ::std::byteswap(value);
+        }
+        return value;
+    }
+}
+
+template<typename U>
+constexpr void store_le(::std::byte* out, U value) noexcept {
+    if consteval {
+        for (::std::size_t i{}; i < sizeof(U); ++i) {
+            out[i] = static_cast<::std::byte>(value >> (8 * i));
+        }
+    } else {
+        if constexpr (::std::endian::native == ::std::endian::big) {
+            value = ::std::byteswap(value);
+        }
+        ::std::memcpy(out, &value, sizeof(U));
+    }
+}
+
+template<typename T>
+constexpr bool is_array_ = false;
+
+template<typename T, ::std::size_t N>
+constexpr bool is_array_<::mcpprt::container::array<T, N>> = true;
+
+/**
+ * @brief converts to anything, counts the members of an aggregate by how many of it the braces take
+ * @note only used in unevaluated operands, never defined
+ */
+struct any_member {
+    template<typename U>
+    operator U() const noexcept;
+};
+
+template<typename T, ::std::size_t... I>
+[[nodiscard]]
+consteval bool takes_members(::std::index_sequence<I...>) noexcept {
+    return requires { T{(static_cast<void>(I), ::mcpprt::serial::details::any_member{})...}; };
+}
+
+/**
+ * @note counts down, members left out of the braces would need a default constructor
+ */
+template<typename T, ::std::size_t N = ::mcpprt::serial::details::max_members>
+[[nodiscard]]
+consteval auto count_members() noexcept -> ::std::size_t {
+    if constexpr (N == 0 || ::mcpprt::serial::details::takes_members<T>(::std::make_index_sequence<N>{})) {
+        return N;
+    } else {
+        return ::mcpprt::serial::details::count_members<T, N - 1>();
+    }
+}
+
+/**
+ * @brief call `func` with references to the `N` members of `value`
+ */
+template<::std::size_t N, typename T, typename Func>
+constexpr decltype(auto) visit_members(T& value, Func&& func) noexcept {
+    if constexpr (N == 0) {
+        return func();
+    } else if constexpr (N == 1) {
+        auto& [m0] = value;
+        return func(m0);
+    } else if constexpr (N == 2) {
+        auto& [m0, m1] = value;
+        return func(m0, m1);
+    } else if constexpr (N == 3) {
+        auto& [m0, m1, m2] = value;
+        return func(m0, m1, m2);
+    } else if constexpr (N == 4) {
+        auto& [m0, m1, m2, m3] = value;
+        return func(m0, m1, m2, m3);
+    } else if constexpr (N == 5) {
+        auto& [m0, m1, m2, m3, m4] = value;
+        return func(m0, m1, m2, m3, m4);
+    } else if constexpr (N == 6) {
+        auto& [m0, m1, m2, m3, m4, m5] = value;
+        return func(m0, m1, m2, m3, m4, m5);
+    } else if constexpr (N == 7) {
+        auto& [m0, m1, m2, m3, m4, m5, m6] = value;
+        return func(m0, m1, m2, m3, m4, m5, m6);
+    } else if constexpr (N == 8) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7] = value;
+        return func(m0, m1, m2, m3, m4, m5, m6, m7);
+    } else if constexpr (N == 9) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8] = value;
+        return func(m0, m1, m2, m3, m4, m5, m6, m7, m8);
+    } else if constexpr (N == 10) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9] = value;
+        return func(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9);
+    } else if constexpr (N == 11) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10] = value;
+        return func(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10);
+    } else if constexpr (N == 12) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11] = value;
+        return func(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11);
+    } else if constexpr (N == 13) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12] = value;
+        return func(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12);
+    } else if constexpr (N == 14) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13] = value;
+        return func(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13);
+    } else if constexpr (N == 15) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14] = value;
+        return func(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14);
+    } else if constexpr (N == 16) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15] = value;
+        return func(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15);
+    } else {
+        static_assert(N <= ::mcpprt::serial::details::max_members, "aggregates have at most 16 members");
+    }
+}
+
+template<typename T>
+concept is_plain_aggregate = ::std::is_class_v<T> && ::std::is_aggregate_v<T> && !::std::is_union_v<T> &&
+                             !::mcpprt::serial::details::is_array_<T> && !::mcpprt::container::is_static_vector<T> &&
+                             !::exception::is_expected<T>;
+
+/**
+ * @brief the size, alignment and fingerprint of the encoding of `T`, and how to write, read and check it
+ */
+template<typename T>
+struct layout {
+    static constexpr bool supported = false;
+};
+
+template<typename T>
+    requires (::std::is_arithmetic_v<T> || ::std::is_enum_v<T>)
+struct layout<T> {
+private:
+    using underlying = typename decltype([] {
+        if constexpr (::std::is_enum_v<T>) {
+            return ::std::type_identity<::std::underlying_type_t<T>>{};
+        } else {
+            return ::std::type_identity<T>{};
+        }
+    }())::type;
+    using bits = ::mcpprt::serial::details::unsigned_of<sizeof(T)>;
+
+public:
+    static constexpr bool supported =
+        sizeof(T) <= 8 && (!::std::is_floating_point_v<T> || ::std::numeric_limits<T>::is_iec559);
+    static constexpr ::std::size_t size = sizeof(T);
+    static constexpr ::std::size_t alignment = sizeof(T);
+    // whether some encodings are invalid, the others are checked in constant time
+    static constexpr bool checked = ::std::same_as<T, bool>;
+    static constexpr ::std::uint64_t fingerprint = [] {
+        auto encoding = ::mcpprt::serial::details::kind::unsigned_integer;
+        if constexpr (::std::same_as<T, bool>) {
+            encoding = ::mcpprt::serial::details::kind::boolean;
+        } else if constexpr (::std::is_floating_point_v<T>) {
+            encoding = ::mcpprt::serial::details::kind::floating;
+        } else if constexpr (::std::is_signed_v<underlying>) {
+            encoding = ::mcpprt::serial::details::kind::signed_integer;
+        }
+        return ::mcpprt::serial::details::combine({static_cast<::std::uint64_t>(encoding), sizeof(T)});
+    }();
+
+    static constexpr void write(T const& value, ::std::byte* out) noexcept {
+        if constexpr (::std::same_as<T, bool>) {
+            out[0] = static_cast<::std::byte>(value);
+        } else {
+            ::mcpprt::serial::details::store_le(out, ::std::bit_cast<bits>(value));
+        }
+    }
+
+    [[nodiscard]]
+    static constexpr auto read(::std::byte const* in) noexcept -> T {
+        if constexpr (::std::same_as<T, bool>) {
+            return in[0] != ::std::byte{};
+        } else {
+            return ::std::bit_cast<T>(::mcpprt::serial::details::load_le<bits>(in));
+        }
+    }
+
+    [[nodiscard]]
+    static constexpr bool valid(::std::byte const* in) noexcept {
+        if constexpr (::std::same_as<T, bool>) {
+            return ::std::to_integer<unsigned char>(in[0]) <= 1;
+        } else {
+            return true;
+        }
+    }
+};
+
+/**
+ * @brief `N` elements one after the other, for `array` and `static_vector`
+ */
+template<typename T, typename Element, ::std::size_t N>
+struct sequence_layout {
+    using element = ::mcpprt::serial::details::layout<Element>;
+
+    static constexpr bool supported = element::supported;
+    static constexpr ::std::size_t count = N;
+    static constexpr ::std::size_t size = N * element::size;
+    static constexpr ::std::size_t alignment = element::alignment;
+    static constexpr bool checked = element::checked;
+    static constexpr ::std::uint64_t fingerprint =
+        ::mcpprt::serial::details::combine({static_cast<::std::uint64_t>(::mcpprt::serial::details::kind::sequence), N,
+                                            element::fingerprint});
+
+    static constexpr void write(T const& value, ::std::byte* out) noexcept {
+        for (::std::size_t i{}; i < N; ++i) {
+            element::write(value.value_[i], out + i * element::size);
+        }
+    }
+
+    [[nodiscard]]
+    static constexpr auto read(::std::byte const* in) noexcept -> T {
+        if constexpr (::std::default_initializable<Element>) {
+            T result{};
+            for (::std::size_t i{}; i < N; ++i) {
+                result.value_[i] = element::read(in + i * element::size);
+            }
+            return result;
+        } else {
+            return [in]<::std::size_t... I>(::std::index_sequence<I...>) {
+                return T{{element::read(in + I * element::size)...}};
+            }(::std::make_index_sequence<N>{});
+        }
+    }
+
+    [[nodiscard]]
+    static constexpr bool valid(::std::byte const* in) noexcept {
+        if constexpr (element::checked) {
+            for (::std::size_t i{}; i < N; ++i) {
+                if (!element::valid(in + i * element::size)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+
+template<typename T, ::std::size_t N>
+struct layout<::mcpprt::container::array<T, N>>
+    : ::mcpprt::serial::details::sequence_layout<::mcpprt::container::array<T, N>, T, N> {};
+
+template<typename T, ::std::size_t N>
+struct layout<::mcpprt::container::static_vector<T, N>>
+    : ::mcpprt::serial::details::sequence_layout<::mcpprt::container::static_vector<T, N>, T, N> {};
+
+/**
+ * @brief a tag byte, 1 for a value, then the value or the error at the alignment of both
+ */
+template<typename Ok, typename Fail>
+struct layout<::exception::expected<Ok, Fail>> {
+    using ok = ::mcpprt::serial::details::layout<::std::remove_cvref_t<Ok>>;
+    using fail = ::mcpprt::serial::details::layout<::std::remove_cvref_t<Fail>>;
+
+    static constexpr bool supported = ok::supported && fail::supported;
+    static constexpr ::std::size_t alignment = ::std::max({ok::alignment, fail::alignment, ::std::size_t{1}});
+    static constexpr ::std::size_t offset = alignment;
+    static constexpr ::std::size_t size =
+        ::mcpprt::serial::details::align_up(offset + ::std::max(ok::size, fail::size), alignment);
+    static constexpr bool checked = true;
+    static constexpr ::std::uint64_t fingerprint = ::mcpprt::serial::details::combine(
+        {static_cast<::std::uint64_t>(::mcpprt::serial::details::kind::expected), ok::fingerprint, fail::fingerprint});
+
+    static constexpr void write(::exception::expected<Ok, Fail> const& value, ::std::byte* out) noexcept {
+        out[0] = static_cast<::std::byte>(value.has_value());
+        if (value.has_value()) {
+            ok::write(value.value(), out + offset);
+        } else {
+            fail::write(value.error(), out + offset);
+        }
+    }
+
+    [[nodiscard]]
+    static constexpr auto read(::std::byte const* in) noexcept -> ::exception::expected<Ok, Fail> {
+        if (in[0] != ::std::byte{}) {
+            return ok::read(in + offset);
+        }
+        return ::exception::unexpected<Fail>{fail::read(in + offset)};
+    }
+
+    [[nodiscard]]
+    static constexpr bool valid(::std::byte const* in) noexcept {
+        switch (::std::to_integer<unsigned char>(in[0])) {
+        case 0:
+            return fail::valid(in + offset);
+        case 1:
+            return ok::valid(in + offset);
+        default:
+            return false;
+        }
+    }
+};
+
+struct member_types {
+    template<typename... Members>
+    constexpr auto operator()(Members&...) const noexcept
+        -> ::std::type_identity<::std::tuple<::std::remove_cv_t<Members>...>> {
+        return {};
+    }
+};
+
+/**
+ * @brief the member types of an aggregate, in order
+ */
+template<typename T>
+struct aggregate_members {
+    static constexpr ::std::size_t count = ::mcpprt::serial::details::count_members<T>();
+
+    using types = typename decltype(::mcpprt::serial::details::visit_members<count>(
+        ::std::declval<T&>(), ::mcpprt::serial::details::member_types{}))::type;
+
+    static constexpr bool supported = []<::std::size_t... I>(::std::index_sequence<I...>) {
+        return (::mcpprt::serial::details::layout<::std::tuple_element_t<I, types>>::supported && ...);
+    }(::std::make_index_sequence<count>{});
+};
+
+/**
+ * @brief the members in order, each at the next multiple of its alignment
+ */
+template<typename T>
+    requires (::mcpprt::serial::details::is_plain_aggregate<T> &&
+              ::mcpprt::serial::details::aggregate_members<T>::supported)
+struct layout<T> {
+private:
+    using members = typename ::mcpprt::serial::details::aggregate_members<T>::types;
+    static constexpr ::std::size_t count = ::mcpprt::serial::details::aggregate_members<T>::count;
+
+    template<::std::size_t I>
+    using member = ::mcpprt::serial::details::layout<::std::tuple_element_t<I, members>>;
+
+public:
+    static constexpr bool supported = true;
+    static constexpr ::std::size_t alignment = []<::std::size_t... I>(::std::index_sequence<I...>) {
+        return ::std::max({::std::size_t{1}, member<I>::alignment...});
+    }(::std::make_index_sequence<count>{});
+    // the offset of every member, then the end of the last one
+    static constexpr auto offsets = []<::std::size_t... I>(::std::index_sequence<I...>) {
+        ::mcpprt::container::array<::std::size_t, count + 1> result{};
+        ::std::size_t offset{};
+        ((result.value_[I] = ::mcpprt::serial::details::align_up(offset, member<I>::alignment),
+          offset = result.value_[I] + member<I>::size),
+         ...);
+        result.value_[count] = offset;
+        return result;
+    }(::std::make_index_sequence<count>{});
+    static constexpr ::std::size_t size = ::mcpprt::serial::details::align_up(offsets.value_[count], alignment);
+    static constexpr bool checked = []<::std::size_t... I>(::std::index_sequence<I...>) {
+        return (member<I>::checked || ...);
+    }(::std::make_index_sequence<count>{});
+    static constexpr ::std::uint64_t fingerprint = []<::std::size_t... I>(::std::index_sequence<I...>) {
+        return ::mcpprt::serial::details::combine(
+            {static_cast<::std::uint64_t>(::mcpprt::serial::details::kind::aggregate), count,
+             member<I>::fingerprint...});
+    }(::std::make_index_sequence<count>{});
+
+    template<::std::size_t I>
+    using member_type = ::std::tuple_element_t<I, members>;
+
+    static constexpr void write(T const& value, ::std::byte* out) noexcept {
+        ::mcpprt::serial::details::visit_members<count>(value, [out](auto const&... values) noexcept {
+            [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+                (member<I>::write(values, out + offsets.value_[I]), ...);
+            }(::std::make_index_sequence<count>{});
+        });
+    }
+
+    [[nodiscard]]
+    static constexpr auto read(::std::byte const* in) noexcept -> T {
+        return [in]<::std::size_t... I>(::std::index_sequence<I...>) {
+            return T{member<I>::read(in + offsets.value_[I])...};
+        }(::std::make_index_sequence<count>{});
+    }
+
+    [[nodiscard]]
+    static constexpr bool valid(::std::byte const* in) noexcept {
+        return [in]<::std::size_t... I>(::std::index_sequence<I...>) {
+            return ((!member<I>::checked || member<I>::valid(in + offsets.value_[I])) && ...);
+        }(::std::make_index_sequence<count>{});
+    }
+};
+
+} // namespace details
+
+template<typename T>
+concept is_serializable = ::mcpprt::serial::details::layout<::std::remove_cv_t<T>>::supported;
+
+/**
+ * @brief bytes taken by the header and the encoding of `T`
+ */
+template<::mcpprt::serial::is_serializable T>
+inline constexpr ::std::size_t serialized_size =
+    ::mcpprt::serial::details::header_size + ::mcpprt::serial::details::layout<T>::size;
+
+/**
+ * @brief a buffer aligned to this puts every scalar at a multiple of its size
+ */
+template<::mcpprt::serial::is_serializable T>
+inline constexpr ::std::size_t serialized_alignment =
+    ::std::max(::std::size_t{8}, ::mcpprt::serial::details::layout<T>::alignment);
+
+/**
+ * @brief identifies the layout of `T`, two types with the same fingerprint read each other's bytes
+ */
+template<::mcpprt::serial::is_serializable T>
+inline constexpr ::std::uint64_t fingerprint = ::mcpprt::serial::details::combine(
+    {::mcpprt::serial::details::format_version, ::mcpprt::serial::details::layout<T>::fingerprint});
+
+/**
+ * @brief a checked encoding of `T`, read in place
+ * @details scalars are read with `load`, elements with `operator[]`, members with `get<I>` and the alternatives of
+ *          an `expected` with `value` and `error`, each of which is again a view
+ * @note the view does not own the bytes, they must outlive it
+ */
+template<::mcpprt::serial::is_serializable T>
+class view {
+    template<::mcpprt::serial::is_serializable U>
+    friend class view;
+
+    template<::mcpprt::serial::is_serializable U>
+    friend constexpr auto open(::std::byte const* in, ::std::size_t size) noexcept
+        -> ::exception::expected<::mcpprt::serial::view<U>, ::mcpprt::serial::errc>;
+
+    using layout = ::mcpprt::serial::details::layout<T>;
+
+    ::std::byte const* data_;
+
+    constexpr explicit view(::std::byte const* data) noexcept : data_{data} {
+    }
+
+public:
+    /**
+     * @brief the bytes of the encoding, without the header
+     */
+    [[nodiscard]]
+    constexpr auto data(this view const& self) noexcept -> ::std::byte const* {
+        return self.data_;
+    }
+
+    /**
+     * @brief decode the whole value
+     */
+    [[nodiscard]]
+    constexpr auto load(this view const& self) noexcept -> T {
+        return layout::read(self.data_);
+    }
+
+    [[nodiscard]]
+    static constexpr auto size() noexcept -> ::std::size_t
+        requires (::mcpprt::serial::details::is_array_<T> || ::mcpprt::container::is_static_vector<T>)
+    {
+        return layout::count;
+    }
+
+    template<bool ndebug = false>
+        requires (::mcpprt::serial::details::is_array_<T> || ::mcpprt::container::is_static_vector<T>)
+    [[nodiscard]]
+    constexpr auto operator[](this view const& self, ::std::size_t index) noexcept {
+        ::exception::assert_true<ndebug>(index < layout::count);
+        using element = typename T::value_type;
+        return ::mcpprt::serial::view<element>{self.data_ + index * layout::element::size};
+    }
+
+    template<::std::size_t I>
+        requires (::mcpprt::serial::details::is_plain_aggregate<T>)
+    [[nodiscard]]
+    constexpr auto get(this view const& self) noexcept {
+        using member = typename layout::template member_type<I>;
+        return ::mcpprt::serial::view<member>{self.data_ + layout::offsets.value_[I]};
+    }
+
+    [[nodiscard]]
+    constexpr bool has_value(this view const& self) noexcept
+        requires (::exception::is_expected<T>)
+    {
+        return self.data_[0] != ::std::byte{};
+    }
+
+    template<bool ndebug = false>
+        requires (::exception::is_expected<T>)
+    [[nodiscard]]
+    constexpr auto value(this view const& self) noexcept {
+        ::exception::assert_true<ndebug>(self.has_value());
+        return ::mcpprt::serial::view<typename T::value_type>{self.data_ + layout::offset};
+    }
+
+    template<bool ndebug = false>
+        requires (::exception::is_expected<T>)
+    [[nodiscard]]
+    constexpr auto error(this view const& self) noexcept {
+        ::exception::assert_false<ndebug>(self.has_value());
+        return ::mcpprt::serial::view<typename T::error_type>{self.data_ + layout::offset};
+    }
+};
+
+/**
+ * @brief write the header and the encoding of `value` to the start of `out`
+ * @return the number of bytes written, `serialized_size<T>`
+ */
+template<::mcpprt::serial::is_serializable T>
+constexpr auto write(T const& value, ::std::byte* out, ::std::size_t size) noexcept
+    -> ::exception::expected<::std::size_t, ::mcpprt::serial::errc> {
+    using layout = ::mcpprt::serial::details::layout<T>;
+    if (size < ::mcpprt::serial::serialized_size<T>) {
+        return ::exception::unexpected<::mcpprt::serial::errc>{::mcpprt::serial::errc::buffer_too_small};
+    }
+    ::mcpprt::serial::details::store_le(out, ::mcpprt::serial::fingerprint<T>);
+    ::mcpprt::serial::details::store_le(out + 8, static_cast<::std::uint64_t>(layout::size));
+    auto* payload = out + ::mcpprt::serial::details::header_size;
+    ::std::fill(payload, payload + layout::size, ::std::byte{});
+    layout::write(value, payload);
+    return ::mcpprt::serial::serialized_size<T>;
+}
+
+/**
+ * @brief check the header and every `bool` and `expected` tag of `in`, without decoding anything else
+ */
+template<::mcpprt::serial::is_serializable T>
+[[nodiscard]]
+constexpr auto open(::std::byte const* in, ::std::size_t size) noexcept
+    -> ::exception::expected<::mcpprt::serial::view<T>, ::mcpprt::serial::errc> {
+    using layout = ::mcpprt::serial::details::layout<T>;
+    if (size < ::mcpprt::serial::details::header_size) {
+        return ::exception::unexpected<::mcpprt::serial::errc>{::mcpprt::serial::errc::truncated};
+    }
+    if (::mcpprt::serial::details::load_le<::std::uint64_t>(in) != ::mcpprt::serial::fingerprint<T> ||
+        ::mcpprt::serial::details::load_le<::std::uint64_t>(in + 8) != layout::size) {
+        return ::exception::unexpected<::mcpprt::serial::errc>{::mcpprt::serial::errc::layout_mismatch};
+    }
+    if (size < ::mcpprt::serial::serialized_size<T>) {
+        return ::exception::unexpected<::mcpprt::serial::errc>{::mcpprt::serial::errc::truncated};
+    }
+    auto const* payload = in + ::mcpprt::serial::details::header_size;
+    if constexpr (layout::checked) {
+        if (!layout::valid(payload)) {
+            return ::exception::unexpected<::mcpprt::serial::errc>{::mcpprt::serial::errc::invalid_value};
+        }
+    }
+    return ::mcpprt::serial::view<T>{payload};
+}
+
+/**
+ * @brief check `in` and decode it
+ */
+template<::mcpprt::serial::is_serializable T>
+[[nodiscard]]
+constexpr auto read(::std::byte const* in, ::std::size_t size) noexcept
+    -> ::exception::expected<T, ::mcpprt::serial::errc> {
+    auto opened = ::mcpprt::serial::open<T>(in, size);
+    if (!opened.has_value()) {
+        return ::exception::unexpected<::mcpprt::serial::errc>{opened.error()};
+    }
+    return opened.value().load();
+}
+
+} // namespace mcpprt::serial
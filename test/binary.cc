@@ -0,0 +1,174 @@
+#include <cstddef>
+#include <cstdint>
+#include <exception/exception.hh>
+#include <mcpprt/container/array.hh>
+#include <mcpprt/container/static_vector.hh>
+#include <mcpprt/serial/binary.hh>
+
+namespace {
+
+enum class side : ::std::uint8_t {
+    buy,
+    sell,
+};
+
+struct order {
+    ::std::uint32_t id_;
+    ::side side_;
+    double price_;
+    bool active_;
+    ::mcpprt::container::array<::std::int16_t, 3> levels_;
+};
+
+struct message {
+    ::std::uint64_t sequence_;
+    ::order order_;
+    ::exception::expected<float, ::std::uint8_t> quote_;
+    ::mcpprt::container::static_vector<char, 4> tag_;
+};
+
+struct with_pointer {
+    int* pointer_;
+};
+
+inline constexpr ::std::size_t message_size = ::mcpprt::serial::serialized_size<::message>;
+
+using bytes = ::mcpprt::container::array<::std::byte, ::message_size>;
+
+[[nodiscard]]
+constexpr auto make_message(bool quoted) noexcept -> ::message {
+    ::message result{42,
+                     {0x01020304, ::side::sell, -1.5, true, {{-1, 2, -3}}},
+                     2.25f,
+                     ::mcpprt::container::static_vector<char, 4>{"abc"}};
+    if (!quoted) {
+        result.quote_ = ::exception::unexpected<::std::uint8_t>{7};
+    }
+    return result;
+}
+
+[[nodiscard]]
+constexpr auto encode(::message const& value) noexcept -> ::bytes {
+    ::bytes result{};
+    static_cast<void>(::mcpprt::serial::write(value, result.value_, ::message_size).value());
+    return result;
+}
+
+inline constexpr auto encoded = ::encode(::make_message(true));
+
+} // namespace
+
+consteval void test_layout() noexcept {
+    // id, side, padding, price, active, padding, levels, padding
+    static_assert(::mcpprt::serial::serialized_size<::order> == 16 + 24);
+    // sequence, order, quote as a tag and a float, tag
+    static_assert(::message_size == 16 + 48);
+    static_assert(::mcpprt::serial::serialized_alignment<::message> == 8);
+    static_assert(::mcpprt::serial::serialized_size<::exception::optional<::std::uint16_t>> == 16 + 4);
+
+    static_assert(::mcpprt::serial::is_serializable<::message>);
+    static_assert(!::mcpprt::serial::is_serializable<long double>);
+    static_assert(!::mcpprt::serial::is_serializable<int*>);
+    static_assert(!::mcpprt::serial::is_serializable<::with_pointer>);
+
+    static_assert(::mcpprt::serial::fingerprint<::order> != ::mcpprt::serial::fingerprint<::message>);
+    static_assert(::mcpprt::serial::fingerprint<::std::int32_t> != ::mcpprt::serial::fingerprint<::std::uint32_t>);
+    static_assert(::mcpprt::serial::fingerprint<::std::int32_t> != ::mcpprt::serial::fingerprint<float>);
+}
+
+consteval void test_round_trip() noexcept {
+    // little-endian whatever the host
+    static_assert(::encoded.value_[16] == ::std::byte{42} && ::encoded.value_[23] == ::std::byte{});
+    static_assert(::encoded.value_[24] == ::std::byte{4} && ::encoded.value_[27] == ::std::byte{1});
+
+    constexpr auto view = ::mcpprt::serial::open<::message>(::encoded.value_, ::message_size);
+    static_assert(view.has_value());
+    static_assert(view.value().get<0>().load() == 42);
+    static_assert(view.value().get<1>().get<0>().load() == 0x01020304);
+    static_assert(view.value().get<1>().get<1>().load() == ::side::sell);
+    static_assert(view.value().get<1>().get<2>().load() == -1.5);
+    static_assert(view.value().get<1>().get<4>()[2].load() == -3);
+    static_assert(view.value().get<2>().has_value() && view.value().get<2>().value().load() == 2.25f);
+    static_assert(view.value().get<3>().size() == 4 && view.value().get<3>()[1].load() == 'b');
+
+    constexpr auto decoded = ::mcpprt::serial::read<::message>(::encoded.value_, ::message_size);
+    static_assert(decoded.value().order_.active_ && decoded.value().order_.levels_.value_[0] == -1);
+    static_assert(decoded.value().tag_.value_[2] == 'c' && decoded.value().tag_.value_[3] == '\0');
+
+    constexpr auto unquoted = ::encode(::make_message(false));
+    constexpr auto error = ::mcpprt::serial::read<::message>(unquoted.value_, ::message_size);
+    static_assert(!error.value().quote_.has_value() && error.value().quote_.error() == 7);
+}
+
+consteval void test_errors() noexcept {
+    constexpr auto error = [](::bytes input, ::std::size_t size) {
+        auto result = ::mcpprt::serial::open<::message>(input.value_, size);
+        return result.has_value() ? ::mcpprt::serial::errc{0xff} : result.error();
+    };
+    static_assert(error(::encoded, 10) == ::mcpprt::serial::errc::truncated);
+    static_assert(error(::encoded, ::message_size - 1) == ::mcpprt::serial::errc::truncated);
+
+    constexpr auto corrupt = [](::std::size_t offset, ::std::byte value) {
+        auto result = ::encoded;
+        result.value_[offset] = value;
+        return result;
+    };
+    // the fingerprint, a bool, an expected tag
+    static_assert(error(corrupt(3, ::std::byte{1}), ::message_size) == ::mcpprt::serial::errc::layout_mismatch);
+    static_assert(error(corrupt(16 + 8 + 16, ::std::byte{2}), ::message_size) ==
+                  ::mcpprt::serial::errc::invalid_value);
+    static_assert(error(corrupt(16 + 32, ::std::byte{9}), ::message_size) == ::mcpprt::serial::errc::invalid_value);
+    // padding is not checked
+    static_assert(error(corrupt(16 + 8 + 5, ::std::byte{9}), ::message_size) == ::mcpprt::serial::errc{0xff});
+
+    // bytes of another type
+    static_assert(!::mcpprt::serial::open<::order>(::encoded.value_, ::message_size).has_value());
+
+    constexpr auto small = [] {
+        ::mcpprt::container::array<::std::byte, 8> buffer{};
+        return ::mcpprt::serial::write(::std::uint32_t{1}, buffer.value_, 8).error();
+    }();
+    static_assert(small == ::mcpprt::serial::errc::buffer_too_small);
+}
+
+inline void runtime_test_in_place() noexcept {
+    // run time writes the same bytes as constant evaluation
+    alignas(::mcpprt::serial::serialized_alignment<::message>) static ::std::byte buffer[::message_size];
+    auto message = ::make_message(true);
+    ::exception::assert_true(::mcpprt::serial::write(message, buffer, sizeof(buffer)).value() == ::message_size);
+    for (::std::size_t i{}; i < ::message_size; ++i) {
+        ::exception::assert_true(buffer[i] == ::encoded.value_[i]);
+    }
+
+    auto view = ::mcpprt::serial::open<::message>(buffer, sizeof(buffer)).value();
+    ::exception::assert_true(view.get<1>().get<2>().load() == -1.5 && view.get<1>().get<3>().load());
+    ::exception::assert_true(view.get<2>().value().load() == 2.25f);
+
+    buffer[16 + 32] = ::std::byte{3};
+    ::exception::assert_true(::mcpprt::serial::open<::message>(buffer, sizeof(buffer)).error() ==
+                             ::mcpprt::serial::errc::invalid_value);
+}
+
+inline void runtime_test_large() noexcept {
+    // floats need no checking, opening does not touch the payload
+    using samples = ::mcpprt::container::array<float, 10000>;
+    static samples values{};
+    for (::std::size_t i{}; i < 10000; ++i) {
+        values.value_[i] = static_cast<float>(i) * 0.5f;
+    }
+    alignas(8) static ::std::byte buffer[::mcpprt::serial::serialized_size<samples>];
+    static_cast<void>(::mcpprt::serial::write(values, buffer, sizeof(buffer)).value());
+
+    auto view = ::mcpprt::serial::open<samples>(buffer, sizeof(buffer)).value();
+    ::exception::assert_true(view.size() == 10000);
+    for (::std::size_t i{}; i < 10000; ++i) {
+        ::exception::assert_true(view[i].load() == values.value_[i]);
+    }
+}
+
+int main() noexcept {
+    ::runtime_test_in_place();
+    ::runtime_test_large();
+
+    return 0;
+}
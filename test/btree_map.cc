@@ -0,0 +1,172 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <exception/exception.hh>
+#include <mcpprt/container/btree_map.hh>
+#include "xorshift.hh"
+
+inline void runtime_test_basic() noexcept {
+    ::mcpprt::container::btree_map<int, int> map{};
+    ::exception::assert_true(map.empty());
+    ::exception::assert_true(map.begin() == map.end());
+    ::exception::assert_true(!map.get(1).has_value());
+
+    ::exception::assert_true(map.insert(2, 20).second);
+    ::exception::assert_true(map.insert(1, 10).second);
+    ::exception::assert_true(!map.insert(2, 99).second);
+    ::exception::assert_true(map.at(2) == 20);
+    ::exception::assert_true(*map.get(1).value() == 10);
+    ::exception::assert_true(!map.insert_or_assign(2, 21).second);
+    ::exception::assert_true(map.at(2) == 21);
+    ::exception::assert_true(map.size() == 2);
+
+    auto [key, value] = *map.begin();
+    ::exception::assert_true(key == 1 && value == 10);
+    auto last = map.end();
+    --last;
+    ::exception::assert_true(last.key() == 2);
+
+    ::exception::assert_true(map.erase(1) == 1);
+    ::exception::assert_true(map.erase(1) == 0);
+    ::exception::assert_true(map.erase(2) == 1);
+    ::exception::assert_true(map.empty());
+}
+
+/**
+ * @brief the smallest nodes make the tree deep, every split, borrow and merge path runs
+ */
+template<typename Key>
+inline void runtime_test_against_reference() noexcept {
+    constexpr ::std::size_t universe = 2048;
+    ::mcpprt::container::btree_map<Key, ::std::uint32_t, ::std::less<Key>, ::std::allocator<int>, 64> map{};
+    static bool present[universe]{};
+    static ::std::uint32_t expected[universe]{};
+    for (auto& i : present) {
+        i = false;
+    }
+
+    // keys are spread over the whole range of Key, in the same order as their index
+    auto to_key = [](::std::size_t index) noexcept {
+        if constexpr (::std::is_signed_v<Key>) {
+            return static_cast<Key>(static_cast<Key>(index) - static_cast<Key>(universe / 2)) *
+                   static_cast<Key>(::std::numeric_limits<Key>::max() / universe);
+        } else {
+            return static_cast<Key>(index) * static_cast<Key>(::std::numeric_limits<Key>::max() / universe);
+        }
+    };
+
+    ::xorshift next{};
+
+    ::std::size_t size{};
+    for (int round{}; round < 200000; ++round) {
+        auto index = static_cast<::std::size_t>(next() % universe);
+        auto key = to_key(index);
+        // insert more than erase in the first half, then drain
+        bool insert = next() % 8 < (round < 100000 ? 5u : 2u);
+        if (insert) {
+            auto value = static_cast<::std::uint32_t>(next());
+            auto [it, inserted] = map.try_emplace(key, value);
+            ::exception::assert_true(inserted == !present[index]);
+            ::exception::assert_true(it.key() == key);
+            if (inserted) {
+                present[index] = true;
+                expected[index] = value;
+                ++size;
+            }
+        } else {
+            ::exception::assert_true(map.erase(key) == static_cast<::std::size_t>(present[index]));
+            size -= present[index];
+            present[index] = false;
+        }
+        ::exception::assert_true(map.size() == size);
+
+        if (round % 4096 == 0) {
+            // a full forward and backward scan over the linked leaves
+            ::std::size_t index_next{};
+            ::std::size_t seen{};
+            for (auto [k, v] : map) {
+                while (!present[index_next]) {
+                    ++index_next;
+                }
+                ::exception::assert_true(k == to_key(index_next) && v == expected[index_next]);
+                ++index_next;
+                ++seen;
+            }
+            ::exception::assert_true(seen == size);
+            if (size != 0) {
+                auto it = map.end();
+                --it;
+                ::std::size_t back{1};
+                for (; it != map.begin(); --it) {
+                    ++back;
+                }
+                ::exception::assert_true(back == size);
+            }
+        }
+    }
+
+    for (::std::size_t i{}; i < universe; ++i) {
+        auto key = to_key(i);
+        ::exception::assert_true(map.contains(key) == present[i]);
+        auto lower = map.lower_bound(key);
+        auto upper = map.upper_bound(key);
+        auto j = i;
+        while (j < universe && !present[j]) {
+            ++j;
+        }
+        if (j == universe) {
+            ::exception::assert_true(lower == map.end());
+        } else {
+            ::exception::assert_true(lower.key() == to_key(j));
+        }
+        if (present[i]) {
+            ++lower;
+        }
+        ::exception::assert_true(lower == upper);
+    }
+
+    map.clear();
+    ::exception::assert_true(map.empty() && map.begin() == map.end());
+}
+
+inline void runtime_test_custom_compare() noexcept {
+    // not an integer order, the node search falls back to counting with the comparator
+    ::mcpprt::container::btree_map<int, int, ::std::greater<int>, ::std::allocator<int>, 64> map{};
+    for (int i{}; i < 100; ++i) {
+        (void)map.insert(i, i);
+    }
+    int expected{99};
+    for (auto [key, value] : map) {
+        ::exception::assert_true(key == expected--);
+    }
+    ::exception::assert_true(map.lower_bound(50).key() == 50);
+    ::exception::assert_true(map.upper_bound(50).key() == 49);
+}
+
+inline void runtime_test_move() noexcept {
+    ::mcpprt::container::btree_map<int, int> map{};
+    for (int i{}; i < 1000; ++i) {
+        (void)map.insert(i, i * 2);
+    }
+    auto other = ::std::move(map);
+    ::exception::assert_true(map.empty());
+    ::exception::assert_true(other.size() == 1000 && other.at(999) == 1998);
+    map = ::std::move(other);
+    ::exception::assert_true(map.size() == 1000 && other.empty());
+}
+
+int main() noexcept {
+    ::runtime_test_basic();
+    ::runtime_test_against_reference<int>();
+    ::runtime_test_against_reference<unsigned>();
+    ::runtime_test_against_reference<::std::int64_t>();
+    ::runtime_test_against_reference<::std::uint64_t>();
+    ::runtime_test_custom_compare();
+    ::runtime_test_move();
+
+    return 0;
+}
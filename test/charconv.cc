@@ -0,0 +1,164 @@
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <exception/exception.hh>
+#include <mcpprt/container/array.hh>
+#include <mcpprt/format/charconv.hh>
+#include "xorshift.hh"
+
+namespace {
+
+template<typename T, typename... Args>
+constexpr bool formats_as(T value, char const* expected, Args... args) noexcept {
+    ::mcpprt::container::array<char, 64> buffer{};
+    auto size = ::mcpprt::format::to_chars(buffer, value, args...);
+    if (!size.has_value()) {
+        return false;
+    }
+    ::std::size_t i{};
+    for (; i < size.value(); ++i) {
+        if (buffer[i] != expected[i]) {
+            return false;
+        }
+    }
+    return expected[i] == '\0';
+}
+
+template<typename T>
+constexpr auto parse(char const* text, int base = 10) noexcept {
+    auto* last = text;
+    while (*last != '\0') {
+        ++last;
+    }
+    return ::mcpprt::format::from_chars<T>(text, last, base);
+}
+
+} // namespace
+
+consteval void test_integer_to_chars() noexcept {
+    static_assert(::formats_as(0, "0"));
+    static_assert(::formats_as(7u, "7"));
+    static_assert(::formats_as(42, "42"));
+    static_assert(::formats_as(-42, "-42"));
+    static_assert(::formats_as(100, "100"));
+    static_assert(::formats_as(::std::numeric_limits<::std::int64_t>::min(), "-9223372036854775808"));
+    static_assert(::formats_as(::std::numeric_limits<::std::uint64_t>::max(), "18446744073709551615"));
+    static_assert(::formats_as(static_cast<signed char>(-128), "-128"));
+    static_assert(::formats_as(255, "ff", 16));
+    static_assert(::formats_as(-5, "-101", 2));
+    static_assert(::mcpprt::format::to_static_vector<12345>() == "12345");
+    static_assert(::mcpprt::format::to_static_vector<-1>() == "-1");
+}
+
+consteval void test_float_to_chars() noexcept {
+    static_assert(::formats_as(0.0, "0"));
+    static_assert(::formats_as(-0.0, "-0"));
+    static_assert(::formats_as(1.0, "1"));
+    static_assert(::formats_as(0.1, "0.1"));
+    static_assert(::formats_as(0.3, "0.3"));
+    static_assert(::formats_as(0.1 + 0.2, "0.30000000000000004"));
+    static_assert(::formats_as(123.456, "123.456"));
+    static_assert(::formats_as(1e21, "1e+21"));
+    static_assert(::formats_as(1e-7, "1e-07"));
+    static_assert(::formats_as(0.001, "0.001"));
+    static_assert(::formats_as(5e-324, "5e-324"));
+    static_assert(::formats_as(1.7976931348623157e308, "1.7976931348623157e+308"));
+    static_assert(::formats_as(-2.2250738585072014e-308, "-2.2250738585072014e-308"));
+    static_assert(::formats_as(::std::numeric_limits<double>::infinity(), "inf"));
+    static_assert(::formats_as(-::std::numeric_limits<double>::infinity(), "-inf"));
+    static_assert(::formats_as(::std::numeric_limits<double>::quiet_NaN(), "nan"));
+    static_assert(::formats_as(0.1f, "0.1"));
+    static_assert(::formats_as(16777216.0f, "16777216"));
+    static_assert(::formats_as(3.4028235e38f, "3.4028235e+38"));
+    static_assert(::formats_as(1e-45f, "1e-45"));
+    static_assert(::formats_as(1500.0, "1.5e+03", ::mcpprt::format::float_format::scientific));
+    static_assert(::formats_as(1e21, "1000000000000000000000", ::mcpprt::format::float_format::fixed));
+    static_assert(::formats_as(1.5e-3, "0.0015", ::mcpprt::format::float_format::fixed));
+    static_assert(::mcpprt::format::to_static_vector<2.5>() == "2.5");
+}
+
+consteval void test_from_chars() noexcept {
+    static_assert(::parse<int>("12345").value().value_ == 12345);
+    static_assert(::parse<int>("-2147483648").value().value_ == ::std::numeric_limits<int>::min());
+    static_assert(::parse<::std::uint64_t>("18446744073709551615").value().value_ ==
+                  ::std::numeric_limits<::std::uint64_t>::max());
+    static_assert(::parse<::std::uint64_t>("00000000000000000000000001").value().value_ == 1);
+    static_assert(::parse<::std::uint64_t>("1234567890123456789").value().value_ == 1234567890123456789);
+    static_assert(::parse<int>("ff", 16).value().value_ == 255);
+    static_assert(::parse<int>("12ab").value().value_ == 12);
+    static_assert(*::parse<int>("12ab").value().end_ == 'a');
+    static_assert(::parse<int>("abc").error() == ::mcpprt::format::errc::invalid_argument);
+    static_assert(::parse<unsigned>("-1").error() == ::mcpprt::format::errc::invalid_argument);
+    static_assert(::parse<int>("2147483648").error() == ::mcpprt::format::errc::result_out_of_range);
+    static_assert(::parse<::std::uint64_t>("18446744073709551616").error() ==
+                  ::mcpprt::format::errc::result_out_of_range);
+    static_assert(::parse<::std::uint8_t>("256").error() == ::mcpprt::format::errc::result_out_of_range);
+}
+
+inline void runtime_test_buffer_too_small() noexcept {
+    ::mcpprt::container::array<char, 3> buffer{};
+    ::exception::assert_true(::mcpprt::format::to_chars(buffer, 1234).error() ==
+                             ::mcpprt::format::errc::value_too_large);
+    ::exception::assert_true(::mcpprt::format::to_chars(buffer, 0.125).error() ==
+                             ::mcpprt::format::errc::value_too_large);
+    ::exception::assert_true(::mcpprt::format::to_chars(buffer, 123).value() == 3);
+}
+
+inline void runtime_test_integer_round_trip() noexcept {
+    ::mcpprt::container::array<char, ::mcpprt::format::max_chars<::std::int64_t>> buffer{};
+    ::xorshift random{};
+    for (int i{}; i < 100000; ++i) {
+        auto value = static_cast<::std::int64_t>(random()) >> (i % 64);
+        auto size = ::mcpprt::format::to_chars(buffer, value).value();
+        auto parsed = ::mcpprt::format::from_chars<::std::int64_t>(buffer.begin(), buffer.begin() + size).value();
+        ::exception::assert_true(parsed.value_ == value);
+        ::exception::assert_true(parsed.end_ == buffer.begin() + size);
+    }
+}
+
+// the shortest form is unique and `std::to_chars` picks fixed or scientific the same way, so the output must match
+// it byte for byte, and must parse back to the same bits
+inline void check_shortest(double value) noexcept {
+    ::mcpprt::container::array<char, ::mcpprt::format::max_chars<double>> buffer{};
+    char expected[::mcpprt::format::max_chars<double>]{};
+    auto size = ::mcpprt::format::to_chars(buffer, value).value();
+    auto [end, ec] = ::std::to_chars(expected, expected + sizeof(expected), value);
+    ::exception::assert_true(ec == ::std::errc{});
+    ::exception::assert_true(size == static_cast<::std::size_t>(end - expected));
+    for (::std::size_t i{}; i < size; ++i) {
+        ::exception::assert_true(buffer[i] == expected[i]);
+    }
+
+    double parsed{};
+    auto [stop, error] = ::std::from_chars(buffer.begin(), buffer.begin() + size, parsed);
+    ::exception::assert_true(error == ::std::errc{} && stop == buffer.begin() + size);
+    ::exception::assert_true(::std::bit_cast<::std::uint64_t>(parsed) == ::std::bit_cast<::std::uint64_t>(value));
+}
+
+inline void runtime_test_float_digits() noexcept {
+    double value = 1.0;
+    for (int i{}; i < 1000; ++i) {
+        ::check_shortest(value);
+        value /= 2;
+    }
+    ::xorshift random{};
+    for (int i{}; i < 100000; ++i) {
+        auto bits = random();
+        // skip nan and the infinities
+        if ((bits >> 52 & 0x7FF) != 0x7FF) {
+            ::check_shortest(::std::bit_cast<double>(bits));
+        }
+    }
+    ::exception::assert_true(::formats_as(9007199254740993.0, "9007199254740992"));
+    ::exception::assert_true(::formats_as(2.0 / 3.0, "0.6666666666666666"));
+}
+
+int main() noexcept {
+    ::runtime_test_buffer_too_small();
+    ::runtime_test_integer_round_trip();
+    ::runtime_test_float_digits();
+
+    return 0;
+}
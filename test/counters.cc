@@ -0,0 +1,67 @@
+#define MCPPRT_ENABLE_INSTRUMENT
+#include <cstddef>
+#include <exception/exception.hh>
+#include <mcpprt/instrument/counters.hh>
+
+consteval void test_constexpr_hooks() noexcept {
+    // the hooks do nothing during constant evaluation
+    static_assert([] {
+        auto const where = ::mcpprt::instrument::make_site("test", ::mcpprt::instrument::location::current());
+        ::mcpprt::instrument::on_allocate(where, 16);
+        ::mcpprt::instrument::on_deallocate(where, 16);
+        ::mcpprt::instrument::on_reallocate(where);
+        ::mcpprt::instrument::on_grow(where, 4);
+        ::mcpprt::instrument::on_relocate(where, 64);
+        return true;
+    }());
+}
+
+[[nodiscard]]
+inline auto make_site(::mcpprt::instrument::location where = ::mcpprt::instrument::location::current()) noexcept {
+    return ::mcpprt::instrument::make_site("test", where);
+}
+
+inline void runtime_test_snapshot() noexcept {
+    auto const a = ::make_site();
+    auto const b = ::make_site();
+
+    ::mcpprt::instrument::on_allocate(a, 16);
+    ::mcpprt::instrument::on_allocate(a, 32);
+    ::mcpprt::instrument::on_grow(a, 2);
+    ::mcpprt::instrument::on_grow(a, 8);
+    ::mcpprt::instrument::on_grow(a, 4);
+    ::mcpprt::instrument::on_reallocate(a);
+    ::mcpprt::instrument::on_relocate(a, 64);
+    ::mcpprt::instrument::on_deallocate(a, 16);
+    ::mcpprt::instrument::on_allocate(b, 8);
+
+    auto const result = ::mcpprt::instrument::take_snapshot();
+    ::exception::assert_true(result.size == 2);
+    ::exception::assert_true(result.total.allocations == 3);
+    ::exception::assert_true(result.total.bytes_allocated == 56);
+    ::exception::assert_true(result.total.peak_capacity == 8);
+
+    ::std::size_t found{};
+    for (auto const& entry : result) {
+        if (entry.line == a.where_.line()) {
+            ::exception::assert_true(entry.value.allocations == 2);
+            ::exception::assert_true(entry.value.deallocations == 1);
+            ::exception::assert_true(entry.value.bytes_deallocated == 16);
+            ::exception::assert_true(entry.value.growths == 3);
+            ::exception::assert_true(entry.value.reallocations == 1);
+            ::exception::assert_true(entry.value.relocated_bytes == 64);
+            ++found;
+        } else if (entry.line == b.where_.line()) {
+            ::exception::assert_true(entry.value.allocations == 1);
+            ::exception::assert_true(entry.value.peak_capacity == 0);
+            ++found;
+        }
+    }
+    ::exception::assert_true(found == 2);
+}
+
+int main() noexcept {
+    ::runtime_test_snapshot();
+
+    return 0;
+}
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <exception/exception.hh>
+#include <mcpprt/container/d_ary_heap.hh>
+#include "xorshift.hh"
+
+static_assert(::mcpprt::container::default_arity<::std::uint32_t> == 16);
+static_assert(::mcpprt::container::default_arity<::std::uint64_t> == 8);
+static_assert(::mcpprt::container::default_arity<char[200]> == 2);
+
+consteval void test_constexpr() noexcept {
+    constexpr auto sorted = [] {
+        ::mcpprt::container::d_ary_heap<int, 3> heap{5, 1, 9, 3, 7, 2, 8};
+        heap.push(6);
+        heap.push(4);
+        int result{};
+        while (!heap.empty()) {
+            result = result * 10 + heap.top();
+            heap.pop();
+        }
+        return result;
+    }();
+    static_assert(sorted == 987654321);
+
+    constexpr auto fixed = [] {
+        ::mcpprt::container::static_d_ary_heap<int, 4, 2, ::std::greater<int>> heap{};
+        bool pushed = heap.push(3) && heap.push(1) && heap.push(4) && heap.push(2);
+        bool overflowed = heap.push(0);
+        int result{};
+        while (!heap.empty()) {
+            result = result * 10 + heap.top();
+            heap.pop();
+        }
+        return pushed && !overflowed ? result : -1;
+    }();
+    static_assert(fixed == 1234);
+
+    constexpr auto indexed = [] {
+        ::mcpprt::container::indexed_d_ary_heap<int, 4, ::std::greater<int>> heap{5};
+        heap.push(0, 50);
+        heap.push(1, 10);
+        heap.push(2, 30);
+        heap.push(3, 40);
+        heap.update(3, 5);
+        bool raised = heap.push_or_raise(0, 1);
+        bool kept = !heap.push_or_raise(1, 20);
+        heap.push_or_raise(4, 25);
+        (void)heap.erase(2);
+        int result{};
+        while (!heap.empty()) {
+            result = result * 10 + static_cast<int>(heap.top_key());
+            heap.pop();
+        }
+        return raised && kept ? result : -1;
+    }();
+    static_assert(indexed == 314);
+}
+
+/**
+ * @brief pushes and pops interleaved give the same order as sorting
+ */
+template<::std::size_t Arity>
+inline void runtime_test_order() noexcept {
+    constexpr ::std::size_t count = 20000;
+    static ::std::uint64_t values[count];
+    ::xorshift next{};
+    for (auto& value : values) {
+        value = next() % 5000;
+    }
+
+    ::mcpprt::container::d_ary_heap<::std::uint64_t, Arity> heap{};
+    ::std::size_t popped{};
+    for (::std::size_t i{}; i < count; ++i) {
+        heap.push(values[i]);
+        if (i % 3 == 2) {
+            auto greatest = heap.top();
+            heap.pop();
+            ++popped;
+            ::exception::assert_true(heap.top() <= greatest);
+        }
+    }
+    ::exception::assert_true(heap.size() == count - popped);
+
+    // bulk construction drains sorted
+    ::mcpprt::container::d_ary_heap<::std::uint64_t, Arity> bulk{values, values + count};
+    ::std::sort(values, values + count);
+    for (::std::size_t i{count}; i-- != 0;) {
+        ::exception::assert_true(bulk.top() == values[i]);
+        bulk.pop();
+    }
+    ::exception::assert_true(bulk.empty());
+}
+
+/**
+ * @brief the 100 smallest of a stream, kept in a max-heap that never allocates
+ */
+inline void runtime_test_top_k() noexcept {
+    constexpr ::std::size_t count = 10000;
+    constexpr ::std::size_t k = 100;
+    static ::std::uint32_t values[count];
+    ::xorshift next{};
+    for (auto& value : values) {
+        value = static_cast<::std::uint32_t>(next());
+    }
+
+    ::mcpprt::container::static_d_ary_heap<::std::uint32_t, k> best{};
+    for (auto value : values) {
+        if (!best.full()) {
+            (void)best.push(value);
+        } else if (value < best.top()) {
+            best.replace_top(value);
+        }
+    }
+    ::std::sort(values, values + count);
+    for (::std::size_t i{k}; i-- != 0;) {
+        ::exception::assert_true(best.top() == values[i]);
+        best.pop();
+    }
+}
+
+/**
+ * @brief Dijkstra on a random grid agrees with Bellman-Ford
+ */
+inline void runtime_test_dijkstra() noexcept {
+    constexpr ::std::size_t side = 40;
+    constexpr ::std::size_t nodes = side * side;
+    constexpr ::std::uint64_t infinity = ::std::numeric_limits<::std::uint64_t>::max();
+    // the cost of entering each node
+    static ::std::uint64_t cost[nodes];
+    ::xorshift next{};
+    for (auto& c : cost) {
+        c = next() % 100 + 1;
+    }
+    auto for_neighbors = [](::std::size_t node, auto&& func) noexcept {
+        auto row = node / side;
+        auto column = node % side;
+        if (row != 0) {
+            func(node - side);
+        }
+        if (row + 1 != side) {
+            func(node + side);
+        }
+        if (column != 0) {
+            func(node - 1);
+        }
+        if (column + 1 != side) {
+            func(node + 1);
+        }
+    };
+
+    static ::std::uint64_t expected[nodes];
+    ::std::fill(expected, expected + nodes, infinity);
+    expected[0] = 0;
+    for (bool changed{true}; changed;) {
+        changed = false;
+        for (::std::size_t node{}; node < nodes; ++node) {
+            if (expected[node] == infinity) {
+                continue;
+            }
+            for_neighbors(node, [&](::std::size_t other) noexcept {
+                if (expected[node] + cost[other] < expected[other]) {
+                    expected[other] = expected[node] + cost[other];
+                    changed = true;
+                }
+            });
+        }
+    }
+
+    static ::std::uint64_t distance[nodes];
+    ::std::fill(distance, distance + nodes, infinity);
+    ::mcpprt::container::indexed_d_ary_heap<::std::uint64_t, 4, ::std::greater<::std::uint64_t>> queue{nodes};
+    queue.push(0, 0);
+    while (!queue.empty()) {
+        auto node = queue.top_key();
+        distance[node] = queue.top_priority();
+        queue.pop();
+        for_neighbors(node, [&](::std::size_t other) noexcept {
+            if (distance[other] == infinity) {
+                (void)queue.push_or_raise(other, distance[node] + cost[other]);
+            }
+        });
+    }
+    ::exception::assert_true(::std::equal(distance, distance + nodes, expected));
+}
+
+int main() noexcept {
+    ::runtime_test_order<2>();
+    ::runtime_test_order<4>();
+    ::runtime_test_order<::mcpprt::container::default_arity<::std::uint64_t>>();
+    ::runtime_test_top_k();
+    ::runtime_test_dijkstra();
+
+    return 0;
+}
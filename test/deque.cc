@@ -0,0 +1,145 @@
+#define MCPPRT_ENABLE_INSTRUMENT
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <exception/exception.hh>
+#include <mcpprt/container/deque.hh>
+#include <mcpprt/instrument/counters.hh>
+#include "xorshift.hh"
+
+static_assert(::std::random_access_iterator<::mcpprt::container::deque<int>::iterator>);
+static_assert(::std::random_access_iterator<::mcpprt::container::deque<int>::const_iterator>);
+
+inline void runtime_test_basic() noexcept {
+    ::mcpprt::container::deque<int> queue{};
+    ::exception::assert_true(queue.empty() && queue.begin() == queue.end());
+
+    queue.push_back(1);
+    queue.push_front(0);
+    queue.emplace_back(2);
+    ::exception::assert_true(queue.size() == 3);
+    ::exception::assert_true(queue.front() == 0 && queue.back() == 2 && queue[1] == 1);
+    ::exception::assert_true(queue.end() - queue.begin() == 3 && queue.begin()[2] == 2);
+
+    queue.pop_front();
+    queue.pop_back();
+    ::exception::assert_true(queue.size() == 1 && queue.at(0) == 1);
+    queue.pop_back();
+    ::exception::assert_true(queue.empty());
+}
+
+/**
+ * @brief references handed out before growing at either end still point at the same elements
+ */
+inline void runtime_test_stable_references() noexcept {
+    ::mcpprt::container::deque<::std::uint64_t, ::std::allocator<::std::uint64_t>, 64> queue{};
+    queue.push_back(42);
+    auto* first = &queue.front();
+    for (::std::uint64_t i{}; i < 10000; ++i) {
+        queue.push_back(i);
+        queue.push_front(i);
+    }
+    ::exception::assert_true(*first == 42 && &queue[10000] == first);
+}
+
+/**
+ * @brief a ring buffer is the reference, the small block size crosses block and map boundaries all the time
+ */
+inline void runtime_test_against_reference() noexcept {
+    constexpr ::std::size_t ring = 1 << 16;
+    static ::std::uint64_t expected[ring]{};
+    ::std::size_t head{ring / 2};
+    ::std::size_t size{};
+
+    ::mcpprt::container::deque<::std::uint64_t, ::std::allocator<::std::uint64_t>, 64> queue{};
+    ::xorshift next{};
+
+    for (int round{}; round < 400000; ++round) {
+        auto op = next() % 16;
+        // drift between growing and shrinking phases so both the recentering and the reallocation run
+        bool grow = (round / 50000) % 2 == 0 ? op < 9 : op < 7;
+        if (grow && size + 1 < ring) {
+            auto value = next();
+            if (op % 2 == 0) {
+                queue.push_back(value);
+                expected[(head + size) % ring] = value;
+            } else {
+                queue.push_front(value);
+                head = (head + ring - 1) % ring;
+                expected[head] = value;
+            }
+            ++size;
+        } else if (size != 0) {
+            if (op % 2 == 0) {
+                ::exception::assert_true(queue.back() == expected[(head + size - 1) % ring]);
+                queue.pop_back();
+            } else {
+                ::exception::assert_true(queue.front() == expected[head]);
+                queue.pop_front();
+                head = (head + 1) % ring;
+            }
+            --size;
+        }
+        ::exception::assert_true(queue.size() == size);
+
+        if (round % 8192 == 0) {
+            ::std::size_t i{};
+            for (auto value : queue) {
+                ::exception::assert_true(value == expected[(head + i) % ring]);
+                ++i;
+            }
+            ::exception::assert_true(i == size);
+            for (::std::size_t j{}; j < size; j += 7) {
+                ::exception::assert_true(queue[j] == expected[(head + j) % ring]);
+            }
+        }
+    }
+
+    auto copy = queue;
+    ::exception::assert_true(copy.size() == queue.size());
+    for (::std::size_t i{}; i < size; ++i) {
+        ::exception::assert_true(copy[i] == queue[i]);
+    }
+}
+
+/**
+ * @brief a queue that keeps filling and draining stops allocating once it has seen its largest size
+ */
+inline void runtime_test_block_reuse() noexcept {
+    ::mcpprt::container::deque<::std::unique_ptr<int>> queue{};
+    auto fill_and_drain = [&queue]() noexcept {
+        for (int i{}; i < 5000; ++i) {
+            queue.push_back(::std::make_unique<int>(i));
+        }
+        for (int i{}; i < 5000; ++i) {
+            ::exception::assert_true(*queue.front() == i);
+            queue.pop_front();
+        }
+    };
+
+    // the first rounds grow the map of blocks until the full queue fits around its middle
+    fill_and_drain();
+    fill_and_drain();
+    auto const before = ::mcpprt::instrument::take_snapshot().total;
+    for (int round{}; round < 10; ++round) {
+        fill_and_drain();
+    }
+    auto const after = ::mcpprt::instrument::take_snapshot().total;
+    ::exception::assert_true(after.allocations == before.allocations);
+    ::exception::assert_true(after.deallocations == before.deallocations);
+
+    queue.shrink_to_fit();
+    auto const shrunk = ::mcpprt::instrument::take_snapshot().total;
+    ::exception::assert_true(shrunk.deallocations > after.deallocations);
+}
+
+int main() noexcept {
+    ::runtime_test_basic();
+    ::runtime_test_stable_references();
+    ::runtime_test_against_reference();
+    ::runtime_test_block_reuse();
+
+    return 0;
+}
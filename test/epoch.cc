@@ -0,0 +1,299 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <exception/exception.hh>
+#include <mcpprt/memory/epoch.hh>
+#include <mcpprt/memory/pool.hh>
+
+namespace {
+
+inline ::std::size_t reclaimed{};
+
+inline void count(void*) noexcept {
+    ++::reclaimed;
+}
+
+struct node {
+    int value_;
+
+    ~node() noexcept {
+        ++::reclaimed;
+    }
+};
+
+inline ::std::size_t records{};
+
+// counts the records a domain allocates
+template<typename T>
+struct counting_allocator : ::std::allocator<T> {
+    counting_allocator() noexcept = default;
+
+    template<typename U>
+    counting_allocator(::counting_allocator<U> const&) noexcept {
+    }
+
+    auto allocate(::std::size_t n) noexcept -> T* {
+        if constexpr (::std::is_same_v<T, ::mcpprt::memory::details::epoch_record>) {
+            ++::records;
+        }
+        return ::std::allocator<T>::allocate(n);
+    }
+};
+
+inline constexpr ::std::uint64_t alive = 0xA11CEA11CEA11CE;
+inline constexpr ::std::uint64_t dead = 0xDEADDEADDEADDEAD;
+
+inline ::std::atomic<::std::size_t> created{};
+inline ::std::atomic<::std::size_t> destroyed{};
+
+// a node of a Treiber stack, readers check the canary of every node they reach
+struct stack_node {
+    ::std::atomic<::std::uint64_t> canary_{::alive};
+    ::stack_node* next_{};
+
+    stack_node() noexcept {
+        ::created.fetch_add(1, ::std::memory_order_relaxed);
+    }
+
+    ~stack_node() noexcept {
+        canary_.store(::dead, ::std::memory_order_relaxed);
+        ::destroyed.fetch_add(1, ::std::memory_order_relaxed);
+    }
+};
+
+} // namespace
+
+consteval void test_layout() noexcept {
+    static_assert(alignof(::mcpprt::memory::details::epoch_record) == 64);
+    static_assert(sizeof(::mcpprt::memory::details::epoch_batch) <= 1024);
+}
+
+inline void runtime_test_pin() noexcept {
+    ::mcpprt::memory::epoch_domain<> domain{};
+    auto self = domain.enroll();
+    ::exception::assert_false(self.pinned());
+    {
+        auto outer = self.pin();
+        {
+            auto inner = self.pin();
+            ::exception::assert_true(self.pinned());
+        }
+        ::exception::assert_true(self.pinned());
+    }
+    ::exception::assert_false(self.pinned());
+
+    // nobody pinned, every attempt moves the epoch
+    auto epoch = domain.epoch();
+    self.collect();
+    self.collect();
+    ::exception::assert_true(domain.epoch() == epoch + 2);
+}
+
+inline void runtime_test_deferred() noexcept {
+    ::reclaimed = 0;
+    ::mcpprt::memory::epoch_domain<> domain{};
+    auto self = domain.enroll();
+    int value{};
+    self.retire(&value, ::count);
+    ::exception::assert_true(self.pending() == 1 && ::reclaimed == 0);
+    // freed two epochs later
+    self.collect();
+    ::exception::assert_true(::reclaimed == 0);
+    self.collect();
+    ::exception::assert_true(self.pending() == 0 && ::reclaimed == 1);
+}
+
+inline void runtime_test_reader() noexcept {
+    ::reclaimed = 0;
+    ::mcpprt::memory::epoch_domain<> domain{};
+    auto writer = domain.enroll();
+    auto reader = domain.enroll();
+    int value{};
+    {
+        auto guard = reader.pin();
+        writer.retire(&value, ::count);
+        // the reader saw the current epoch, it may move once but not twice
+        auto epoch = domain.epoch();
+        for (int i{}; i < 10; ++i) {
+            writer.collect();
+        }
+        ::exception::assert_true(domain.epoch() == epoch + 1);
+        ::exception::assert_true(writer.pending() == 1 && ::reclaimed == 0);
+    }
+    writer.synchronize();
+    ::exception::assert_true(::reclaimed == 1);
+}
+
+inline void runtime_test_bounded() noexcept {
+    ::reclaimed = 0;
+    ::mcpprt::memory::epoch_domain<> domain{};
+    auto self = domain.enroll();
+    int value{};
+    for (::std::size_t i{}; i < 100 * ::mcpprt::memory::epoch_batch_size; ++i) {
+        self.retire(&value, ::count);
+        ::exception::assert_true(self.pending() <= 3 * ::mcpprt::memory::epoch_batch_size);
+    }
+    self.synchronize();
+    ::exception::assert_true(::reclaimed == 100 * ::mcpprt::memory::epoch_batch_size);
+}
+
+inline void runtime_test_orphans() noexcept {
+    ::reclaimed = 0;
+    ::mcpprt::memory::epoch_domain<> domain{};
+    auto survivor = domain.enroll();
+    int value{};
+    {
+        auto guard = survivor.pin();
+        {
+            auto leaver = domain.enroll();
+            leaver.retire(&value, ::count);
+            leaver.retire(&value, ::count);
+        }
+        // the batch of the released handle is kept while a reader is pinned
+        for (int i{}; i < 10; ++i) {
+            survivor.collect();
+        }
+        ::exception::assert_true(::reclaimed == 0);
+    }
+    // and freed by whoever collects next
+    survivor.collect();
+    survivor.collect();
+    ::exception::assert_true(::reclaimed == 2);
+}
+
+inline void runtime_test_reuse() noexcept {
+    ::records = 0;
+    ::mcpprt::memory::epoch_domain<::counting_allocator<::std::byte>> domain{};
+    {
+        auto first = domain.enroll();
+        auto second = domain.enroll();
+    }
+    ::exception::assert_true(::records == 2);
+    // the records of released handles are taken before allocating new ones
+    for (int i{}; i < 10; ++i) {
+        auto again = domain.enroll();
+    }
+    auto first = domain.enroll();
+    auto second = domain.enroll();
+    ::exception::assert_true(::records == 2);
+    auto third = domain.enroll();
+    ::exception::assert_true(::records == 3);
+}
+
+inline void runtime_test_allocator() noexcept {
+    ::reclaimed = 0;
+    ::mcpprt::memory::epoch_domain<> domain{};
+    auto self = domain.enroll();
+    ::mcpprt::memory::pool_allocator<::node> alloc{};
+    for (int i{}; i < 1000; ++i) {
+        auto* ptr = alloc.allocate(1);
+        ::std::construct_at(ptr, i);
+        self.retire(ptr);
+    }
+    self.synchronize();
+    ::exception::assert_true(::reclaimed == 1000);
+
+    // left to the domain
+    auto other = domain.enroll();
+    auto* ptr = alloc.allocate(1);
+    ::std::construct_at(ptr, 0);
+    other.retire(ptr);
+}
+
+inline void runtime_test_threads() noexcept {
+    using node_allocator = ::std::allocator<::stack_node>;
+    constexpr int readers = 4;
+    constexpr int writers = 2;
+    constexpr int rounds = 20000;
+
+    ::created = 0;
+    ::destroyed = 0;
+    {
+        // the pool never returns the chunks of a thread that exits, they would show up as leaks
+        ::mcpprt::memory::epoch_domain<::std::allocator<::std::byte>> domain{};
+        ::std::atomic<::stack_node*> head{};
+        ::std::atomic<int> running{writers};
+
+        auto push = [&head] noexcept {
+            node_allocator alloc{};
+            auto* node = ::std::construct_at(alloc.allocate(1));
+            node->next_ = head.load(::std::memory_order_relaxed);
+            while (!head.compare_exchange_weak(node->next_, node, ::std::memory_order_release,
+                                               ::std::memory_order_relaxed)) {
+            }
+        };
+        // pinned, so the head cannot be freed and reused before the exchange
+        auto pop = [&head](auto& self) noexcept {
+            ::stack_node* node{};
+            {
+                auto guard = self.pin();
+                node = head.load(::std::memory_order_acquire);
+                while (node != nullptr && !head.compare_exchange_weak(node, node->next_, ::std::memory_order_acquire,
+                                                                      ::std::memory_order_acquire)) {
+                }
+            }
+            if (node != nullptr) {
+                self.template retire<::stack_node, node_allocator>(node);
+            }
+        };
+
+        for (int i{}; i < 8; ++i) {
+            push();
+        }
+        ::std::thread threads[readers + writers];
+        for (int i{}; i < readers; ++i) {
+            threads[i] = ::std::thread{[&] noexcept {
+                auto self = domain.enroll();
+                while (running.load(::std::memory_order_acquire) != 0) {
+                    auto guard = self.pin();
+                    for (auto* node = head.load(::std::memory_order_acquire); node != nullptr; node = node->next_) {
+                        // give the writers the time to pop and retire the node while it is held
+                        ::std::this_thread::yield();
+                        ::exception::assert_true(node->canary_.load(::std::memory_order_relaxed) == ::alive);
+                    }
+                }
+            }};
+        }
+        for (int i{}; i < writers; ++i) {
+            threads[readers + i] = ::std::thread{[&] noexcept {
+                auto self = domain.enroll();
+                // the stack stays short, so the readers keep reaching the nodes being popped and freed
+                for (int round{}; round < rounds; ++round) {
+                    pop(self);
+                    push();
+                    self.collect();
+                    ::std::this_thread::yield();
+                }
+                running.fetch_sub(1, ::std::memory_order_release);
+            }};
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        auto self = domain.enroll();
+        while (head.load(::std::memory_order_relaxed) != nullptr) {
+            pop(self);
+        }
+        self.synchronize();
+    }
+    // the nodes left by the threads are freed with the domain
+    ::exception::assert_true(::created.load() == static_cast<::std::size_t>(8 + writers * rounds));
+    ::exception::assert_true(::destroyed.load() == ::created.load());
+}
+
+int main() noexcept {
+    ::runtime_test_pin();
+    ::runtime_test_deferred();
+    ::runtime_test_reader();
+    ::runtime_test_bounded();
+    ::runtime_test_orphans();
+    ::runtime_test_reuse();
+    ::runtime_test_allocator();
+    ::runtime_test_threads();
+
+    return 0;
+}
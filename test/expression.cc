@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cstddef>
+#include <exception/exception.hh>
+#include <mcpprt/container/array.hh>
+#include <mcpprt/container/static_vector.hh>
+#include <mcpprt/numeric/expression.hh>
+
+namespace {
+
+using ::mcpprt::numeric::lazy;
+
+template<typename T, ::std::size_t N>
+[[nodiscard]]
+constexpr bool equal(::mcpprt::container::array<T, N> const& left,
+                     ::mcpprt::container::array<T, N> const& right) noexcept {
+    return ::std::ranges::equal(left.value_, right.value_);
+}
+
+/**
+ * @brief a contiguous range whose size is only known at run time, as a vector would be
+ */
+struct buffer {
+    float* data_;
+    ::std::size_t size_;
+
+    [[nodiscard]]
+    constexpr auto data(this buffer const& self) noexcept -> float* {
+        return self.data_;
+    }
+
+    [[nodiscard]]
+    constexpr auto size(this buffer const& self) noexcept -> ::std::size_t {
+        return self.size_;
+    }
+};
+
+inline constexpr ::std::size_t large_size = 1000;
+
+[[nodiscard]]
+consteval auto make_large() noexcept -> ::mcpprt::container::array<float, large_size> {
+    ::mcpprt::container::array<float, large_size> result{};
+    for (::std::size_t i{}; i < large_size; ++i) {
+        result.value_[i] = static_cast<float>(i % 17) * 0.1f - 0.7f;
+    }
+    return result;
+}
+
+inline constexpr auto large = ::make_large();
+
+} // namespace
+
+consteval void test_arithmetic() noexcept {
+    constexpr ::mcpprt::container::array<float, 4> a{{1.0f, 2.0f, 3.0f, 4.0f}};
+    constexpr ::mcpprt::container::array<float, 4> b{{0.5f, -1.0f, 2.0f, 8.0f}};
+
+    static_assert(::equal(::mcpprt::numeric::evaluate(lazy(a) * 2.0f + b), {{2.5f, 3.0f, 8.0f, 16.0f}}));
+    static_assert(::equal(::mcpprt::numeric::evaluate(-lazy(a) / b - 1.0f), {{-3.0f, 1.0f, -2.5f, -1.5f}}));
+    static_assert(::equal(::mcpprt::numeric::evaluate(10.0f - lazy(a)), {{9.0f, 8.0f, 7.0f, 6.0f}}));
+    static_assert(
+        ::equal(::mcpprt::numeric::evaluate(::mcpprt::numeric::abs(lazy(b) - a)), {{0.5f, 3.0f, 1.0f, 4.0f}}));
+    static_assert(
+        ::equal(::mcpprt::numeric::evaluate(::mcpprt::numeric::min(lazy(a), b)), {{0.5f, -1.0f, 2.0f, 4.0f}}));
+    static_assert(
+        ::equal(::mcpprt::numeric::evaluate(::mcpprt::numeric::max(lazy(a), 2.5f)), {{2.5f, 2.5f, 3.0f, 4.0f}}));
+
+    // the destination may also be an operand
+    constexpr auto axpy = [](::mcpprt::container::array<float, 4> y, ::mcpprt::container::array<float, 4> const& x) {
+        ::mcpprt::numeric::assign(y, lazy(x) * 3.0f + y);
+        return y;
+    };
+    static_assert(::equal(axpy(b, a), {{3.5f, 5.0f, 11.0f, 20.0f}}));
+
+    constexpr auto fill = [] {
+        ::mcpprt::container::array<int, 3> result{};
+        ::mcpprt::numeric::assign(result, 7);
+        return result;
+    };
+    static_assert(::equal(fill(), {{7, 7, 7}}));
+}
+
+consteval void test_select() noexcept {
+    constexpr ::mcpprt::container::array<int, 5> a{{-2, 5, 0, 9, -7}};
+    constexpr ::mcpprt::container::array<int, 5> b{{1, 1, 1, 1, 1}};
+
+    // clamp to [0, 6]
+    static_assert(::equal(::mcpprt::numeric::evaluate(::mcpprt::numeric::select(lazy(a) < 0, 0,
+                                                                                ::mcpprt::numeric::min(lazy(a), 6))),
+                          {{0, 5, 0, 6, 0}}));
+    static_assert(::equal(::mcpprt::numeric::evaluate(::mcpprt::numeric::select(lazy(a) > b, a, b)),
+                          {{1, 5, 1, 9, 1}}));
+    static_assert(
+        ::equal(::mcpprt::numeric::evaluate(lazy(a) >= 0 && lazy(a) != 9), {{false, true, true, false, false}}));
+    static_assert(::equal(::mcpprt::numeric::evaluate(!(lazy(a) == 0)), {{true, true, false, true, true}}));
+}
+
+consteval void test_reduce() noexcept {
+    constexpr ::mcpprt::container::array<int, 5> a{{-2, 5, 0, 9, -7}};
+    constexpr ::mcpprt::container::static_vector<int, 5> b{{1, 2, 3, 4, 5}};
+
+    static_assert(::mcpprt::numeric::sum(a) == 5);
+    static_assert(::mcpprt::numeric::sum(lazy(a) * lazy(a)) == 159);
+    static_assert(::mcpprt::numeric::dot(a, b) == -2 + 10 + 0 + 36 - 35);
+    static_assert(::mcpprt::numeric::reduce_min(a) == -7);
+    static_assert(::mcpprt::numeric::reduce_max(lazy(a) + b) == 13);
+    static_assert(::mcpprt::numeric::all(lazy(b) > 0));
+    static_assert(!::mcpprt::numeric::all(lazy(a) > 0));
+    static_assert(::mcpprt::numeric::any(lazy(a) == 9));
+    static_assert(!::mcpprt::numeric::any(lazy(a) > 9));
+
+    // more elements than there are partial results
+    static_assert(::mcpprt::numeric::reduce_min(::large) == -0.7f);
+    static_assert(::mcpprt::numeric::reduce_max(::large) > 0.89f && ::mcpprt::numeric::reduce_max(::large) < 0.91f);
+}
+
+inline void runtime_test_fused() noexcept {
+    static float x[::large_size];
+    static float y[::large_size];
+    static float z[::large_size];
+    for (::std::size_t i{}; i < ::large_size; ++i) {
+        x[i] = ::large.value_[i];
+        y[i] = static_cast<float>(i);
+    }
+    ::buffer xs{x, ::large_size};
+    ::buffer ys{y, ::large_size};
+    ::buffer zs{z, ::large_size};
+
+    // five operations in one pass
+    ::mcpprt::numeric::assign(zs,
+                              ::mcpprt::numeric::select(lazy(xs) > 0.0f, lazy(xs) * 2.0f + ys, lazy(ys) - xs) / 4.0f);
+    for (::std::size_t i{}; i < ::large_size; ++i) {
+        auto expected = (x[i] > 0.0f ? x[i] * 2.0f + y[i] : y[i] - x[i]) / 4.0f;
+        ::exception::assert_true(z[i] == expected);
+    }
+
+    // run-time ranges mix with arrays of the same size
+    ::mcpprt::container::array<float, ::large_size> result{};
+    ::mcpprt::numeric::assign(result, lazy(::large) - xs);
+    ::exception::assert_true(::mcpprt::numeric::all(lazy(result) == 0.0f));
+}
+
+inline void runtime_test_reduce() noexcept {
+    // the same partial sums in the same order, so run time agrees with constant evaluation bit for bit
+    constexpr auto expected = ::mcpprt::numeric::sum(lazy(::large) * 3.0f);
+    static float x[::large_size];
+    for (::std::size_t i{}; i < ::large_size; ++i) {
+        x[i] = ::large.value_[i];
+    }
+    ::buffer xs{x, ::large_size};
+    ::exception::assert_true(::mcpprt::numeric::sum(lazy(xs) * 3.0f) == expected);
+    ::exception::assert_true(::mcpprt::numeric::dot(xs, ::large) == ::mcpprt::numeric::dot(::large, ::large));
+}
+
+inline void runtime_test_overlap() noexcept {
+    // the destination is the source shifted by one element, each element sees the one written before it
+    static float x[::large_size + 1];
+    ::buffer head{x, ::large_size};
+    ::buffer tail{x + 1, ::large_size};
+    ::mcpprt::numeric::assign(tail, lazy(head) + 1.0f);
+    for (::std::size_t i{}; i <= ::large_size; ++i) {
+        ::exception::assert_true(x[i] == static_cast<float>(i));
+    }
+}
+
+int main() noexcept {
+    ::runtime_test_fused();
+    ::runtime_test_reduce();
+    ::runtime_test_overlap();
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include <cstddef>
+#include <utility>
+#include <exception/exception.hh>
+#include <mcpprt/io/file.hh>
+
+inline constexpr char const* path_sync = "mcpprt_test_file_sync.tmp";
+inline constexpr char const* path_ring_a = "mcpprt_test_file_ring_a.tmp";
+inline constexpr char const* path_ring_b = "mcpprt_test_file_ring_b.tmp";
+inline constexpr char const* path_withdraw = "mcpprt_test_file_withdraw.tmp";
+
+inline constexpr ::std::size_t big_size = 1000;
+
+[[nodiscard]]
+inline auto byte_at(::std::size_t i) noexcept -> unsigned char {
+    return static_cast<unsigned char>(i * 7 + 3);
+}
+
+template<::std::size_t BufferSize>
+inline void write_head(::mcpprt::io::writer<BufferSize>& out) noexcept {
+    for (::std::size_t i{}; i < 100; ++i) {
+        auto c = ::byte_at(i);
+        ::exception::assert_true(out.write(&c, 1).value() == 1);
+    }
+}
+
+template<::std::size_t BufferSize>
+inline void write_tail(::mcpprt::io::writer<BufferSize>& out) noexcept {
+    unsigned char big[::big_size];
+    for (::std::size_t i{}; i < ::big_size; ++i) {
+        big[i] = ::byte_at(100 + i);
+    }
+    unsigned char small[]{::byte_at(100 + ::big_size), ::byte_at(101 + ::big_size)};
+    ::mcpprt::io::iovec iov[]{{big, sizeof(big)}, {small, sizeof(small)}};
+    ::exception::assert_true(out.write_vectored(iov, 2).value() == sizeof(big) + sizeof(small));
+}
+
+template<::std::size_t BufferSize>
+inline void write_pattern(::mcpprt::io::writer<BufferSize>& out) noexcept {
+    ::write_head(out);
+    ::write_tail(out);
+}
+
+inline void check_pattern(char const* path) noexcept {
+    auto in = ::mcpprt::io::file::open(path, ::mcpprt::io::open_mode::read);
+    ::exception::assert_true(in.has_value());
+    ::mcpprt::io::reader<64> reader{::std::move(in).value()};
+
+    unsigned char data[2 * ::big_size]{};
+    auto size = reader.read_full(data, sizeof(data));
+    ::exception::assert_true(size.has_value() && size.value() == 102 + ::big_size);
+    for (::std::size_t i{}; i < size.value(); ++i) {
+        ::exception::assert_true(data[i] == ::byte_at(i));
+    }
+    ::exception::assert_true(reader.read(data, 1).value() == 0);
+}
+
+inline void runtime_test_open_error() noexcept {
+    auto f = ::mcpprt::io::file::open("mcpprt_test_no_such_dir/file", ::mcpprt::io::open_mode::read);
+    ::exception::assert_false(f.has_value());
+    ::exception::assert_true(f.error() == ::mcpprt::io::errc::no_entry);
+}
+
+inline void runtime_test_sync() noexcept {
+    {
+        auto f = ::mcpprt::io::file::open(::path_sync, ::mcpprt::io::open_mode::write);
+        ::exception::assert_true(f.has_value());
+        ::mcpprt::io::writer<256> out{::std::move(f).value()};
+        ::write_pattern(out);
+        ::exception::assert_true(out.flush().has_value());
+        ::exception::assert_true(out.buffered() == 0);
+    }
+    ::check_pattern(::path_sync);
+    ::exception::assert_true(::mcpprt::io::remove(::path_sync).has_value());
+}
+
+inline void runtime_test_ring() noexcept {
+    auto ring = ::mcpprt::io::ring::create(8);
+    if (!ring.has_value()) {
+        // io_uring is disabled or filtered here, the writers fall back to writev
+        return;
+    }
+    auto& r = ring.value();
+    {
+        auto a = ::mcpprt::io::file::open(::path_ring_a, ::mcpprt::io::open_mode::write);
+        auto b = ::mcpprt::io::file::open(::path_ring_b, ::mcpprt::io::open_mode::write);
+        ::exception::assert_true(a.has_value() && b.has_value());
+        ::mcpprt::io::writer<4096> out_a{::std::move(a).value(), &r};
+        ::mcpprt::io::writer<4096> out_b{::std::move(b).value(), &r};
+        ::write_pattern(out_a);
+        ::write_pattern(out_b);
+        auto total = ::mcpprt::io::flush_all(r, out_a, out_b);
+        ::exception::assert_true(total.has_value());
+        ::exception::assert_true(out_a.buffered() == 0 && out_b.buffered() == 0);
+    }
+    ::check_pattern(::path_ring_a);
+    ::check_pattern(::path_ring_b);
+    ::exception::assert_true(::mcpprt::io::remove(::path_ring_a).has_value());
+    ::exception::assert_true(::mcpprt::io::remove(::path_ring_b).has_value());
+}
+
+inline void runtime_test_withdraw() noexcept {
+    auto ring = ::mcpprt::io::ring::create(8);
+    if (!ring.has_value()) {
+        return;
+    }
+    auto& r = ring.value();
+    {
+        auto f = ::mcpprt::io::file::open(::path_withdraw, ::mcpprt::io::open_mode::write);
+        ::exception::assert_true(f.has_value());
+        ::mcpprt::io::writer<4096> out{::std::move(f).value(), &r};
+        ::write_head(out);
+        // as if the kernel had refused the submission
+        ::exception::assert_true(out.prepare_flush(r));
+        r.withdraw();
+        ::exception::assert_true(out.finish_flush().value() == 100);
+        // the withdrawn entry must not be submitted in place of the next one
+        ::write_tail(out);
+        ::exception::assert_true(out.flush().value() == ::big_size + 2);
+        ::exception::assert_true(out.buffered() == 0);
+    }
+    ::check_pattern(::path_withdraw);
+    ::exception::assert_true(::mcpprt::io::remove(::path_withdraw).has_value());
+}
+
+int main() noexcept {
+    ::runtime_test_open_error();
+    ::runtime_test_sync();
+    ::runtime_test_ring();
+    ::runtime_test_withdraw();
+
+    return 0;
+}
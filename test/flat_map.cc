@@ -0,0 +1,69 @@
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <exception/exception.hh>
+#include <mcpprt/container/flat_map.hh>
+
+consteval void test_constexpr() noexcept {
+    constexpr auto result = [] {
+        ::mcpprt::container::flat_map<int, int> map{{3, 30}, {1, 10}, {2, 20}, {1, 99}};
+        (void)map.insert_or_assign(4, 40);
+        (void)map.erase(2);
+        int sum{};
+        int previous{};
+        for (auto [key, value] : map) {
+            if (key <= previous) {
+                return -1;
+            }
+            previous = key;
+            sum += value;
+        }
+        return sum + static_cast<int>(map.size());
+    }();
+    static_assert(result == 10 + 30 + 40 + 3);
+}
+
+inline void runtime_test_lookup() noexcept {
+    ::mcpprt::container::flat_map<::std::uint64_t, int> map{};
+    for (int i{}; i < 1000; ++i) {
+        // insert in an order that hits the front, the back and the middle
+        auto key = static_cast<::std::uint64_t>((i * 7919) % 1000) * 2;
+        ::exception::assert_true(map.try_emplace(key, i).second);
+    }
+    ::exception::assert_true(map.size() == 1000);
+    for (::std::uint64_t key{}; key < 2000; ++key) {
+        auto found = map.get(key);
+        ::exception::assert_true(found.has_value() == (key % 2 == 0));
+        auto lower = map.lower_bound(key);
+        ::exception::assert_true(lower == map.end() || lower.key() == (key + 1) / 2 * 2);
+        auto upper = map.upper_bound(key);
+        ::exception::assert_true(upper == map.end() || upper.key() == key / 2 * 2 + 2);
+    }
+    ::exception::assert_true(map.end() - map.begin() == 1000);
+    ::exception::assert_true(map.begin()[10].first == 20);
+}
+
+inline void runtime_test_insert_sorted() noexcept {
+    ::mcpprt::container::flat_map<int, int> map{{1, 1}, {5, 5}, {9, 9}};
+    ::std::pair<int, int> const batch[]{{0, 0}, {1, 100}, {2, 2}, {6, 6}, {10, 10}, {11, 11}};
+    map.insert_sorted(batch, batch + 6);
+    ::exception::assert_true(map.size() == 8);
+    int const keys[]{0, 1, 2, 5, 6, 9, 10, 11};
+    ::std::size_t i{};
+    for (auto [key, value] : map) {
+        ::exception::assert_true(key == keys[i++]);
+        ::exception::assert_true(value == key);
+    }
+
+    auto copy = map;
+    ::exception::assert_true(copy.size() == 8 && copy.at(11) == 11);
+    (void)copy.erase(11);
+    ::exception::assert_true(map.contains(11) && !copy.contains(11));
+}
+
+int main() noexcept {
+    ::runtime_test_lookup();
+    ::runtime_test_insert_sorted();
+
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <exception/exception.hh>
+#include <mcpprt/container/array.hh>
+#include <mcpprt/container/static_vector.hh>
+#include <mcpprt/hash/hash.hh>
+#include <mcpprt/hash/xxh3.hh>
+
+namespace {
+
+inline constexpr ::std::size_t input_size = 2200;
+
+// the lengths around every switch of code path
+inline constexpr ::mcpprt::container::array<::std::size_t, 22> lengths{
+    {0, 1, 3, 4, 8, 9, 16, 17, 32, 33, 64, 65, 96, 97, 128, 129, 240, 241, 1024, 1025, 1088, 2177}};
+
+[[nodiscard]]
+consteval auto make_input() noexcept -> ::mcpprt::container::array<unsigned char, input_size> {
+    ::mcpprt::container::array<unsigned char, input_size> result{};
+    ::std::uint32_t state{1};
+    for (auto& byte : result.value_) {
+        state = state * 1103515245u + 12345u;
+        byte = static_cast<unsigned char>(state >> 16);
+    }
+    return result;
+}
+
+inline constexpr auto input = ::make_input();
+
+[[nodiscard]]
+consteval auto make_expected(::std::uint64_t seed) noexcept -> ::mcpprt::container::array<::std::uint64_t, 22> {
+    ::mcpprt::container::array<::std::uint64_t, 22> result{};
+    for (::std::size_t i{}; i < lengths.size(); ++i) {
+        result.value_[i] = ::mcpprt::hash::xxh3(input.value_, lengths.value_[i], seed);
+    }
+    return result;
+}
+
+// hashed in constant evaluation, so by the scalar path
+inline constexpr auto expected = ::make_expected(0);
+inline constexpr auto expected_seeded = ::make_expected(0x123456789ABCDEFu);
+
+[[nodiscard]]
+consteval auto make_pattern() noexcept -> ::mcpprt::container::array<unsigned char, 512> {
+    ::mcpprt::container::array<unsigned char, 512> result{};
+    for (::std::size_t i{}; i < 512; ++i) {
+        result.value_[i] = static_cast<unsigned char>(i);
+    }
+    return result;
+}
+
+inline constexpr auto pattern = ::make_pattern();
+
+enum class color : ::std::uint32_t {
+    red = 1234,
+};
+
+} // namespace
+
+consteval void test_reference() noexcept {
+    // values of the reference implementation
+    static_assert(::mcpprt::hash::xxh3("", 0) == 0x2D06800538D394C2u);
+    static_assert(::mcpprt::hash::xxh3("hello", 5) == 0x9555E8555C62DCFDu);
+    static_assert(::mcpprt::hash::xxh3("hello", 5, 42) == 0xBAFA072F07DB7937u);
+    static_assert(::mcpprt::hash::xxh3(::pattern.value_, 200, 7) == 0x68DECBFB306EBDF2u);
+    static_assert(::mcpprt::hash::xxh3(::pattern.value_, 512) == 0x1059105AD19BFA09u);
+
+    // wider elements hash their little-endian bytes
+    constexpr ::std::uint32_t word{1234};
+    static_assert(::mcpprt::hash::xxh3(&word, 1) == 0xB417034C229B5E35u || ::std::endian::native == ::std::endian::big);
+}
+
+consteval void test_hasher() noexcept {
+    static_assert(::mcpprt::hash::hasher<::std::uint32_t>{}(1234) == ::mcpprt::hash::hasher<::color>{}(::color::red));
+    static_assert(::mcpprt::hash::hasher<int>{}(1) != ::mcpprt::hash::hasher<int>{}(2));
+    static_assert(::mcpprt::hash::hasher<int>{}(1) != ::mcpprt::hash::hasher<int>{1}(1));
+    static_assert(::mcpprt::hash::hasher<double>{}(0.0) == ::mcpprt::hash::hasher<double>{}(-0.0));
+    static_assert(::mcpprt::hash::hasher<float>{}(1.0f) != ::mcpprt::hash::hasher<float>{}(-1.0f));
+
+    // containers of integers hash their bytes in one pass
+    static_assert(::mcpprt::hash::hasher<::mcpprt::container::static_vector<char, 6>>{3}("hello") ==
+                  ::mcpprt::hash::xxh3("hello", 5, 3));
+    static_assert(::mcpprt::hash::hasher<::mcpprt::container::array<unsigned char, 512>>{}(::pattern) ==
+                  ::mcpprt::hash::xxh3(::pattern.value_, 512));
+    static_assert(::mcpprt::hash::hasher<::std::string_view>{}("hello") == ::mcpprt::hash::xxh3("hello", 5));
+
+    // equal static_vectors hash the same, the last element is not compared
+    using triple = ::mcpprt::container::static_vector<int, 3>;
+    static_assert(triple{1, 2, 3} == triple{1, 2, 4});
+    static_assert(::mcpprt::hash::hasher<triple>{}(triple{1, 2, 3}) ==
+                  ::mcpprt::hash::hasher<triple>{}(triple{1, 2, 4}));
+
+    // other elements are combined in order
+    using pair = ::mcpprt::container::array<int, 2>;
+    using pairs = ::mcpprt::container::array<pair, 2>;
+    constexpr pairs ab{{pair{{1, 2}}, pair{{3, 4}}}};
+    constexpr pairs ba{{pair{{3, 4}}, pair{{1, 2}}}};
+    static_assert(::mcpprt::hash::is_hashable<pairs>);
+    static_assert(::mcpprt::hash::hasher<pairs>{}(ab) != ::mcpprt::hash::hasher<pairs>{}(ba));
+    static_assert(::mcpprt::hash::hasher<pairs>{}(ab) != ::mcpprt::hash::hasher<pairs>{1}(ab));
+
+    static_assert(!::mcpprt::hash::is_hashable<long double>);
+}
+
+inline void runtime_test_paths() noexcept {
+    // the SIMD path and the short paths at run time agree with constant evaluation
+    for (::std::size_t i{}; i < ::lengths.size(); ++i) {
+        auto length = ::lengths.value_[i];
+        ::exception::assert_true(::mcpprt::hash::xxh3(::input.value_, length) == ::expected.value_[i]);
+        ::exception::assert_true(::mcpprt::hash::xxh3(::input.value_, length, 0x123456789ABCDEFu) ==
+                                 ::expected_seeded.value_[i]);
+    }
+
+    // and do not read outside the input, whatever its alignment
+    static unsigned char buffer[::input_size + 1];
+    for (::std::size_t i{}; i < ::input_size; ++i) {
+        buffer[i + 1] = ::input.value_[i];
+    }
+    for (::std::size_t i{}; i < ::lengths.size(); ++i) {
+        ::exception::assert_true(::mcpprt::hash::xxh3(static_cast<void const*>(buffer + 1), ::lengths.value_[i]) ==
+                                 ::expected.value_[i]);
+    }
+}
+
+inline void runtime_test_distribution() noexcept {
+    // consecutive integers spread evenly over the low bits
+    constexpr ::std::size_t buckets = 1024;
+    static ::std::uint32_t count[buckets]{};
+    for (::std::uint32_t key{}; key < buckets * 64; ++key) {
+        ++count[::mcpprt::hash::hasher<::std::uint32_t>{}(key) % buckets];
+    }
+    for (auto i : count) {
+        ::exception::assert_true(i > 24 && i < 112);
+    }
+
+    // a flipped input bit flips about half of the output bits
+    ::std::size_t flipped{};
+    ::std::size_t trials{};
+    auto seed = ::mcpprt::hash::random_seed();
+    for (::std::uint64_t key{}; key < 256; ++key) {
+        auto value = key * 0x9E3779B97F4A7C15u;
+        auto hash = ::mcpprt::hash::hasher<::std::uint64_t>{seed}(value);
+        for (unsigned bit{}; bit < 64; ++bit) {
+            auto other = ::mcpprt::hash::hasher<::std::uint64_t>{seed}(value ^ (::std::uint64_t{1} << bit));
+            flipped += static_cast<::std::size_t>(::std::popcount(hash ^ other));
+            ++trials;
+        }
+    }
+    ::exception::assert_true(flipped > trials * 31 && flipped < trials * 33);
+}
+
+inline void runtime_test_pointer() noexcept {
+    int values[2]{};
+    ::mcpprt::hash::hasher<int*> hasher{::mcpprt::hash::random_seed()};
+    ::exception::assert_true(hasher(values) == hasher(values));
+    ::exception::assert_true(hasher(values) != hasher(values + 1));
+}
+
+int main() noexcept {
+    ::runtime_test_paths();
+    ::runtime_test_distribution();
+    ::runtime_test_pointer();
+
+    return 0;
+}
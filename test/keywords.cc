@@ -0,0 +1,96 @@
+#include <cstddef>
+#include <cstdint>
+#include <exception/exception.hh>
+#include <mcpprt/match/keywords.hh>
+
+namespace {
+
+using methods = ::mcpprt::match::keywords<"GET", "HEAD", "POST", "PUT", "DELETE", "OPTIONS", "PATCH">;
+using headers = ::mcpprt::match::keywords_icase<"host", "content-length", "content-type", "connection",
+                                                "transfer-encoding">;
+
+template<::std::size_t N>
+[[nodiscard]]
+constexpr auto match(auto matcher, char const (&text)[N]) noexcept {
+    return decltype(matcher)::match(text, text + N - 1);
+}
+
+template<::std::size_t N>
+[[nodiscard]]
+constexpr auto find(auto matcher, char const (&text)[N]) noexcept {
+    return decltype(matcher)::find(text, text + N - 1);
+}
+
+constexpr char ushers[] = "ushers";
+
+} // namespace
+
+consteval void test_match() noexcept {
+    static_assert(::match(methods{}, "GET").value() == 0);
+    static_assert(::match(methods{}, "PATCH").value() == 6);
+    static_assert(!::match(methods{}, "GE").has_value());
+    static_assert(!::match(methods{}, "GETS").has_value());
+    static_assert(!::match(methods{}, "get").has_value());
+    static_assert(!::match(methods{}, "").has_value());
+
+    static_assert(::match(headers{}, "Content-Length").value() == 1);
+    static_assert(::match(headers{}, "CONTENT-TYPE").value() == 2);
+    static_assert(::match(headers{}, "Connection").value() == 3);
+    static_assert(!::match(headers{}, "Content-Lengths").has_value());
+}
+
+consteval void test_find() noexcept {
+    using words = ::mcpprt::match::keywords<"he", "she", "his", "hers">;
+    // the classic example, "she" and "he" both end at the same byte and the longer one wins
+    constexpr auto found = ::find(words{}, ::ushers).value();
+    static_assert(found.index_ == 1 && found.first_ == ::ushers + 1 && found.last_ == ::ushers + 4);
+    static_assert(!::find(words{}, "xyz").has_value());
+    static_assert(::find(words{}, "ahis").value().index_ == 2);
+
+    // a keyword inside another, or a prefix of it, is reported as soon as it ends
+    using nested = ::mcpprt::match::keywords<"abcd", "bc">;
+    static_assert(::find(nested{}, "xabcd").value().index_ == 1);
+    using prefix = ::mcpprt::match::keywords<"abcd", "ab">;
+    static_assert(::find(prefix{}, "xabcd").value().index_ == 1);
+}
+
+inline void runtime_test_find() noexcept {
+    // long runs without any first byte go through the prefilter
+    static char text[4096]{};
+    for (auto& c : text) {
+        c = 'x';
+    }
+    constexpr char needle[] = "Transfer-Encoding";
+    for (::std::size_t at : {::std::size_t{0}, ::std::size_t{15}, ::std::size_t{16}, ::std::size_t{1000},
+                             sizeof(text) - sizeof(needle) + 1}) {
+        for (auto& c : text) {
+            c = 'x';
+        }
+        for (::std::size_t i{}; i + 1 < sizeof(needle); ++i) {
+            text[at + i] = needle[i];
+        }
+        auto found = headers::find(text, text + sizeof(text));
+        ::exception::assert_true(found.has_value());
+        ::exception::assert_true(found.value().index_ == 4 && found.value().first_ == text + at);
+        ::exception::assert_true(found.value().last_ == text + at + sizeof(needle) - 1);
+    }
+
+    // more than four first bytes go through the bitmap
+    using many = ::mcpprt::match::keywords<"alpha", "beta", "gamma", "delta", "epsilon">;
+    for (auto& c : text) {
+        c = 'x';
+    }
+    text[3000] = 'd';
+    text[3001] = 'e';
+    ::exception::assert_true(!many::contains(text, text + sizeof(text)));
+    text[3002] = 'l';
+    text[3003] = 't';
+    text[3004] = 'a';
+    ::exception::assert_true(many::find(text, text + sizeof(text)).value().first_ == text + 3000);
+}
+
+int main() noexcept {
+    ::runtime_test_find();
+
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <utility>
+#include <exception/exception.hh>
+#include <mcpprt/container/packed_int_vector.hh>
+#include "xorshift.hh"
+
+static_assert(::std::random_access_iterator<::mcpprt::container::packed_int_vector<>::const_iterator>);
+static_assert(::std::ranges::random_access_range<::mcpprt::container::packed_int_vector<::std::uint32_t>>);
+// an iterator is a position, it carries no unpacked block
+static_assert(sizeof(::mcpprt::container::packed_int_vector<>::const_iterator) == 2 * sizeof(void*));
+
+namespace {
+
+/**
+ * @brief random access, block decoding and iteration all give back `expected`
+ */
+template<typename T, typename Allocator>
+inline void check(::mcpprt::container::packed_int_vector<T, Allocator> const& vector, T const* expected,
+                  ::std::size_t count) noexcept {
+    ::exception::assert_true(vector.size() == count);
+    for (::std::size_t i{}; i < count; ++i) {
+        ::exception::assert_true(vector[i] == expected[i]);
+    }
+
+    T buffer[::mcpprt::container::packed_int_vector<T>::block_size];
+    ::std::size_t index{};
+    for (::std::size_t block{}; block < vector.block_count(); ++block) {
+        auto decoded = vector.decode_block(block, buffer);
+        for (::std::size_t i{}; i < decoded; ++i) {
+            ::exception::assert_true(buffer[i] == expected[index++]);
+        }
+    }
+    ::exception::assert_true(index == count);
+
+    index = 0;
+    for (auto value : vector) {
+        ::exception::assert_true(value == expected[index++]);
+    }
+    ::exception::assert_true(index == count);
+
+    index = 0;
+    vector.for_each([&](T value) noexcept { ::exception::assert_true(value == expected[index++]); });
+    ::exception::assert_true(index == count);
+}
+
+} // namespace
+
+inline void runtime_test_basic() noexcept {
+    ::mcpprt::container::packed_int_vector<::std::uint32_t> vector{};
+    ::exception::assert_true(vector.empty() && vector.begin() == vector.end() && vector.block_count() == 0);
+
+    for (::std::uint32_t i{}; i < 300; ++i) {
+        vector.push_back(i * 3);
+    }
+    ::exception::assert_true(vector.size() == 300 && vector.block_count() == 3);
+    ::exception::assert_true(vector.front() == 0 && vector.back() == 897 && vector.at(128) == 384);
+    ::exception::assert_true(vector.end() - vector.begin() == 300 && vector.begin()[200] == 600);
+    ::exception::assert_true(*(vector.end() - 1) == 897 && *(2 + vector.begin()) == 6);
+
+    auto copy = vector;
+    auto moved = ::std::move(vector);
+    ::exception::assert_true(copy.size() == 300 && moved.size() == 300 && copy[299] == moved[299]);
+    copy.clear();
+    ::exception::assert_true(copy.empty());
+    copy.shrink_to_fit();
+    copy.push_back(7);
+    ::exception::assert_true(copy.size() == 1 && copy[0] == 7);
+}
+
+/**
+ * @brief a sorted posting list is stored as small gaps
+ */
+inline void runtime_test_sorted() noexcept {
+    constexpr ::std::size_t count = 100000;
+    static ::std::uint64_t ids[count];
+    ::xorshift next{};
+    ::std::uint64_t id{1'000'000'000'000};
+    for (auto& i : ids) {
+        id += next() % 64;
+        i = id;
+    }
+
+    ::mcpprt::container::packed_int_vector<> vector{};
+    vector.append(ids, count);
+    ::check(vector, ids, count);
+    // 6 bits a value instead of 64
+    ::exception::assert_true(vector.compressed_bytes() * 8 < count * sizeof(::std::uint64_t));
+}
+
+/**
+ * @brief a column of values in a small range is stored as offsets from each block minimum
+ */
+inline void runtime_test_column() noexcept {
+    constexpr ::std::size_t count = 50000;
+    static ::std::uint32_t values[count];
+    ::xorshift next{};
+    for (auto& value : values) {
+        value = 3'000'000'000u + static_cast<::std::uint32_t>(next() % 200);
+    }
+
+    ::mcpprt::container::packed_int_vector<::std::uint32_t> vector{};
+    for (auto value : values) {
+        vector.push_back(value);
+    }
+    ::check(vector, values, count);
+    // 8 bits a value instead of 32
+    ::exception::assert_true(vector.compressed_bytes() * 3 < count * sizeof(::std::uint32_t));
+}
+
+/**
+ * @brief every width, including values that straddle two words
+ */
+inline void runtime_test_widths() noexcept {
+    constexpr ::std::size_t count = 128 * 65 + 77;
+    static ::std::uint64_t values[count];
+    ::xorshift next{};
+    for (::std::size_t block{}; block < 65; ++block) {
+        auto mask = block == 64 ? ~::std::uint64_t{} : (::std::uint64_t{1} << block) - 1;
+        auto base = next();
+        for (::std::size_t i{}; i < 128; ++i) {
+            values[block * 128 + i] = base + (next() & mask);
+        }
+        // the full range of the width is used
+        values[block * 128] = base;
+        values[block * 128 + 127] = base + mask;
+    }
+    for (::std::size_t i{128 * 65}; i < count; ++i) {
+        values[i] = next();
+    }
+
+    ::mcpprt::container::packed_int_vector<> vector{};
+    vector.append(values, count);
+    ::check(vector, values, count);
+
+    static ::std::uint32_t narrow[count];
+    for (::std::size_t i{}; i < count; ++i) {
+        narrow[i] = static_cast<::std::uint32_t>(values[i] >> (i / 128 % 33));
+    }
+    ::mcpprt::container::packed_int_vector<::std::uint32_t> narrow_vector{};
+    narrow_vector.append(narrow, count);
+    ::check(narrow_vector, narrow, count);
+
+    static ::std::uint16_t small[count];
+    for (::std::size_t i{}; i < count; ++i) {
+        small[i] = static_cast<::std::uint16_t>(values[i]);
+    }
+    ::mcpprt::container::packed_int_vector<::std::uint16_t> small_vector{};
+    small_vector.append(small, count);
+    ::check(small_vector, small, count);
+}
+
+int main() noexcept {
+    ::runtime_test_basic();
+    ::runtime_test_sorted();
+    ::runtime_test_column();
+    ::runtime_test_widths();
+
+    return 0;
+}
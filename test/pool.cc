@@ -0,0 +1,54 @@
+#include <cstddef>
+#include <cstdint>
+#include <exception/exception.hh>
+#include <mcpprt/memory/pool.hh>
+
+consteval void test_constexpr_allocator() noexcept {
+    constexpr auto result = [] {
+        ::mcpprt::memory::pool_allocator<int> alloc{};
+        auto* ptr = alloc.allocate(4);
+        ptr[3] = 42;
+        auto value = ptr[3];
+        alloc.deallocate(ptr, 4);
+        return value;
+    }();
+    static_assert(result == 42);
+}
+
+inline void runtime_test_reuse() noexcept {
+    auto* a = ::mcpprt::memory::pool_allocate(100);
+    ::exception::assert_true(reinterpret_cast<::std::uintptr_t>(a) % ::mcpprt::memory::pool_alignment == 0);
+    ::mcpprt::memory::pool_deallocate(a, 100);
+    // same size class
+    auto* b = ::mcpprt::memory::pool_allocate(128);
+    ::exception::assert_true(a == b);
+    auto* c = ::mcpprt::memory::pool_allocate(128);
+    ::exception::assert_true(b != c);
+    ::mcpprt::memory::pool_deallocate(c, 128);
+    ::mcpprt::memory::pool_deallocate(b, 128);
+}
+
+inline void runtime_test_large() noexcept {
+    auto* ptr = static_cast<unsigned char*>(::mcpprt::memory::pool_allocate(::mcpprt::memory::pool_block_max + 1));
+    ptr[::mcpprt::memory::pool_block_max] = 1;
+    ::mcpprt::memory::pool_deallocate(ptr, ::mcpprt::memory::pool_block_max + 1);
+}
+
+inline void runtime_test_allocator() noexcept {
+    ::mcpprt::memory::pool_allocator<::std::uint64_t> alloc{};
+    ::mcpprt::memory::pool_allocator<char> other{alloc};
+    ::exception::assert_true(alloc == other);
+    auto* ptr = alloc.allocate(1000);
+    for (::std::size_t i{}; i < 1000; ++i) {
+        ptr[i] = i;
+    }
+    alloc.deallocate(ptr, 1000);
+}
+
+int main() noexcept {
+    ::runtime_test_reuse();
+    ::runtime_test_large();
+    ::runtime_test_allocator();
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <cstddef>
+#include <exception/exception.hh>
+#include <mcpprt/match/regex.hh>
+
+namespace {
+
+template<::mcpprt::container::static_vector Pattern, ::std::size_t N>
+[[nodiscard]]
+constexpr bool match(char const (&text)[N]) noexcept {
+    return ::mcpprt::match::regex<Pattern>::match(text, text + N - 1);
+}
+
+template<::mcpprt::container::static_vector Pattern, ::std::size_t N>
+[[nodiscard]]
+constexpr auto prefix(char const (&text)[N]) noexcept -> ::std::ptrdiff_t {
+    auto end = ::mcpprt::match::regex<Pattern>::prefix(text, text + N - 1);
+    return end.has_value() ? end.value() - text : -1;
+}
+
+template<::mcpprt::container::static_vector Pattern, ::std::size_t N>
+[[nodiscard]]
+constexpr bool contains(char const (&text)[N]) noexcept {
+    return ::mcpprt::match::regex<Pattern>::contains(text, text + N - 1);
+}
+
+} // namespace
+
+consteval void test_match() noexcept {
+    static_assert(::match<"abc">("abc"));
+    static_assert(!::match<"abc">("ab"));
+    static_assert(!::match<"abc">("abcd"));
+    static_assert(::match<"">(""));
+    static_assert(::match<"a*">(""));
+    static_assert(::match<"a*">("aaaa"));
+    static_assert(!::match<"a+">(""));
+    static_assert(::match<"colou?r">("color"));
+    static_assert(::match<"colou?r">("colour"));
+    static_assert(::match<"(ab|cd)+">("abcdab"));
+    static_assert(!::match<"(ab|cd)+">("abc"));
+    static_assert(::match<"a.c">("a\nc"));
+    static_assert(::match<"[a-c]+[^a-c]">("abcz"));
+    static_assert(!::match<"[a-c]+[^a-c]">("abca"));
+    static_assert(::match<"[]a]+">("]a]"));
+    static_assert(::match<"[a-]+">("a-a"));
+    static_assert(::match<"\\d+\\.\\d*">("3.14"));
+    static_assert(::match<"\\w+\\s\\W">("foo_1 !"));
+    static_assert(::match<"(a*)*b">("aaab"));
+    static_assert(::match<"x|">(""));
+}
+
+consteval void test_search() noexcept {
+    static_assert(::prefix<"[A-Za-z-]+:">("Content-Length: 12") == 15);
+    static_assert(::prefix<"[A-Za-z-]+:">(": 12") == -1);
+    // the longest match wins
+    static_assert(::prefix<"a|ab|abc">("abcd") == 3);
+    static_assert(::prefix<"a*">("bbb") == 0);
+
+    static_assert(::contains<"\\d\\d\\d">("HTTP/1.1 200 OK"));
+    static_assert(!::contains<"\\d\\d\\d">("HTTP/1.1 OK"));
+    static_assert(::contains<"chunked">("gzip, chunked"));
+}
+
+inline void runtime_test_contains() noexcept {
+    // long runs that never leave the start state go through the prefilter
+    static char text[4096]{};
+    for (auto& c : text) {
+        c = 'x';
+    }
+    using version = ::mcpprt::match::regex<"HTTP/\\d\\.\\d">;
+    ::exception::assert_true(!version::contains(text, text + sizeof(text)));
+    text[4000] = 'H';
+    ::exception::assert_true(!version::contains(text, text + sizeof(text)));
+    char const line[] = "HTTP/1.1";
+    for (::std::size_t i{}; i + 1 < sizeof(line); ++i) {
+        text[4000 + i] = line[i];
+    }
+    ::exception::assert_true(version::contains(text, text + sizeof(text)));
+    ::exception::assert_true(!version::contains(text, text + 4007));
+}
+
+int main() noexcept {
+    ::runtime_test_contains();
+
+    return 0;
+}
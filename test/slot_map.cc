@@ -0,0 +1,127 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <exception/exception.hh>
+#include <mcpprt/container/slot_map.hh>
+#include "xorshift.hh"
+
+consteval void test_constexpr() noexcept {
+    constexpr auto dynamic = [] {
+        ::mcpprt::container::slot_map<int> map{};
+        auto a = map.insert(1);
+        auto b = map.insert(2);
+        auto c = map.insert(3);
+        (void)map.erase(a);
+        auto d = map.insert(4);
+        int sum{};
+        for (auto value : map) {
+            sum += value;
+        }
+        // `d` reuses the slot of `a` with a newer generation
+        return sum == 9 && !map.contains(a) && d.index_ == a.index_ && map.at(b) == 2 && map.at(c) == 3;
+    }();
+    static_assert(dynamic);
+
+    constexpr auto fixed = [] {
+        ::mcpprt::container::static_slot_map<int, 2> map{};
+        auto a = map.insert(1).value();
+        auto b = map.insert(2).value();
+        bool full = !map.insert(3).has_value();
+        (void)map.erase(a);
+        return full && map.size() == 1 && *map.get(b).value() == 2 && !map.get(a).has_value();
+    }();
+    static_assert(fixed);
+}
+
+inline void runtime_test_stale_handle() noexcept {
+    ::mcpprt::container::slot_map<int> map{};
+    ::exception::assert_true(!map.contains(::mcpprt::container::slot_handle{}));
+
+    auto a = map.insert(10);
+    auto b = map.insert(20);
+    ::exception::assert_true(map.erase(a));
+    ::exception::assert_true(!map.erase(a));
+    ::exception::assert_true(!map.get(a).has_value());
+    ::exception::assert_true(map.at(b) == 20);
+
+    auto c = map.insert(30);
+    ::exception::assert_true(c.index_ == a.index_ && c != a);
+    ::exception::assert_true(!map.get(a).has_value());
+    ::exception::assert_true(*map.get(c).value() == 30);
+
+    map.clear();
+    ::exception::assert_true(map.empty() && !map.contains(b) && !map.contains(c));
+}
+
+/**
+ * @brief churn through a fixed set of live handles and compare with the values they were given
+ */
+inline void runtime_test_churn() noexcept {
+    constexpr ::std::size_t live = 512;
+    ::mcpprt::container::slot_map<::std::uint64_t> map{};
+    static ::mcpprt::container::slot_handle handles[live]{};
+    static ::std::uint64_t expected[live]{};
+    static ::mcpprt::container::slot_handle stale[live]{};
+
+    ::xorshift next{};
+
+    ::std::size_t size{};
+    for (int round{}; round < 200000; ++round) {
+        auto i = static_cast<::std::size_t>(next() % live);
+        if (map.contains(handles[i])) {
+            ::exception::assert_true(map.at(handles[i]) == expected[i]);
+            ::exception::assert_true(map.erase(handles[i]));
+            stale[i] = handles[i];
+            --size;
+        } else {
+            expected[i] = next();
+            handles[i] = map.insert(expected[i]);
+            ++size;
+        }
+        ::exception::assert_true(!map.contains(stale[i]));
+        ::exception::assert_true(map.size() == size);
+    }
+
+    // every dense position maps back to a live handle
+    for (::std::size_t i{}; i < map.size(); ++i) {
+        auto handle = map.handle_at(i);
+        ::exception::assert_true(map.get(handle).value() == map.begin() + i);
+    }
+
+    auto copy = map;
+    for (::std::size_t i{}; i < live; ++i) {
+        ::exception::assert_true(copy.contains(handles[i]) == map.contains(handles[i]));
+        if (map.contains(handles[i])) {
+            ::exception::assert_true(copy.at(handles[i]) == expected[i]);
+        }
+    }
+    auto moved = ::std::move(copy);
+    ::exception::assert_true(copy.empty() && moved.size() == map.size());
+}
+
+inline void runtime_test_static() noexcept {
+    ::mcpprt::container::static_slot_map<::std::unique_ptr<int>, 4> map{};
+    ::mcpprt::container::slot_handle handles[4]{};
+    for (int i{}; i < 4; ++i) {
+        handles[i] = map.insert(::std::make_unique<int>(i)).value();
+    }
+    ::exception::assert_true(map.full() && !map.emplace().has_value());
+    ::exception::assert_true(map.erase(handles[1]));
+    ::exception::assert_true(**map.get(handles[3]).value() == 3);
+    auto reused = map.emplace(::std::make_unique<int>(5)).value();
+    ::exception::assert_true(reused.index_ == handles[1].index_ && !map.contains(handles[1]));
+    int sum{};
+    for (auto const& value : map) {
+        sum += *value;
+    }
+    ::exception::assert_true(sum == 0 + 2 + 3 + 5);
+}
+
+int main() noexcept {
+    ::runtime_test_stale_handle();
+    ::runtime_test_churn();
+    ::runtime_test_static();
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <cstddef>
+#include <utility>
+#include <exception/exception.hh>
+#include <mcpprt/coroutine/task.hh>
+
+enum class error_code {
+    negative,
+};
+
+using result = ::exception::expected<int, error_code>;
+
+struct owned {
+    int value_;
+
+    constexpr explicit owned(int value) noexcept : value_{value} {
+    }
+
+    owned(owned const&) = delete;
+    constexpr owned(owned&&) noexcept = default;
+    auto operator=(owned const&) -> owned& = delete;
+    constexpr auto operator=(owned&&) noexcept -> owned& = default;
+};
+
+using owned_result = ::exception::expected<::owned, error_code>;
+
+inline auto leaf(int value) -> ::mcpprt::coroutine::task<::result> {
+    if (value < 0) {
+        co_return ::exception::unexpected<error_code>{error_code::negative};
+    }
+    co_return value * 2;
+}
+
+inline auto middle(int value) -> ::mcpprt::coroutine::task<::result> {
+    auto r = co_await ::leaf(value);
+    if (!r.has_value()) {
+        co_return r;
+    }
+    co_return r.value() + 1;
+}
+
+inline auto propagating(int value, bool& reached) -> ::mcpprt::coroutine::task<::result> {
+    int x = co_await ::mcpprt::coroutine::propagate(co_await ::leaf(value));
+    reached = true;
+    co_return x + 1;
+}
+
+inline auto make_owned(int value) -> ::mcpprt::coroutine::task<::owned_result> {
+    if (value < 0) {
+        co_return ::exception::unexpected<error_code>{error_code::negative};
+    }
+    co_return ::owned{value};
+}
+
+inline auto propagating_owned(int value) -> ::mcpprt::coroutine::task<::result> {
+    // a move-only value is moved out of the awaited expected
+    ::owned x = co_await ::mcpprt::coroutine::propagate(co_await ::make_owned(value));
+    co_return x.value_ + 1;
+}
+
+inline auto chain(int depth) -> ::mcpprt::coroutine::task<::result> {
+    if (depth == 0) {
+        co_return 0;
+    }
+    auto r = co_await ::chain(depth - 1);
+    co_return r.value() + 1;
+}
+
+inline void runtime_test_value() noexcept {
+    auto r = ::mcpprt::coroutine::sync_wait(::middle(20));
+    ::exception::assert_true(r.has_value() && r.value() == 41);
+}
+
+inline void runtime_test_error() noexcept {
+    auto r = ::mcpprt::coroutine::sync_wait(::middle(-1));
+    ::exception::assert_false(r.has_value());
+    ::exception::assert_true(r.error() == error_code::negative);
+}
+
+inline void runtime_test_propagate() noexcept {
+    bool reached{};
+    auto ok = ::mcpprt::coroutine::sync_wait(::propagating(1, reached));
+    ::exception::assert_true(reached && ok.value() == 3);
+
+    reached = false;
+    auto fail = ::mcpprt::coroutine::sync_wait(::propagating(-1, reached));
+    ::exception::assert_false(reached);
+    ::exception::assert_true(fail.error() == error_code::negative);
+
+    ::exception::assert_true(::mcpprt::coroutine::sync_wait(::propagating_owned(4)).value() == 5);
+    ::exception::assert_false(::mcpprt::coroutine::sync_wait(::propagating_owned(-4)).has_value());
+}
+
+inline void runtime_test_lazy() noexcept {
+    auto t = ::leaf(3);
+    ::exception::assert_false(t.done());
+    t.resume();
+    ::exception::assert_true(t.done());
+    ::exception::assert_true(::std::move(t).result().value() == 6);
+}
+
+inline void runtime_test_chain() noexcept {
+    auto r = ::mcpprt::coroutine::sync_wait(::chain(1000));
+    ::exception::assert_true(r.value() == 1000);
+}
+
+int main() noexcept {
+    ::runtime_test_value();
+    ::runtime_test_error();
+    ::runtime_test_propagate();
+    ::runtime_test_lazy();
+    ::runtime_test_chain();
+
+    return 0;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+/**
+ * @file xorshift.hh
+ * @brief deterministic pseudo-random numbers for the randomized tests
+ */
+
+#include <cstdint>
+
+struct xorshift {
+    ::std::uint64_t state_{0x2545F4914F6CDD1D};
+
+    auto operator()(this xorshift& self) noexcept -> ::std::uint64_t {
+        self.state_ ^= self.state_ << 13;
+        self.state_ ^= self.state_ >> 7;
+        self.state_ ^= self.state_ << 17;
+        return self.state_;
+    }
+};